@@ -1,42 +1,45 @@
-#include "ast/ast.h"
+#include "semantic.h"
 #include <stack>
-#include <set>
+#include <map>
 #include <string>
 #include <cstdio>
 
 using namespace std;
 
-extern "C" {
-    int check_semantics(astNode *root);
-}
-
 class SemanticChecker {
 private:
-    stack<set<string>> scopes;
+    stack<map<string, astNode*>> scopes;  // name -> the node that declares it
+    declaration_map *declarations;        // filled in when not NULL
     bool has_error;
     
     void enter_scope() {
-        scopes.push(set<string>());
+        scopes.push(map<string, astNode*>());
     }
     
     void exit_scope() {
         scopes.pop();
     }
     
-    bool declare(const char *name) {
+    bool declare(const char *name, astNode *decl) {
         if (scopes.top().find(name) != scopes.top().end()) {
             fprintf(stderr, "semantic error: duplicate declaration of '%s'\n", name);
             has_error = true;
             return false;
         }
-        scopes.top().insert(name);
+        scopes.top()[name] = decl;
         return true;
     }
     
-    bool check_declared(const char *name) {
-        stack<set<string>> temp = scopes;
+    // var is an ast_var node; records the declaration it refers to
+    bool check_declared(astNode *var) {
+        const char *name = var->var.name;
+        stack<map<string, astNode*>> temp = scopes;
         while (!temp.empty()) {
-            if (temp.top().find(name) != temp.top().end()) {
+            auto it = temp.top().find(name);
+            if (it != temp.top().end()) {
+                if (declarations != NULL) {
+                    (*declarations)[var] = it->second;
+                }
                 return true;
             }
             temp.pop();
@@ -54,7 +57,7 @@ private:
         enter_scope();
         
         if (node->func.param != NULL) {
-            declare(node->func.param->var.name);
+            declare(node->func.param->var.name, node->func.param);
         }
         
         // visit function body - pass flag to indicate it's the top-level function block
@@ -107,11 +110,11 @@ private:
                 break;
                 
             case ast_decl:
-                declare(node->stmt.decl.name);
+                declare(node->stmt.decl.name, node);
                 break;
                 
             case ast_asgn:
-                check_declared(node->stmt.asgn.lhs->var.name);
+                check_declared(node->stmt.asgn.lhs);
                 visit_expr(node->stmt.asgn.rhs);
                 break;
         }
@@ -122,7 +125,7 @@ private:
         
         switch (node->type) {
             case ast_var:
-                check_declared(node->var.name);
+                check_declared(node);
                 break;
                 
             case ast_cnst:
@@ -173,7 +176,8 @@ private:
     }
     
 public:
-    int check(astNode *root) {
+    int check(astNode *root, declaration_map *decls = NULL) {
+        declarations = decls;
         has_error = false;
         visit_node(root);
         return has_error ? 1 : 0;
@@ -183,4 +187,9 @@ public:
 int check_semantics(astNode *root) {
     SemanticChecker checker;
     return checker.check(root);
+}
+
+int resolve_declarations(astNode *root, declaration_map *declarations) {
+    SemanticChecker checker;
+    return checker.check(root, declarations);
 }
\ No newline at end of file
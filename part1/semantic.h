@@ -0,0 +1,20 @@
+#ifndef SEMANTIC_H
+#define SEMANTIC_H
+
+#include "ast/ast.h"
+#include <unordered_map>
+
+extern "C" {
+    int check_semantics(astNode *root);
+}
+
+// for every variable reference (an ast_var node, assignment targets
+// included), the node that declares it: an ast_decl statement, or the
+// function's parameter (its ast_var node). two declarations of the same
+// name in different scopes are different keys
+typedef unordered_map<astNode*, astNode*> declaration_map;
+
+// check_semantics, also filling in declarations; 0 if the program is fine
+int resolve_declarations(astNode *root, declaration_map *declarations);
+
+#endif
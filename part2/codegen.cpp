@@ -0,0 +1,69 @@
+#include "codegen.h"
+#include <llvm-c/Target.h>
+#include <llvm-c/TargetMachine.h>
+#include <stdio.h>
+
+// ============================================================================
+// NATIVE CODE
+// ============================================================================
+// the last step of the in-memory pipeline: the optimized module goes to
+// LLVM's code generator for the host target, which writes the object file
+// itself. the module gets the host's triple and data layout here, after
+// the part3 passes (which don't need them), so the IR printed without -o
+// stays target independent
+//
+// objects are position independent, so they link into the default PIE
+// executables of the system compiler
+
+LLVMTargetMachineRef host_target_machine(bool optimize) {
+    LLVMInitializeNativeTarget();
+    LLVMInitializeNativeAsmPrinter();
+
+    char *triple = LLVMGetDefaultTargetTriple();
+    char *error_msg = NULL;
+    LLVMTargetRef target;
+    if (LLVMGetTargetFromTriple(triple, &target, &error_msg)) {
+        fprintf(stderr, "error: no target for %s: %s\n", triple, error_msg);
+        LLVMDisposeMessage(error_msg);
+        LLVMDisposeMessage(triple);
+        return NULL;
+    }
+
+    char *cpu = LLVMGetHostCPUName();
+    char *features = LLVMGetHostCPUFeatures();
+    LLVMTargetMachineRef machine = LLVMCreateTargetMachine(
+        target, triple, cpu, features,
+        optimize ? LLVMCodeGenLevelDefault : LLVMCodeGenLevelNone,
+        LLVMRelocPIC, LLVMCodeModelDefault);
+    LLVMDisposeMessage(features);
+    LLVMDisposeMessage(cpu);
+    LLVMDisposeMessage(triple);
+    return machine;
+}
+
+bool emit_native(LLVMModuleRef module, const char *path, bool assembly, bool optimize) {
+    LLVMTargetMachineRef machine = host_target_machine(optimize);
+    if (machine == NULL) {
+        return false;
+    }
+
+    char *triple = LLVMGetTargetMachineTriple(machine);
+    LLVMSetTarget(module, triple);
+    LLVMDisposeMessage(triple);
+    LLVMTargetDataRef layout = LLVMCreateTargetDataLayout(machine);
+    LLVMSetModuleDataLayout(module, layout);
+
+    bool ok = true;
+    char *error_msg = NULL;
+    if (LLVMTargetMachineEmitToFile(machine, module, (char *)path,
+                                    assembly ? LLVMAssemblyFile : LLVMObjectFile,
+                                    &error_msg)) {
+        fprintf(stderr, "error writing '%s': %s\n", path, error_msg);
+        LLVMDisposeMessage(error_msg);
+        ok = false;
+    }
+
+    LLVMDisposeTargetData(layout);
+    LLVMDisposeTargetMachine(machine);
+    return ok;
+}
@@ -0,0 +1,21 @@
+#ifndef CODEGEN_H
+#define CODEGEN_H
+
+#include <llvm-c/Core.h>
+#include <llvm-c/TargetMachine.h>
+
+// ============================================================================
+// NATIVE CODE (codegen.cpp)
+// ============================================================================
+
+// compile the module for the host with LLVM's code generator and write an
+// object file (assembly if assembly is set) straight to path. optimize
+// picks LLVM's default codegen level instead of none; false on an error
+bool emit_native(LLVMModuleRef module, const char *path, bool assembly, bool optimize);
+
+// the target machine emit_native and the JIT compile with: the host's CPU
+// and features, position independent code. NULL (and a message) if LLVM
+// has no target for the host
+LLVMTargetMachineRef host_target_machine(bool optimize);
+
+#endif
@@ -0,0 +1,271 @@
+#include "ir_builder.h"
+#include "codegen.h"
+#include "jit.h"
+#include "backend.h"
+#include "optimizer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+extern int yyparse();
+extern FILE *yyin;
+extern int yylex_destroy();
+extern astNode *ast_root;
+
+static void print_usage(const char *program) {
+    fprintf(stderr, "usage: %s [options] <input.c> [more.c ... with --jit]\n", program);
+    fprintf(stderr, "example: %s ../part1/parser_tests/p1.c\n", program);
+    fprintf(stderr, "options:\n");
+    fprintf(stderr, "  %-22s %s\n", "-o <file>", "write a native object file for the host, not IR");
+    fprintf(stderr, "  %-22s %s\n", "-S", "with -o, write assembly instead of an object");
+    fprintf(stderr, "  %-22s %s\n", "--jit <n>",
+            "compile in this process with LLVM's ORC JIT and print func(n), not IR;");
+    fprintf(stderr, "  %-22s %s\n", "",
+            "more programs are loaded as func.1, ..., each compiled when first called");
+    fprintf(stderr, "  %-22s %s\n", "--backend <llvm|fast>",
+            "code generator for -o: LLVM's (default) or part4's");
+    fprintf(stderr, "  %-22s %s\n", "-O0", "run no passes (and no LLVM codegen optimization)");
+    fprintf(stderr, "  %-22s %s\n", "--time", "report how long each phase took (stderr)");
+    fprintf(stderr, "  %-22s %s\n", "--peephole-stats",
+            "with --backend fast, report how often each peephole pattern fired (stderr)");
+    fprintf(stderr, "  %-22s %s\n", "--allocas",
+            "variables as allocas with loads and stores (clang -O0), not SSA;");
+    fprintf(stderr, "  %-22s %s\n", "",
+            "implied by --indvars and --unroll, which only find alloca loop counters");
+    print_pipeline_options();
+}
+
+// ============================================================================
+// PHASE TIMES (--time)
+// ============================================================================
+
+static vector<pair<const char *, double>> phase_ms;
+static chrono::steady_clock::time_point phase_start = chrono::steady_clock::now();
+
+// the phase that just finished, timed from the end of the one before and
+// added to its earlier runs (one per input file)
+static void end_phase(const char *name) {
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+    double ms = chrono::duration<double, milli>(now - phase_start).count();
+    phase_start = now;
+    for (auto &phase : phase_ms) {
+        if (strcmp(phase.first, name) == 0) {
+            phase.second += ms;
+            return;
+        }
+    }
+    phase_ms.push_back(make_pair(name, ms));
+}
+
+static void print_phase_times() {
+    double total = 0;
+    fprintf(stderr, "phase times (ms):");
+    for (auto &phase : phase_ms) {
+        fprintf(stderr, " %s %.3f,", phase.first, phase.second);
+        total += phase.second;
+    }
+    fprintf(stderr, " total %.3f\n", total);
+}
+
+// the file name without its directories, used as the module name
+static const char *base_name(const char *path) {
+    const char *slash = strrchr(path, '/');
+    return slash != NULL ? slash + 1 : path;
+}
+
+// STEP 1: parse and check the miniC program (part1), STEP 2: build the
+// LLVM module from the AST, in SSA form unless --allocas. NULL (and a
+// message) if the program is not one
+static LLVMModuleRef read_program(const char *input_file, variable_mode mode) {
+    yyin = fopen(input_file, "r");
+    if (!yyin) {
+        fprintf(stderr, "cannot open file: %s\n", input_file);
+        return NULL;
+    }
+
+    if (yyparse() != 0) {
+        fprintf(stderr, "parse failed\n");
+        fclose(yyin);
+        return NULL;
+    }
+    fclose(yyin);
+    yylex_destroy();
+    end_phase("parse");
+
+    declaration_map declarations;
+    if (resolve_declarations(ast_root, &declarations) != 0) {
+        fprintf(stderr, "semantic check failed\n");
+        freeNode(ast_root);
+        return NULL;
+    }
+    end_phase("check");
+
+    LLVMModuleRef module = build_module(ast_root, base_name(input_file), declarations, mode);
+    freeNode(ast_root);
+    end_phase("irgen");
+    return module;
+}
+
+int main(int argc, char **argv) {
+    // check command line arguments
+    vector<const char *> input_files;
+    const char *output_file = NULL;
+    bool assembly = false;
+    bool fast_backend = false;
+    bool optimize = true;
+    bool timing = false;
+    bool peephole_stats = false;
+    bool jit = false;
+    int jit_argument = 0;
+    variable_mode mode = variables_in_ssa;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output_file = argv[++i];
+            continue;
+        }
+        if (strcmp(argv[i], "-S") == 0) {
+            assembly = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--jit") == 0 && i + 1 < argc) {
+            jit = true;
+            jit_argument = atoi(argv[++i]);
+            continue;
+        }
+        if (strcmp(argv[i], "--backend") == 0 && i + 1 < argc) {
+            const char *backend = argv[++i];
+            if (strcmp(backend, "fast") != 0 && strcmp(backend, "llvm") != 0) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            fast_backend = strcmp(backend, "fast") == 0;
+            continue;
+        }
+        if (strcmp(argv[i], "--time") == 0) {
+            timing = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--peephole-stats") == 0) {
+            peephole_stats = true;
+            continue;
+        }
+        if (strcmp(argv[i], "-O0") == 0) {
+            optimize = false;
+            continue;
+        }
+        if (strcmp(argv[i], "--allocas") == 0) {
+            mode = variables_in_allocas;
+            continue;
+        }
+        if (parse_pipeline_option(argc, argv, &i)) {
+            continue;
+        }
+        if (argv[i][0] == '-') {
+            print_usage(argv[0]);
+            return 1;
+        }
+        input_files.push_back(argv[i]);
+    }
+
+    // the loop passes look for counters in allocas, SSA would hide every loop
+    if (optimize && pipeline_needs_allocas()) {
+        mode = variables_in_allocas;
+    }
+
+    if (input_files.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (input_files.size() > 1 && !jit) {
+        fprintf(stderr, "only --jit takes more than one input file\n");
+        return 1;
+    }
+    if (fast_backend && output_file == NULL) {
+        fprintf(stderr, "--backend fast needs an output file (-o <file>)\n");
+        return 1;
+    }
+    if (jit && output_file != NULL) {
+        fprintf(stderr, "--jit runs the program, it can't also write -o <file>\n");
+        return 1;
+    }
+
+    // ========================================================================
+    // STEPS 1 AND 2: the module of each miniC program (read_program)
+    // ========================================================================
+
+    vector<LLVMModuleRef> modules;
+    for (const char *input_file : input_files) {
+        LLVMModuleRef module = read_program(input_file, mode);
+        if (module == NULL) {
+            for (LLVMModuleRef built : modules) {
+                LLVMDisposeModule(built);
+            }
+            return 1;
+        }
+        modules.push_back(module);
+    }
+
+    // ========================================================================
+    // STEP 3: run the part3 passes on it, in memory (with --jit, the JIT
+    // runs them on each program when it is first called)
+    // ========================================================================
+
+    LLVMModuleRef module = modules[0];
+    if (!jit) {
+        if (optimize && !optimize_module(module)) {
+            LLVMDisposeModule(module);
+            return 1;
+        }
+        end_phase("optimize");
+    }
+
+    // ========================================================================
+    // STEP 4: func(n) run in process with --jit, the object file with -o,
+    // the IR on stdout otherwise
+    // ========================================================================
+
+    bool ok = true;
+    if (jit) {
+        jit_session *session = jit_compile(modules, optimize);
+        module = NULL;      // the session's now, and the others
+        end_phase("jit");
+        ok = session != NULL;
+        if (ok) {
+            // what parser_tests/main.c prints
+            printf("Returned value: %d\n", jit_call(session, jit_argument));
+            fflush(stdout);
+            end_phase("run");
+            jit_dispose(session);
+        }
+    } else if (output_file != NULL) {
+        if (fast_backend) {
+            ok = assembly ? write_assembly(module, output_file) : write_object(module, output_file);
+        } else {
+            ok = emit_native(module, output_file, assembly, optimize);
+        }
+        end_phase("codegen");
+    } else {
+        char *ir_string = LLVMPrintModuleToString(module);
+        printf("%s", ir_string);
+        LLVMDisposeMessage(ir_string);
+        end_phase("print");
+    }
+
+    if (timing) {
+        print_phase_times();
+    }
+    if (peephole_stats && fast_backend) {
+        print_peephole_stats(stderr);
+    }
+
+    if (module != NULL) {
+        LLVMDisposeModule(module);
+    }
+    return ok ? 0 : 1;
+}
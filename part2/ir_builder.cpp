@@ -0,0 +1,566 @@
+#include "ir_builder.h"
+#include <stdio.h>
+#include <string.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+// ============================================================================
+// IR GENERATION
+// ============================================================================
+// walks the AST of a checked program and builds its LLVM module with the
+// LLVM-C builder. the module goes straight to the part3 passes, with no
+// clang run and no .ll text in between
+//
+// variables are the declarations the semantic checker resolved every name
+// to, so an inner `int a;` that shadows an outer one is a different
+// variable. they are built in one of two ways:
+//
+// variables_in_ssa: SSA directly, as the AST is walked (Braun et al.,
+// "Simple and Efficient Construction of Static Single Assignment Form").
+// an assignment records the value as the variable's definition in the
+// current block. a use looks the definition up in the block and, if it
+// isn't there, in the predecessors, placing a phi where they meet. a block
+// whose predecessors aren't all known yet (a loop header while its body is
+// built) isn't "sealed": uses there get a phi with no operands yet, filled
+// in when the block is sealed. phis that turn out to merge only one value
+// are replaced by it, so there is no alloca and no mem2reg afterwards
+//
+// variables_in_allocas: the shape clang -O0 hands the optimizer, every
+// variable (the parameter too) an alloca in the entry block, every use a
+// load and every assignment a store
+//
+// statements after a return in the same block can never run and aren't
+// generated, and a function that can fall off its end returns 0
+
+struct ir_state {
+    LLVMModuleRef module;
+    LLVMBuilderRef builder;
+    LLVMContextRef context;
+    LLVMTypeRef int_type;
+    LLVMValueRef function;
+
+    LLVMTypeRef print_type;
+    LLVMValueRef print_function;
+    LLVMTypeRef read_type;
+    LLVMValueRef read_function;
+
+    const declaration_map *declarations;
+    variable_mode mode;
+
+    // variables_in_allocas
+    unordered_map<astNode*, LLVMValueRef> slots;   // declaration -> alloca
+
+    // variables_in_ssa
+    LLVMBuilderRef phi_builder;
+    unordered_map<astNode*, unordered_map<LLVMBasicBlockRef, LLVMValueRef>> current_def;
+    unordered_map<LLVMBasicBlockRef, vector<LLVMBasicBlockRef>> preds;
+    unordered_set<LLVMBasicBlockRef> sealed;
+    unordered_map<LLVMBasicBlockRef, vector<pair<astNode*, LLVMValueRef>>> incomplete_phis;
+    unordered_set<LLVMValueRef> filling;                   // phis getting their operands
+    unordered_map<LLVMValueRef, LLVMValueRef> replaced;   // trivial phi -> its value
+};
+
+static void gen_stmt(ir_state &st, astNode *node);
+static LLVMValueRef gen_expr(ir_state &st, astNode *node);
+
+// ============================================================================
+// BLOCKS
+// ============================================================================
+
+// true once the block being built has its terminator (after a return)
+static bool block_terminated(ir_state &st) {
+    return LLVMGetBasicBlockTerminator(LLVMGetInsertBlock(st.builder)) != NULL;
+}
+
+// continue building in bb, placed after the blocks built so far
+static void start_block(ir_state &st, LLVMBasicBlockRef bb) {
+    LLVMAppendExistingBasicBlock(st.function, bb);
+    LLVMPositionBuilderAtEnd(st.builder, bb);
+}
+
+static LLVMBasicBlockRef new_block(ir_state &st) {
+    return LLVMCreateBasicBlockInContext(st.context, "");
+}
+
+// branches go through these so the predecessors of every block are known
+// while it is still being built (LLVM can only list them once the
+// terminators exist)
+static void gen_br(ir_state &st, LLVMBasicBlockRef target) {
+    st.preds[target].push_back(LLVMGetInsertBlock(st.builder));
+    LLVMBuildBr(st.builder, target);
+}
+
+static void gen_cond_br(ir_state &st, LLVMValueRef cond, LLVMBasicBlockRef then_bb,
+                        LLVMBasicBlockRef else_bb) {
+    LLVMBasicBlockRef bb = LLVMGetInsertBlock(st.builder);
+    st.preds[then_bb].push_back(bb);
+    st.preds[else_bb].push_back(bb);
+    LLVMBuildCondBr(st.builder, cond, then_bb, else_bb);
+}
+
+// ============================================================================
+// SSA CONSTRUCTION
+// ============================================================================
+
+static LLVMValueRef read_variable(ir_state &st, astNode *var, LLVMBasicBlockRef bb);
+
+static void write_variable(ir_state &st, astNode *var, LLVMBasicBlockRef bb, LLVMValueRef value) {
+    st.current_def[var][bb] = value;
+}
+
+// an empty phi at the start of bb
+static LLVMValueRef new_phi(ir_state &st, LLVMBasicBlockRef bb) {
+    LLVMValueRef first = LLVMGetFirstInstruction(bb);
+    if (first != NULL) {
+        LLVMPositionBuilderBefore(st.phi_builder, first);
+    } else {
+        LLVMPositionBuilderAtEnd(st.phi_builder, bb);
+    }
+    return LLVMBuildPhi(st.phi_builder, st.int_type, "");
+}
+
+// the value a removed phi stands for now (it may have been removed in turn)
+static LLVMValueRef resolve_replaced(ir_state &st, LLVMValueRef value) {
+    auto it = st.replaced.find(value);
+    while (it != st.replaced.end()) {
+        value = it->second;
+        it = st.replaced.find(value);
+    }
+    return value;
+}
+
+// a phi whose operands are all the same value (or the phi itself) is that
+// value. replacing it can make the phis that used it trivial too
+static void remove_trivial_phi(ir_state &st, LLVMValueRef phi) {
+    LLVMValueRef same = NULL;
+    unsigned count = LLVMCountIncoming(phi);
+    for (unsigned i = 0; i < count; i++) {
+        LLVMValueRef op = LLVMGetIncomingValue(phi, i);
+        if (op == same || op == phi) {
+            continue;
+        }
+        if (same != NULL) {
+            return;
+        }
+        same = op;
+    }
+    if (same == NULL) {
+        // only reachable through itself, or never defined
+        same = LLVMGetUndef(st.int_type);
+    }
+
+    vector<LLVMValueRef> users;
+    for (LLVMUseRef use = LLVMGetFirstUse(phi); use != NULL; use = LLVMGetNextUse(use)) {
+        LLVMValueRef user = LLVMGetUser(use);
+        if (user != phi && LLVMIsAPHINode(user)) {
+            users.push_back(user);
+        }
+    }
+
+    LLVMReplaceAllUsesWith(phi, same);
+    for (auto &var : st.current_def) {
+        for (auto &def : var.second) {
+            if (def.second == phi) {
+                def.second = same;
+            }
+        }
+    }
+    st.replaced[phi] = same;
+    LLVMInstructionEraseFromParent(phi);
+
+    // phis in unsealed blocks, or still reading their operands, are missing some
+    for (LLVMValueRef user : users) {
+        if (st.replaced.count(user) == 0 && st.filling.count(user) == 0 &&
+            st.sealed.count(LLVMGetInstructionParent(user))) {
+            remove_trivial_phi(st, user);
+        }
+    }
+}
+
+// fill in a phi from the predecessors of its block, then drop it if it
+// turned out trivial; returns what the phi's value is now
+static LLVMValueRef add_phi_operands(ir_state &st, astNode *var, LLVMValueRef phi) {
+    LLVMBasicBlockRef bb = LLVMGetInstructionParent(phi);
+    vector<LLVMBasicBlockRef> &bb_preds = st.preds[bb];
+    st.filling.insert(phi);
+    for (size_t i = 0; i < bb_preds.size(); i++) {
+        // added right away, so the operand follows along if a phi it is
+        // gets replaced while the next ones are read
+        LLVMValueRef value = read_variable(st, var, bb_preds[i]);
+        LLVMBasicBlockRef pred = bb_preds[i];
+        LLVMAddIncoming(phi, &value, &pred, 1);
+    }
+    st.filling.erase(phi);
+
+    remove_trivial_phi(st, phi);
+    LLVMValueRef value = resolve_replaced(st, phi);
+    st.replaced.clear();
+    return value;
+}
+
+static LLVMValueRef read_variable_recursive(ir_state &st, astNode *var, LLVMBasicBlockRef bb) {
+    LLVMValueRef value;
+    vector<LLVMBasicBlockRef> &bb_preds = st.preds[bb];
+
+    if (st.sealed.count(bb) == 0) {
+        // more predecessors to come: operands are added when bb is sealed
+        value = new_phi(st, bb);
+        st.incomplete_phis[bb].push_back(make_pair(var, value));
+    } else if (bb_preds.size() == 0) {
+        // the entry block: read before any assignment
+        value = LLVMGetUndef(st.int_type);
+    } else if (bb_preds.size() == 1) {
+        value = read_variable(st, var, bb_preds[0]);
+    } else {
+        // record the phi first, a loop back to bb finds it instead of
+        // recursing forever
+        LLVMValueRef phi = new_phi(st, bb);
+        write_variable(st, var, bb, phi);
+        value = add_phi_operands(st, var, phi);
+    }
+
+    write_variable(st, var, bb, value);
+    return value;
+}
+
+static LLVMValueRef read_variable(ir_state &st, astNode *var, LLVMBasicBlockRef bb) {
+    auto &defs = st.current_def[var];
+    auto it = defs.find(bb);
+    if (it != defs.end()) {
+        return it->second;
+    }
+    return read_variable_recursive(st, var, bb);
+}
+
+// every predecessor of bb has been generated
+static void seal_block(ir_state &st, LLVMBasicBlockRef bb) {
+    if (st.mode != variables_in_ssa) {
+        return;
+    }
+    st.sealed.insert(bb);
+    vector<pair<astNode*, LLVMValueRef>> phis;
+    phis.swap(st.incomplete_phis[bb]);
+    for (auto &pending : phis) {
+        st.filling.insert(pending.second);
+    }
+    for (auto &pending : phis) {
+        add_phi_operands(st, pending.first, pending.second);
+    }
+}
+
+// ============================================================================
+// VARIABLES
+// ============================================================================
+
+// one alloca per declaration in the body, in source order (the entry block
+// is current, so they all land there)
+static void create_slots(ir_state &st, astNode *node) {
+    if (node == NULL || node->type != ast_stmt) {
+        return;
+    }
+
+    switch (node->stmt.type) {
+        case ast_decl:
+            st.slots[node] = LLVMBuildAlloca(st.builder, st.int_type, "");
+            break;
+
+        case ast_block: {
+            vector<astNode*> *slist = node->stmt.block.stmt_list;
+            for (auto it = slist->begin(); it != slist->end(); ++it) {
+                create_slots(st, *it);
+            }
+            break;
+        }
+
+        case ast_while:
+            create_slots(st, node->stmt.whilen.body);
+            break;
+
+        case ast_if:
+            create_slots(st, node->stmt.ifn.if_body);
+            create_slots(st, node->stmt.ifn.else_body);
+            break;
+
+        default:
+            break;
+    }
+}
+
+// the declaration an ast_var node refers to (the checker resolved them all)
+static astNode *declaration_of(ir_state &st, astNode *var) {
+    auto it = st.declarations->find(var);
+    if (it == st.declarations->end()) {
+        fprintf(stderr, "ir builder: '%s' is not declared\n", var->var.name);
+        return NULL;
+    }
+    return it->second;
+}
+
+static LLVMValueRef gen_use(ir_state &st, astNode *var) {
+    astNode *decl = declaration_of(st, var);
+    if (decl == NULL) {
+        return LLVMGetUndef(st.int_type);
+    }
+    if (st.mode == variables_in_ssa) {
+        return read_variable(st, decl, LLVMGetInsertBlock(st.builder));
+    }
+    return LLVMBuildLoad2(st.builder, st.int_type, st.slots[decl], "");
+}
+
+static void gen_assign(ir_state &st, astNode *var, LLVMValueRef value) {
+    astNode *decl = declaration_of(st, var);
+    if (decl == NULL) {
+        return;
+    }
+    if (st.mode == variables_in_ssa) {
+        write_variable(st, decl, LLVMGetInsertBlock(st.builder), value);
+    } else {
+        LLVMBuildStore(st.builder, value, st.slots[decl]);
+    }
+}
+
+// ============================================================================
+// EXPRESSIONS
+// ============================================================================
+
+static LLVMIntPredicate predicate_for(rop_type op) {
+    switch (op) {
+        case lt: return LLVMIntSLT;
+        case gt: return LLVMIntSGT;
+        case le: return LLVMIntSLE;
+        case ge: return LLVMIntSGE;
+        case eq: return LLVMIntEQ;
+        case neq: return LLVMIntNE;
+    }
+    return LLVMIntEQ;
+}
+
+// an i1 for the condition of an if or while: the compare itself for a
+// relational expression, anything else is tested against 0
+static LLVMValueRef gen_cond(ir_state &st, astNode *node) {
+    if (node->type == ast_rexpr) {
+        LLVMValueRef lhs = gen_expr(st, node->rexpr.lhs);
+        LLVMValueRef rhs = gen_expr(st, node->rexpr.rhs);
+        return LLVMBuildICmp(st.builder, predicate_for(node->rexpr.op), lhs, rhs, "");
+    }
+    return LLVMBuildICmp(st.builder, LLVMIntNE, gen_expr(st, node),
+                         LLVMConstInt(st.int_type, 0, 0), "");
+}
+
+static LLVMValueRef gen_expr(ir_state &st, astNode *node) {
+    switch (node->type) {
+        case ast_cnst:
+            return LLVMConstInt(st.int_type, (unsigned long long)(long long)node->cnst.value, 1);
+
+        case ast_var:
+            return gen_use(st, node);
+
+        case ast_rexpr:
+            // a compare used as a value is 0 or 1
+            return LLVMBuildZExt(st.builder, gen_cond(st, node), st.int_type, "");
+
+        case ast_bexpr: {
+            LLVMValueRef lhs = gen_expr(st, node->bexpr.lhs);
+            LLVMValueRef rhs = gen_expr(st, node->bexpr.rhs);
+            switch (node->bexpr.op) {
+                case add:    return LLVMBuildNSWAdd(st.builder, lhs, rhs, "");
+                case sub:    return LLVMBuildNSWSub(st.builder, lhs, rhs, "");
+                case mul:    return LLVMBuildNSWMul(st.builder, lhs, rhs, "");
+                case divide: return LLVMBuildSDiv(st.builder, lhs, rhs, "");
+                case uminus: break;
+            }
+            break;
+        }
+
+        case ast_uexpr:
+            return LLVMBuildNSWNeg(st.builder, gen_expr(st, node->uexpr.expr), "");
+
+        case ast_stmt:
+            // read() is the only call that produces a value
+            if (node->stmt.type == ast_call && strcmp(node->stmt.call.name, "read") == 0) {
+                return LLVMBuildCall2(st.builder, st.read_type, st.read_function, NULL, 0, "");
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    fprintf(stderr, "ir builder: unexpected expression node\n");
+    return LLVMGetUndef(st.int_type);
+}
+
+// ============================================================================
+// STATEMENTS
+// ============================================================================
+
+static void gen_if(ir_state &st, astNode *node) {
+    LLVMBasicBlockRef then_bb = new_block(st);
+    LLVMBasicBlockRef else_bb = new_block(st);
+    bool has_else = node->stmt.ifn.else_body != NULL;
+
+    // without an else the false edge goes straight to the join
+    gen_cond_br(st, gen_cond(st, node->stmt.ifn.cond), then_bb, else_bb);
+    seal_block(st, then_bb);
+
+    start_block(st, then_bb);
+    gen_stmt(st, node->stmt.ifn.if_body);
+    LLVMBasicBlockRef then_end = block_terminated(st) ? NULL : LLVMGetInsertBlock(st.builder);
+
+    if (!has_else) {
+        if (then_end != NULL) {
+            gen_br(st, else_bb);
+        }
+        seal_block(st, else_bb);
+        start_block(st, else_bb);
+        return;
+    }
+
+    seal_block(st, else_bb);
+    start_block(st, else_bb);
+    gen_stmt(st, node->stmt.ifn.else_body);
+    LLVMBasicBlockRef else_end = block_terminated(st) ? NULL : LLVMGetInsertBlock(st.builder);
+
+    // both arms return: nothing follows the if
+    if (then_end == NULL && else_end == NULL) {
+        return;
+    }
+
+    LLVMBasicBlockRef join_bb = new_block(st);
+    if (else_end != NULL) {
+        gen_br(st, join_bb);
+    }
+    if (then_end != NULL) {
+        LLVMPositionBuilderAtEnd(st.builder, then_end);
+        gen_br(st, join_bb);
+    }
+    seal_block(st, join_bb);
+    start_block(st, join_bb);
+}
+
+static void gen_while(ir_state &st, astNode *node) {
+    LLVMBasicBlockRef cond_bb = new_block(st);
+    LLVMBasicBlockRef body_bb = new_block(st);
+    LLVMBasicBlockRef end_bb = new_block(st);
+
+    gen_br(st, cond_bb);
+
+    // the header stays unsealed until the body's back edge exists
+    start_block(st, cond_bb);
+    gen_cond_br(st, gen_cond(st, node->stmt.whilen.cond), body_bb, end_bb);
+    seal_block(st, body_bb);
+    seal_block(st, end_bb);
+
+    start_block(st, body_bb);
+    gen_stmt(st, node->stmt.whilen.body);
+    if (!block_terminated(st)) {
+        gen_br(st, cond_bb);
+    }
+    seal_block(st, cond_bb);
+
+    start_block(st, end_bb);
+}
+
+static void gen_stmt(ir_state &st, astNode *node) {
+    switch (node->stmt.type) {
+        case ast_call:
+            if (strcmp(node->stmt.call.name, "print") == 0) {
+                LLVMValueRef arg = gen_expr(st, node->stmt.call.param);
+                LLVMBuildCall2(st.builder, st.print_type, st.print_function, &arg, 1, "");
+            } else {
+                gen_expr(st, node);
+            }
+            break;
+
+        case ast_ret:
+            LLVMBuildRet(st.builder, gen_expr(st, node->stmt.ret.expr));
+            break;
+
+        case ast_block: {
+            vector<astNode*> *slist = node->stmt.block.stmt_list;
+            for (auto it = slist->begin(); it != slist->end() && !block_terminated(st); ++it) {
+                gen_stmt(st, *it);
+            }
+            break;
+        }
+
+        case ast_while:
+            gen_while(st, node);
+            break;
+
+        case ast_if:
+            gen_if(st, node);
+            break;
+
+        case ast_decl:
+            // the checker already tied every use to its declaration
+            break;
+
+        case ast_asgn:
+            gen_assign(st, node->stmt.asgn.lhs, gen_expr(st, node->stmt.asgn.rhs));
+            break;
+    }
+}
+
+// ============================================================================
+// FUNCTIONS AND THE MODULE
+// ============================================================================
+
+static void gen_func(ir_state &st, astNode *node) {
+    astNode *param = node->func.param;
+    LLVMTypeRef param_types[] = { st.int_type };
+    LLVMTypeRef type = LLVMFunctionType(st.int_type, param_types, param != NULL ? 1 : 0, 0);
+    st.function = LLVMAddFunction(st.module, node->func.name, type);
+
+    LLVMBasicBlockRef entry = LLVMAppendBasicBlockInContext(st.context, st.function, "");
+    LLVMPositionBuilderAtEnd(st.builder, entry);
+    seal_block(st, entry);
+
+    if (st.mode == variables_in_ssa) {
+        if (param != NULL) {
+            write_variable(st, param, entry, LLVMGetParam(st.function, 0));
+        }
+    } else {
+        if (param != NULL) {
+            st.slots[param] = LLVMBuildAlloca(st.builder, st.int_type, "");
+        }
+        create_slots(st, node->func.body);
+        if (param != NULL) {
+            LLVMBuildStore(st.builder, LLVMGetParam(st.function, 0), st.slots[param]);
+        }
+    }
+
+    gen_stmt(st, node->func.body);
+    if (!block_terminated(st)) {
+        LLVMBuildRet(st.builder, LLVMConstInt(st.int_type, 0, 0));
+    }
+}
+
+LLVMModuleRef build_module(astNode *root, const char *module_name,
+                           const declaration_map &declarations, variable_mode mode) {
+    ir_state st;
+    st.context = LLVMGetGlobalContext();
+    st.module = LLVMModuleCreateWithNameInContext(module_name, st.context);
+    LLVMSetSourceFileName(st.module, module_name, strlen(module_name));
+    st.builder = LLVMCreateBuilderInContext(st.context);
+    st.phi_builder = LLVMCreateBuilderInContext(st.context);
+    st.int_type = LLVMInt32TypeInContext(st.context);
+    st.declarations = &declarations;
+    st.mode = mode;
+
+    // extern void print(int); extern int read();
+    LLVMTypeRef print_params[] = { st.int_type };
+    st.print_type = LLVMFunctionType(LLVMVoidTypeInContext(st.context), print_params, 1, 0);
+    st.print_function = LLVMAddFunction(st.module, "print", st.print_type);
+    st.read_type = LLVMFunctionType(st.int_type, NULL, 0, 0);
+    st.read_function = LLVMAddFunction(st.module, "read", st.read_type);
+
+    gen_func(st, root->prog.func);
+
+    LLVMDisposeBuilder(st.phi_builder);
+    LLVMDisposeBuilder(st.builder);
+    return st.module;
+}
@@ -0,0 +1,23 @@
+#ifndef IR_BUILDER_H
+#define IR_BUILDER_H
+
+#include "semantic.h"
+#include <llvm-c/Core.h>
+
+// ============================================================================
+// IR GENERATION (ir_builder.cpp)
+// ============================================================================
+
+// how variables are represented in the generated IR
+enum variable_mode {
+    variables_in_ssa,       // SSA values and phis, built while walking the AST
+    variables_in_allocas,   // one alloca per variable, loads and stores (clang -O0)
+};
+
+// build the LLVM module for a parsed and semantically checked miniC program
+// (root is the ast_prog node, declarations what resolve_declarations found
+// for it), in the global context so the part3 passes can run on it directly
+LLVMModuleRef build_module(astNode *root, const char *module_name,
+                           const declaration_map &declarations, variable_mode mode);
+
+#endif
@@ -0,0 +1,57 @@
+; ModuleID = 'p1.c'
+source_filename = "p1.c"
+
+declare void @print(i32)
+
+declare i32 @read()
+
+define i32 @func(i32 %0) {
+  %2 = alloca i32, align 4
+  %3 = alloca i32, align 4
+  %4 = alloca i32, align 4
+  store i32 %0, ptr %2, align 4
+  store i32 5, ptr %3, align 4
+  store i32 2, ptr %4, align 4
+  %5 = load i32, ptr %3, align 4
+  %6 = load i32, ptr %2, align 4
+  %7 = icmp slt i32 %5, %6
+  br i1 %7, label %8, label %19
+
+8:                                                ; preds = %1
+  br label %9
+
+9:                                                ; preds = %13, %8
+  %10 = load i32, ptr %4, align 4
+  %11 = load i32, ptr %2, align 4
+  %12 = icmp slt i32 %10, %11
+  br i1 %12, label %13, label %16
+
+13:                                               ; preds = %9
+  %14 = load i32, ptr %4, align 4
+  %15 = add nsw i32 %14, 20
+  store i32 %15, ptr %4, align 4
+  br label %9
+
+16:                                               ; preds = %9
+  %17 = load i32, ptr %4, align 4
+  %18 = add nsw i32 10, %17
+  store i32 %18, ptr %3, align 4
+  br label %26
+
+19:                                               ; preds = %1
+  %20 = load i32, ptr %4, align 4
+  %21 = load i32, ptr %2, align 4
+  %22 = icmp slt i32 %20, %21
+  br i1 %22, label %23, label %25
+
+23:                                               ; preds = %19
+  %24 = load i32, ptr %3, align 4
+  store i32 %24, ptr %4, align 4
+  br label %25
+
+25:                                               ; preds = %23, %19
+  br label %26
+
+26:                                               ; preds = %16, %25
+  ret i32 1
+}
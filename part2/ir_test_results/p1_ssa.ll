@@ -0,0 +1,40 @@
+; ModuleID = 'p1.c'
+source_filename = "p1.c"
+
+declare void @print(i32)
+
+declare i32 @read()
+
+define i32 @func(i32 %0) {
+  %2 = icmp slt i32 5, %0
+  br i1 %2, label %3, label %11
+
+3:                                                ; preds = %1
+  br label %4
+
+4:                                                ; preds = %7, %3
+  %5 = phi i32 [ 2, %3 ], [ %8, %7 ]
+  %6 = icmp slt i32 %5, %0
+  br i1 %6, label %7, label %9
+
+7:                                                ; preds = %4
+  %8 = add nsw i32 %5, 20
+  br label %4
+
+9:                                                ; preds = %4
+  %10 = add nsw i32 10, %5
+  br label %15
+
+11:                                               ; preds = %1
+  %12 = icmp slt i32 2, %0
+  br i1 %12, label %13, label %14
+
+13:                                               ; preds = %11
+  br label %14
+
+14:                                               ; preds = %13, %11
+  br label %15
+
+15:                                               ; preds = %9, %14
+  ret i32 1
+}
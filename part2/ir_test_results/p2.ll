@@ -0,0 +1,52 @@
+; ModuleID = 'p2.c'
+source_filename = "p2.c"
+
+declare void @print(i32)
+
+declare i32 @read()
+
+define i32 @func(i32 %0) {
+  %2 = alloca i32, align 4
+  %3 = alloca i32, align 4
+  %4 = alloca i32, align 4
+  %5 = alloca i32, align 4
+  store i32 %0, ptr %2, align 4
+  store i32 10, ptr %3, align 4
+  store i32 5, ptr %4, align 4
+  br label %6
+
+6:                                                ; preds = %19, %1
+  %7 = load i32, ptr %3, align 4
+  %8 = load i32, ptr %2, align 4
+  %9 = icmp slt i32 %7, %8
+  br i1 %9, label %10, label %22
+
+10:                                               ; preds = %6
+  br label %11
+
+11:                                               ; preds = %15, %10
+  %12 = load i32, ptr %4, align 4
+  %13 = load i32, ptr %2, align 4
+  %14 = icmp slt i32 %12, %13
+  br i1 %14, label %15, label %19
+
+15:                                               ; preds = %11
+  %16 = load i32, ptr %4, align 4
+  %17 = add nsw i32 %16, 20
+  store i32 %17, ptr %4, align 4
+  %18 = load i32, ptr %4, align 4
+  call void @print(i32 %18)
+  br label %11
+
+19:                                               ; preds = %11
+  %20 = load i32, ptr %4, align 4
+  %21 = add nsw i32 %20, 10
+  store i32 %21, ptr %3, align 4
+  br label %6
+
+22:                                               ; preds = %6
+  %23 = load i32, ptr %3, align 4
+  %24 = load i32, ptr %4, align 4
+  %25 = add nsw i32 %23, %24
+  ret i32 %25
+}
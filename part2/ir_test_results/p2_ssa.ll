@@ -0,0 +1,37 @@
+; ModuleID = 'p2.c'
+source_filename = "p2.c"
+
+declare void @print(i32)
+
+declare i32 @read()
+
+define i32 @func(i32 %0) {
+  br label %2
+
+2:                                                ; preds = %12, %1
+  %3 = phi i32 [ 5, %1 ], [ %8, %12 ]
+  %4 = phi i32 [ 10, %1 ], [ %13, %12 ]
+  %5 = icmp slt i32 %4, %0
+  br i1 %5, label %6, label %14
+
+6:                                                ; preds = %2
+  br label %7
+
+7:                                                ; preds = %10, %6
+  %8 = phi i32 [ %3, %6 ], [ %11, %10 ]
+  %9 = icmp slt i32 %8, %0
+  br i1 %9, label %10, label %12
+
+10:                                               ; preds = %7
+  %11 = add nsw i32 %8, 20
+  call void @print(i32 %11)
+  br label %7
+
+12:                                               ; preds = %7
+  %13 = add nsw i32 %8, 10
+  br label %2
+
+14:                                               ; preds = %2
+  %15 = add nsw i32 %4, %3
+  ret i32 %15
+}
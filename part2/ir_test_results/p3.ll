@@ -0,0 +1,55 @@
+; ModuleID = 'p3.c'
+source_filename = "p3.c"
+
+declare void @print(i32)
+
+declare i32 @read()
+
+define i32 @func(i32 %0) {
+  %2 = alloca i32, align 4
+  %3 = alloca i32, align 4
+  %4 = alloca i32, align 4
+  %5 = alloca i32, align 4
+  %6 = alloca i32, align 4
+  store i32 %0, ptr %2, align 4
+  store i32 5, ptr %3, align 4
+  store i32 5, ptr %4, align 4
+  br label %7
+
+7:                                                ; preds = %11, %1
+  %8 = load i32, ptr %4, align 4
+  %9 = load i32, ptr %2, align 4
+  %10 = icmp slt i32 %8, %9
+  br i1 %10, label %11, label %17
+
+11:                                               ; preds = %7
+  %12 = load i32, ptr %4, align 4
+  %13 = add nsw i32 10, %12
+  store i32 %13, ptr %5, align 4
+  %14 = load i32, ptr %4, align 4
+  %15 = load i32, ptr %2, align 4
+  %16 = mul nsw i32 %14, %15
+  store i32 %16, ptr %4, align 4
+  br label %7
+
+17:                                               ; preds = %7
+  br label %18
+
+18:                                               ; preds = %22, %17
+  %19 = load i32, ptr %4, align 4
+  %20 = load i32, ptr %2, align 4
+  %21 = icmp slt i32 %19, %20
+  br i1 %21, label %22, label %25
+
+22:                                               ; preds = %18
+  %23 = load i32, ptr %4, align 4
+  %24 = mul nsw i32 %23, 10
+  store i32 %24, ptr %4, align 4
+  br label %18
+
+25:                                               ; preds = %18
+  %26 = load i32, ptr %3, align 4
+  %27 = load i32, ptr %4, align 4
+  %28 = mul nsw i32 %26, %27
+  ret i32 %28
+}
@@ -0,0 +1,36 @@
+; ModuleID = 'p3.c'
+source_filename = "p3.c"
+
+declare void @print(i32)
+
+declare i32 @read()
+
+define i32 @func(i32 %0) {
+  br label %2
+
+2:                                                ; preds = %5, %1
+  %3 = phi i32 [ 5, %1 ], [ %7, %5 ]
+  %4 = icmp slt i32 %3, %0
+  br i1 %4, label %5, label %8
+
+5:                                                ; preds = %2
+  %6 = add nsw i32 10, %3
+  %7 = mul nsw i32 %3, %0
+  br label %2
+
+8:                                                ; preds = %2
+  br label %9
+
+9:                                                ; preds = %12, %8
+  %10 = phi i32 [ %3, %8 ], [ %13, %12 ]
+  %11 = icmp slt i32 %10, %0
+  br i1 %11, label %12, label %14
+
+12:                                               ; preds = %9
+  %13 = mul nsw i32 %10, 10
+  br label %9
+
+14:                                               ; preds = %9
+  %15 = mul nsw i32 5, %10
+  ret i32 %15
+}
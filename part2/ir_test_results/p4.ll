@@ -0,0 +1,36 @@
+; ModuleID = 'p4.c'
+source_filename = "p4.c"
+
+declare void @print(i32)
+
+declare i32 @read()
+
+define i32 @func(i32 %0) {
+  %2 = alloca i32, align 4
+  %3 = alloca i32, align 4
+  %4 = alloca i32, align 4
+  store i32 %0, ptr %2, align 4
+  %5 = call i32 @read()
+  store i32 %5, ptr %3, align 4
+  store i32 5, ptr %4, align 4
+  br label %6
+
+6:                                                ; preds = %10, %1
+  %7 = load i32, ptr %3, align 4
+  %8 = load i32, ptr %2, align 4
+  %9 = icmp slt i32 %7, %8
+  br i1 %9, label %10, label %15
+
+10:                                               ; preds = %6
+  %11 = load i32, ptr %3, align 4
+  %12 = load i32, ptr %4, align 4
+  %13 = add nsw i32 %11, %12
+  store i32 %13, ptr %3, align 4
+  %14 = load i32, ptr %4, align 4
+  call void @print(i32 %14)
+  br label %6
+
+15:                                               ; preds = %6
+  %16 = load i32, ptr %3, align 4
+  ret i32 %16
+}
@@ -0,0 +1,24 @@
+; ModuleID = 'p4.c'
+source_filename = "p4.c"
+
+declare void @print(i32)
+
+declare i32 @read()
+
+define i32 @func(i32 %0) {
+  %2 = call i32 @read()
+  br label %3
+
+3:                                                ; preds = %6, %1
+  %4 = phi i32 [ %2, %1 ], [ %7, %6 ]
+  %5 = icmp slt i32 %4, %0
+  br i1 %5, label %6, label %8
+
+6:                                                ; preds = %3
+  %7 = add nsw i32 %4, 5
+  call void @print(i32 5)
+  br label %3
+
+8:                                                ; preds = %3
+  ret i32 %4
+}
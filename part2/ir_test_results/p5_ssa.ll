@@ -0,0 +1,23 @@
+; ModuleID = 'p5.c'
+source_filename = "p5.c"
+
+declare void @print(i32)
+
+declare i32 @read()
+
+define i32 @func(i32 %0) {
+  br label %2
+
+2:                                                ; preds = %5, %1
+  %3 = phi i32 [ 0, %1 ], [ %7, %5 ]
+  %4 = icmp slt i32 %3, %0
+  br i1 %4, label %5, label %8
+
+5:                                                ; preds = %2
+  %6 = call i32 @read()
+  %7 = add nsw i32 10, %6
+  br label %2
+
+8:                                                ; preds = %2
+  ret i32 %3
+}
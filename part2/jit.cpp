@@ -0,0 +1,247 @@
+#include "jit.h"
+#include "codegen.h"
+#include "optimizer.h"
+#include <llvm-c/Error.h>
+#include <llvm-c/LLJIT.h>
+#include <llvm-c/Orc.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+// ============================================================================
+// IN-PROCESS EXECUTION
+// ============================================================================
+// --jit: the programs go to an ORC LLJIT instead of an object file, and
+// func is called right here, without writing, linking or starting
+// anything. print and read are the driver's own functions, the same as
+// parser_tests/main.c's, defined in the JIT's main library as absolute
+// symbols so the compiled calls go straight to them.
+//
+// every function is called through a lazy stub. its name (func, func.1,
+// ...) is a reexport of the function itself, renamed func.body,
+// func.1.body, ..., and the first call through the stub looks the body
+// up: that is when the IR transform layer runs the part3 passes on the
+// body's module and LLJIT compiles it. so the first result waits for func
+// alone, however many programs were loaded. meanwhile a thread looks up
+// the other bodies one at a time, compiling them before anyone calls
+// them (or not at all, if the session ends first).
+//
+// the modules stay in the global context the passes built them in (they
+// make their builders there), so they share one thread safe context: its
+// lock is held around every transform and compile, and the passes and the
+// one target machine never run on two threads at once. func waits for at
+// most the one background compile already under way
+
+struct jit_session {
+    LLVMOrcLLJITRef jit;
+    LLVMOrcLazyCallThroughManagerRef call_through;
+    LLVMOrcIndirectStubsManagerRef stubs;
+    int (*func)(int);
+    vector<string> cold;            // the other bodies, for the background thread
+    thread background;
+    atomic<bool> stop;
+};
+
+static void host_print(int n) {
+    printf("%d\n", n);
+}
+
+static int host_read() {
+    int n;
+    if (scanf("%d", &n) != 1) {
+        n = 0;
+    }
+    return n;
+}
+
+// true (and the message) if error is one
+static bool failed(LLVMErrorRef error) {
+    if (error == NULL) {
+        return false;
+    }
+    char *message = LLVMGetErrorMessage(error);
+    fprintf(stderr, "error: jit: %s\n", message);
+    LLVMDisposeErrorMessage(message);
+    return true;
+}
+
+// errors no caller is waiting for, such as a lazy compile's
+static void report_error(void *, LLVMErrorRef error) {
+    failed(error);
+}
+
+// where a stub goes when its body can't be compiled, after report_error
+static void lazy_compile_failed() {
+    fprintf(stderr, "error: jit: a function could not be compiled\n");
+    exit(1);
+}
+
+static LLVMErrorRef run_passes(void *, LLVMModuleRef module) {
+    if (!optimize_module(module)) {
+        return LLVMCreateStringError("the passes failed");
+    }
+    return NULL;
+}
+
+// the IR transform layer's step, on whichever thread is compiling the module
+static LLVMErrorRef optimize_when_compiled(void *, LLVMOrcThreadSafeModuleRef *module,
+                                           LLVMOrcMaterializationResponsibilityRef) {
+    return LLVMOrcThreadSafeModuleWithModuleDo(*module, run_passes, NULL);
+}
+
+static void compile_cold(jit_session *session) {
+    for (const string &body : session->cold) {
+        if (session->stop) {
+            return;
+        }
+        LLVMOrcExecutorAddress address;
+        failed(LLVMOrcLLJITLookup(session->jit, &address, body.c_str()));
+    }
+}
+
+static LLVMJITSymbolFlags callable() {
+    LLVMJITSymbolFlags flags;
+    flags.GenericFlags = LLVMJITSymbolGenericFlagsExported | LLVMJITSymbolGenericFlagsCallable;
+    flags.TargetFlags = 0;
+    return flags;
+}
+
+static LLVMJITCSymbolMapPair host_symbol(LLVMOrcLLJITRef jit, const char *name, void *address) {
+    LLVMJITCSymbolMapPair pair;
+    pair.Name = LLVMOrcLLJITMangleAndIntern(jit, name);
+    pair.Sym.Address = (LLVMOrcExecutorAddress)(uintptr_t)address;
+    pair.Sym.Flags = callable();
+    return pair;
+}
+
+// what module k's func is called in the session
+static string function_name(size_t k) {
+    return k == 0 ? "func" : "func." + to_string(k);
+}
+
+static void dispose_modules(const vector<LLVMModuleRef> &modules, size_t first) {
+    for (size_t k = first; k < modules.size(); k++) {
+        LLVMDisposeModule(modules[k]);
+    }
+}
+
+jit_session *jit_compile(const vector<LLVMModuleRef> &modules, bool optimize) {
+    LLVMTargetMachineRef machine = host_target_machine(optimize);
+    if (machine == NULL) {
+        dispose_modules(modules, 0);
+        return NULL;
+    }
+    LLVMOrcLLJITBuilderRef builder = LLVMOrcCreateLLJITBuilder();
+    LLVMOrcLLJITBuilderSetJITTargetMachineBuilder(
+        builder, LLVMOrcJITTargetMachineBuilderCreateFromTargetMachine(machine));
+
+    jit_session *session = new jit_session();
+    if (failed(LLVMOrcCreateLLJIT(&session->jit, builder))) {
+        dispose_modules(modules, 0);
+        delete session;
+        return NULL;
+    }
+    LLVMOrcExecutionSessionRef execution = LLVMOrcLLJITGetExecutionSession(session->jit);
+    LLVMOrcExecutionSessionSetErrorReporter(execution, report_error, NULL);
+    if (optimize) {
+        LLVMOrcIRTransformLayerSetTransform(LLVMOrcLLJITGetIRTransformLayer(session->jit),
+                                            optimize_when_compiled, NULL);
+    }
+
+    const char *triple = LLVMOrcLLJITGetTripleString(session->jit);
+    session->stubs = LLVMOrcCreateLocalIndirectStubsManager(triple);
+    if (failed(LLVMOrcCreateLocalLazyCallThroughManager(
+            triple, execution, (LLVMOrcJITTargetAddress)(uintptr_t)lazy_compile_failed,
+            &session->call_through))) {
+        dispose_modules(modules, 0);
+        jit_dispose(session);
+        return NULL;
+    }
+
+    LLVMOrcJITDylibRef library = LLVMOrcLLJITGetMainJITDylib(session->jit);
+    LLVMJITCSymbolMapPair host[] = {
+        host_symbol(session->jit, "print", (void *)host_print),
+        host_symbol(session->jit, "read", (void *)host_read),
+    };
+    LLVMOrcMaterializationUnitRef host_symbols = LLVMOrcAbsoluteSymbols(host, 2);
+    if (failed(LLVMOrcJITDylibDefine(library, host_symbols))) {
+        LLVMOrcDisposeMaterializationUnit(host_symbols);
+        dispose_modules(modules, 0);
+        jit_dispose(session);
+        return NULL;
+    }
+
+    // added, not compiled: that waits for a lookup of the body
+    LLVMOrcThreadSafeContextRef context = LLVMOrcCreateNewThreadSafeContext();
+    for (size_t k = 0; k < modules.size(); k++) {
+        string body = function_name(k) + ".body";
+        LLVMValueRef func = LLVMGetNamedFunction(modules[k], "func");
+        LLVMSetValueName2(func, body.c_str(), body.size());
+        LLVMSetTarget(modules[k], triple);
+        LLVMSetDataLayout(modules[k], LLVMOrcLLJITGetDataLayoutStr(session->jit));
+        LLVMOrcThreadSafeModuleRef owned = LLVMOrcCreateNewThreadSafeModule(modules[k], context);
+        if (failed(LLVMOrcLLJITAddLLVMIRModule(session->jit, library, owned))) {
+            LLVMOrcDisposeThreadSafeContext(context);
+            dispose_modules(modules, k + 1);
+            jit_dispose(session);
+            return NULL;
+        }
+        if (k > 0) {
+            session->cold.push_back(body);
+        }
+    }
+    LLVMOrcDisposeThreadSafeContext(context);
+
+    vector<LLVMOrcCSymbolAliasMapPair> aliases(modules.size());
+    for (size_t k = 0; k < modules.size(); k++) {
+        string name = function_name(k);
+        aliases[k].Name = LLVMOrcLLJITMangleAndIntern(session->jit, name.c_str());
+        aliases[k].Entry.Name = LLVMOrcLLJITMangleAndIntern(session->jit, (name + ".body").c_str());
+        aliases[k].Entry.Flags = callable();
+    }
+    LLVMOrcMaterializationUnitRef stubs = LLVMOrcLazyReexports(
+        session->call_through, session->stubs, library, aliases.data(), aliases.size());
+    if (failed(LLVMOrcJITDylibDefine(library, stubs))) {
+        LLVMOrcDisposeMaterializationUnit(stubs);
+        jit_dispose(session);
+        return NULL;
+    }
+
+    // func's stub, the body compiles when it is called
+    LLVMOrcExecutorAddress address = 0;
+    if (failed(LLVMOrcLLJITLookup(session->jit, &address, "func"))) {
+        jit_dispose(session);
+        return NULL;
+    }
+    session->func = (int (*)(int))(uintptr_t)address;
+    if (!session->cold.empty()) {
+        session->background = thread(compile_cold, session);
+    }
+    return session;
+}
+
+int jit_call(jit_session *session, int argument) {
+    return session->func(argument);
+}
+
+// the stubs and the call through manager go first, the way LLVM's own
+// lazy C API example tears down
+void jit_dispose(jit_session *session) {
+    session->stop = true;
+    if (session->background.joinable()) {
+        session->background.join();
+    }
+    if (session->stubs != NULL) {
+        LLVMOrcDisposeIndirectStubsManager(session->stubs);
+    }
+    if (session->call_through != NULL) {
+        LLVMOrcDisposeLazyCallThroughManager(session->call_through);
+    }
+    failed(LLVMOrcDisposeLLJIT(session->jit));
+    delete session;
+}
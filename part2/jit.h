@@ -0,0 +1,30 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include <llvm-c/Core.h>
+
+#include <vector>
+
+// ============================================================================
+// IN-PROCESS EXECUTION (jit.cpp)
+// ============================================================================
+
+// programs loaded into this process by LLVM's ORC JIT, ready to call
+struct jit_session;
+
+// load the modules, one miniC program each, for the host (LLVM's default
+// codegen level and the part3 passes if optimize, neither otherwise) with
+// print and read bound to this process's stdout and stdin. the first
+// module's func is the one jit_call runs; the others' are renamed func.1,
+// func.2, ... in the order given. nothing is optimized or compiled until
+// it is first called, the functions nobody has called yet in the
+// background. the modules are handed over, the session disposes of them.
+// NULL (and a message) on an error
+jit_session *jit_compile(const std::vector<LLVMModuleRef> &modules, bool optimize);
+
+// func(argument), run in the compiled code
+int jit_call(jit_session *session, int argument);
+
+void jit_dispose(jit_session *session);
+
+#endif
@@ -0,0 +1,135 @@
+#include "optimizer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std;
+
+// ============================================================================
+// ALIAS ANALYSIS
+// ============================================================================
+// answers two questions for the memory-aware passes:
+//   - alias(p, q): can two pointers refer to the same memory?
+//   - get_mod_ref(inst, p): can an instruction read or write what p points to?
+//
+// pointers are classified by their underlying object, found by looking
+// through getelementptr and bitcast. allocas and globals are distinct
+// objects, so pointers into two different ones never alias. an alloca
+// whose address never escapes (is never stored, passed to a call or
+// returned) can only be reached through pointers derived from it, so no
+// call can touch it and no pointer based on anything else aliases it.
+//
+// there is no offset reasoning: two different pointers into the same
+// object may alias
+
+// strip getelementptr and bitcast (instructions or constant expressions)
+LLVMValueRef underlying_object(LLVMValueRef ptr) {
+    while (true) {
+        if (LLVMIsAGetElementPtrInst(ptr) || LLVMIsABitCastInst(ptr)) {
+            ptr = LLVMGetOperand(ptr, 0);
+            continue;
+        }
+        if (LLVMIsAConstantExpr(ptr)) {
+            LLVMOpcode opcode = LLVMGetConstOpcode(ptr);
+            if (opcode == LLVMGetElementPtr || opcode == LLVMBitCast) {
+                ptr = LLVMGetOperand(ptr, 0);
+                continue;
+            }
+        }
+        return ptr;
+    }
+}
+
+// true if value (an alloca or a pointer derived from it) is only ever used
+// to address loads and stores, directly or through more derived pointers
+static bool address_stays_local(LLVMValueRef value) {
+    for (LLVMUseRef use = LLVMGetFirstUse(value);
+         use != NULL;
+         use = LLVMGetNextUse(use)) {
+
+        LLVMValueRef user = LLVMGetUser(use);
+
+        if (LLVMIsALoadInst(user)) {
+            continue;
+        }
+        if (LLVMIsAStoreInst(user) && LLVMGetOperand(user, 0) != value) {
+            continue;
+        }
+        if ((LLVMIsAGetElementPtrInst(user) || LLVMIsABitCastInst(user)) &&
+            LLVMGetOperand(user, 0) == value && address_stays_local(user)) {
+            continue;
+        }
+
+        return false;
+    }
+    return true;
+}
+
+// check if an alloca's address never escapes the function
+bool is_non_escaping_alloca(LLVMValueRef alloca) {
+    return alloca != NULL && LLVMIsAAllocaInst(alloca) && address_stays_local(alloca);
+}
+
+// allocas and globals are separate objects; anything else (arguments,
+// loaded pointers) may point anywhere
+static bool is_identified_object(LLVMValueRef object) {
+    return LLVMIsAAllocaInst(object) || LLVMIsAGlobalVariable(object);
+}
+
+alias_result alias(LLVMValueRef ptr1, LLVMValueRef ptr2) {
+    if (ptr1 == ptr2) {
+        return MUST_ALIAS;
+    }
+
+    LLVMValueRef object1 = underlying_object(ptr1);
+    LLVMValueRef object2 = underlying_object(ptr2);
+    if (object1 == object2) {
+        return MAY_ALIAS;
+    }
+
+    if (is_identified_object(object1) && is_identified_object(object2)) {
+        return NO_ALIAS;
+    }
+
+    // nothing but pointers derived from a non-escaping alloca reach it
+    if (is_non_escaping_alloca(object1) || is_non_escaping_alloca(object2)) {
+        return NO_ALIAS;
+    }
+
+    return MAY_ALIAS;
+}
+
+// the miniC runtime: print and read only do I/O, they never touch the
+// program's memory
+static bool is_runtime_call(LLVMValueRef call) {
+    LLVMValueRef callee = LLVMGetCalledValue(call);
+    if (!LLVMIsAFunction(callee)) {
+        return false;
+    }
+    size_t len = 0;
+    const char *name = LLVMGetValueName2(callee, &len);
+    return strcmp(name, "print") == 0 || strcmp(name, "read") == 0;
+}
+
+mod_ref_result get_mod_ref(LLVMValueRef inst, LLVMValueRef ptr) {
+    switch (LLVMGetInstructionOpcode(inst)) {
+        case LLVMLoad:
+            return alias(get_load_address(inst), ptr) != NO_ALIAS ? MR_REF : MR_NONE;
+
+        case LLVMStore:
+            return alias(get_store_address(inst), ptr) != NO_ALIAS ? MR_MOD : MR_NONE;
+
+        case LLVMCall:
+            if (is_runtime_call(inst) || is_non_escaping_alloca(underlying_object(ptr))) {
+                return MR_NONE;
+            }
+            return MR_MOD_REF;
+
+        case LLVMAtomicRMW: case LLVMAtomicCmpXchg: case LLVMFence: case LLVMVAArg:
+            return MR_MOD_REF;
+
+        default:
+            // arithmetic, compares, casts, phis, branches
+            return MR_NONE;
+    }
+}
@@ -0,0 +1,645 @@
+#include "optimizer.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+// ============================================================================
+// HELPER FUNCTION: is_promotable_alloca
+// ============================================================================
+// returns true if the alloca is only ever used as the address of a load
+// or a store. such a slot never escapes, so nothing but those loads and
+// stores can read or write it (calls to print/read can't touch it)
+bool is_promotable_alloca(LLVMValueRef alloca) {
+    if (alloca == NULL || !LLVMIsAAllocaInst(alloca)) {
+        return false;
+    }
+
+    for (LLVMUseRef use = LLVMGetFirstUse(alloca);
+         use != NULL;
+         use = LLVMGetNextUse(use)) {
+
+        LLVMValueRef user = LLVMGetUser(use);
+
+        if (LLVMIsALoadInst(user)) {
+            continue;
+        }
+
+        // storing INTO the slot is fine, storing the slot's address is not
+        if (LLVMIsAStoreInst(user) && get_store_address(user) == alloca &&
+            LLVMGetOperand(user, 0) != alloca) {
+            continue;
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+// ============================================================================
+// HELPER FUNCTION: compute_predecessors
+// ============================================================================
+// fills preds[B] with every block that branches to B
+// a block that branches to B twice (br i1 %c, label %B, label %B) is listed once
+void compute_predecessors(LLVMValueRef function,
+                          unordered_map<LLVMBasicBlockRef, vector<LLVMBasicBlockRef>> &preds) {
+    preds.clear();
+
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+        preds[bb];
+    }
+
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+
+        LLVMValueRef term = LLVMGetBasicBlockTerminator(bb);
+        if (term == NULL) {
+            continue;
+        }
+
+        unsigned num_succs = LLVMGetNumSuccessors(term);
+        for (unsigned i = 0; i < num_succs; i++) {
+            LLVMBasicBlockRef succ = LLVMGetSuccessor(term, i);
+            vector<LLVMBasicBlockRef> &list = preds[succ];
+
+            bool seen = false;
+            for (LLVMBasicBlockRef p : list) {
+                if (p == bb) {
+                    seen = true;
+                    break;
+                }
+            }
+            if (!seen) {
+                list.push_back(bb);
+            }
+        }
+    }
+}
+
+// ============================================================================
+// HELPER FUNCTION: rewrite_phi_incoming
+// ============================================================================
+// the C API has no way to edit a phi in place, so each phi in bb that has
+// entries for old_pred is rebuilt: the first `keep` of those entries are
+// kept (relabelled as coming from new_pred), the rest are dropped, and the
+// old phi is replaced by the new one
+static void rewrite_phi_incoming(LLVMBasicBlockRef bb, LLVMBasicBlockRef old_pred,
+                                 LLVMBasicBlockRef new_pred, unsigned keep) {
+    LLVMBuilderRef builder = LLVMCreateBuilder();
+
+    LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+    while (inst != NULL && LLVMIsAPHINode(inst)) {
+        LLVMValueRef next_inst = LLVMGetNextInstruction(inst);
+
+        unsigned count = LLVMCountIncoming(inst);
+        bool has_pred = false;
+        for (unsigned i = 0; i < count; i++) {
+            if (LLVMGetIncomingBlock(inst, i) == old_pred) {
+                has_pred = true;
+                break;
+            }
+        }
+
+        if (has_pred) {
+            LLVMPositionBuilderBefore(builder, inst);
+            LLVMValueRef new_phi = LLVMBuildPhi(builder, LLVMTypeOf(inst), "");
+
+            unsigned seen = 0;
+            for (unsigned i = 0; i < count; i++) {
+                LLVMBasicBlockRef from = LLVMGetIncomingBlock(inst, i);
+                LLVMValueRef value = LLVMGetIncomingValue(inst, i);
+                if (from == old_pred) {
+                    if (seen++ >= keep) {
+                        continue;
+                    }
+                    from = new_pred;
+                }
+                LLVMAddIncoming(new_phi, &value, &from, 1);
+            }
+
+            LLVMReplaceAllUsesWith(inst, new_phi);
+            LLVMInstructionEraseFromParent(inst);
+        }
+
+        inst = next_inst;
+    }
+
+    LLVMDisposeBuilder(builder);
+}
+
+// ============================================================================
+// HELPER FUNCTION: remove_phi_incoming
+// ============================================================================
+// drops every incoming entry for pred from the phis at the top of bb
+void remove_phi_incoming(LLVMBasicBlockRef bb, LLVMBasicBlockRef pred) {
+    rewrite_phi_incoming(bb, pred, pred, 0);
+}
+
+// ============================================================================
+// HELPER FUNCTION: replace_phi_incoming_block
+// ============================================================================
+// the phis at the top of bb now receive old_pred's values from new_pred
+void replace_phi_incoming_block(LLVMBasicBlockRef bb, LLVMBasicBlockRef old_pred,
+                                LLVMBasicBlockRef new_pred) {
+    rewrite_phi_incoming(bb, old_pred, new_pred, (unsigned)-1);
+}
+
+// ============================================================================
+// HELPER FUNCTION: retarget_branch
+// ============================================================================
+// points every edge from -> old_target at new_target instead
+// (phis are left alone, the caller knows what they should say)
+void retarget_branch(LLVMBasicBlockRef from, LLVMBasicBlockRef old_target,
+                     LLVMBasicBlockRef new_target) {
+    LLVMValueRef term = LLVMGetBasicBlockTerminator(from);
+    unsigned num_succs = LLVMGetNumSuccessors(term);
+    for (unsigned i = 0; i < num_succs; i++) {
+        if (LLVMGetSuccessor(term, i) == old_target) {
+            LLVMSetSuccessor(term, i, new_target);
+        }
+    }
+}
+
+// ============================================================================
+// HELPER FUNCTION: make_branch_unconditional
+// ============================================================================
+// replaces the terminator term with `br label %target`
+// successors that lose the edge forget the block in their phis, and target
+// keeps exactly one phi entry for it (br i1 %c, label %t, label %t has two)
+void make_branch_unconditional(LLVMValueRef term, LLVMBasicBlockRef target) {
+    LLVMBasicBlockRef bb = LLVMGetInstructionParent(term);
+
+    unsigned num_succs = LLVMGetNumSuccessors(term);
+    vector<LLVMBasicBlockRef> succs;
+    for (unsigned i = 0; i < num_succs; i++) {
+        LLVMBasicBlockRef succ = LLVMGetSuccessor(term, i);
+        bool seen = false;
+        for (LLVMBasicBlockRef s : succs) {
+            if (s == succ) {
+                seen = true;
+            }
+        }
+        if (!seen) {
+            succs.push_back(succ);
+        }
+    }
+
+    for (LLVMBasicBlockRef succ : succs) {
+        rewrite_phi_incoming(succ, bb, bb, succ == target ? 1 : 0);
+    }
+
+    LLVMBuilderRef builder = LLVMCreateBuilder();
+    LLVMPositionBuilderBefore(builder, term);
+    LLVMBuildBr(builder, target);
+    LLVMDisposeBuilder(builder);
+
+    LLVMInstructionEraseFromParent(term);
+}
+
+// ============================================================================
+// HELPER FUNCTION: delete_dead_blocks
+// ============================================================================
+// deletes every block of the function that is not in live
+// live successors forget the dead block in their phis first, then all dead
+// instructions are dropped so the blocks have no remaining uses
+bool delete_dead_blocks(LLVMValueRef function,
+                        const unordered_set<LLVMBasicBlockRef> &live) {
+    vector<LLVMBasicBlockRef> dead;
+
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+        if (live.find(bb) == live.end()) {
+            dead.push_back(bb);
+        }
+    }
+
+    if (dead.empty()) {
+        return false;
+    }
+
+    // step 1: live successors stop listing dead blocks in their phis
+    for (LLVMBasicBlockRef bb : dead) {
+        LLVMValueRef term = LLVMGetBasicBlockTerminator(bb);
+        if (term == NULL) {
+            continue;
+        }
+        unsigned num_succs = LLVMGetNumSuccessors(term);
+        for (unsigned i = 0; i < num_succs; i++) {
+            LLVMBasicBlockRef succ = LLVMGetSuccessor(term, i);
+            if (live.find(succ) != live.end()) {
+                remove_phi_incoming(succ, bb);
+            }
+        }
+    }
+
+    // step 2: dead values may still be used by other dead blocks
+    for (LLVMBasicBlockRef bb : dead) {
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+             inst != NULL;
+             inst = LLVMGetNextInstruction(inst)) {
+            if (LLVMGetFirstUse(inst) != NULL) {
+                LLVMReplaceAllUsesWith(inst, LLVMGetUndef(LLVMTypeOf(inst)));
+            }
+        }
+    }
+
+    // step 3: empty the blocks (this drops the branches between them)
+    for (LLVMBasicBlockRef bb : dead) {
+        LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+        while (inst != NULL) {
+            LLVMValueRef next_inst = LLVMGetNextInstruction(inst);
+            LLVMInstructionEraseFromParent(inst);
+            inst = next_inst;
+        }
+    }
+
+    // step 4: delete the now empty blocks
+    for (LLVMBasicBlockRef bb : dead) {
+        LLVMDeleteBasicBlock(bb);
+    }
+
+    return true;
+}
+
+// ============================================================================
+// HELPER FUNCTION: remove_unreachable_blocks
+// ============================================================================
+// deletes the blocks the entry block can't reach
+bool remove_unreachable_blocks(LLVMValueRef function) {
+    unordered_set<LLVMBasicBlockRef> reachable;
+    vector<LLVMBasicBlockRef> stack;
+
+    LLVMBasicBlockRef entry = LLVMGetFirstBasicBlock(function);
+    reachable.insert(entry);
+    stack.push_back(entry);
+
+    while (!stack.empty()) {
+        LLVMBasicBlockRef bb = stack.back();
+        stack.pop_back();
+
+        LLVMValueRef term = LLVMGetBasicBlockTerminator(bb);
+        if (term == NULL) {
+            continue;
+        }
+        unsigned num_succs = LLVMGetNumSuccessors(term);
+        for (unsigned i = 0; i < num_succs; i++) {
+            LLVMBasicBlockRef succ = LLVMGetSuccessor(term, i);
+            if (reachable.insert(succ).second) {
+                stack.push_back(succ);
+            }
+        }
+    }
+
+    return delete_dead_blocks(function, reachable);
+}
+
+// ============================================================================
+// HELPER FUNCTION: compute_reaching_stores
+// ============================================================================
+// classic reaching definitions over stores to promotable allocas
+// for every load from such an alloca, reaching[load] is the set of stores
+// whose value the load may observe. an empty set means only the
+// uninitialized (undef) contents reach the load
+void compute_reaching_stores(LLVMValueRef function,
+                             unordered_map<LLVMValueRef, unordered_set<LLVMValueRef>> &reaching) {
+    reaching.clear();
+
+    unordered_map<LLVMBasicBlockRef, unordered_set<LLVMValueRef>> gen;
+    unordered_map<LLVMBasicBlockRef, unordered_set<LLVMValueRef>> killed_addrs;
+    unordered_map<LLVMBasicBlockRef, unordered_set<LLVMValueRef>> in;
+    unordered_map<LLVMBasicBlockRef, unordered_set<LLVMValueRef>> out;
+    unordered_map<LLVMBasicBlockRef, vector<LLVMBasicBlockRef>> preds;
+
+    compute_predecessors(function, preds);
+
+    // step 1: GEN[B] holds the last store to each slot in B,
+    // and every slot B writes to kills stores from elsewhere
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+
+        unordered_map<LLVMValueRef, LLVMValueRef> last_store;
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+             inst != NULL;
+             inst = LLVMGetNextInstruction(inst)) {
+            if (LLVMIsAStoreInst(inst) && is_promotable_alloca(get_store_address(inst))) {
+                last_store[get_store_address(inst)] = inst;
+            }
+        }
+
+        for (auto &pair : last_store) {
+            gen[bb].insert(pair.second);
+            killed_addrs[bb].insert(pair.first);
+        }
+        in[bb];
+        out[bb] = gen[bb];
+    }
+
+    // step 2: iterate IN[B] = union OUT[P], OUT[B] = GEN[B] + (IN[B] - KILL[B])
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+             bb != NULL;
+             bb = LLVMGetNextBasicBlock(bb)) {
+
+            unordered_set<LLVMValueRef> new_in;
+            for (LLVMBasicBlockRef pred : preds[bb]) {
+                new_in.insert(out[pred].begin(), out[pred].end());
+            }
+
+            unordered_set<LLVMValueRef> new_out = gen[bb];
+            for (LLVMValueRef store : new_in) {
+                if (killed_addrs[bb].find(get_store_address(store)) == killed_addrs[bb].end()) {
+                    new_out.insert(store);
+                }
+            }
+
+            if (new_out.size() != out[bb].size()) {
+                changed = true;
+            }
+            in[bb] = new_in;
+            out[bb] = new_out;
+        }
+    }
+
+    // step 3: walk each block, tracking the latest local store per slot
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+
+        unordered_map<LLVMValueRef, LLVMValueRef> local_store;
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+             inst != NULL;
+             inst = LLVMGetNextInstruction(inst)) {
+
+            if (LLVMIsAStoreInst(inst) && is_promotable_alloca(get_store_address(inst))) {
+                local_store[get_store_address(inst)] = inst;
+                continue;
+            }
+
+            if (!LLVMIsALoadInst(inst)) {
+                continue;
+            }
+            LLVMValueRef addr = get_load_address(inst);
+            if (!is_promotable_alloca(addr)) {
+                continue;
+            }
+
+            unordered_set<LLVMValueRef> &stores = reaching[inst];
+            auto local = local_store.find(addr);
+            if (local != local_store.end()) {
+                stores.insert(local->second);
+            } else {
+                for (LLVMValueRef store : in[bb]) {
+                    if (get_store_address(store) == addr) {
+                        stores.insert(store);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// ============================================================================
+// CONSTANT EVALUATION HELPERS
+// ============================================================================
+// integer constants are carried around as long long, sign-extended from
+// their bit width, so i1 true is -1 and i32 -1 is -1
+
+// integer width of a value, or 0 if it isn't a (<= 64 bit) integer
+unsigned int_width(LLVMValueRef value) {
+    LLVMTypeRef type = LLVMTypeOf(value);
+    if (LLVMGetTypeKind(type) != LLVMIntegerTypeKind) {
+        return 0;
+    }
+    unsigned width = LLVMGetIntTypeWidth(type);
+    return width <= 64 ? width : 0;
+}
+
+// sign-extend the low `width` bits of value
+long long normalize_int(long long value, unsigned width) {
+    if (width >= 64) {
+        return value;
+    }
+    unsigned long long mask = (1ULL << width) - 1;
+    unsigned long long bits = (unsigned long long)value & mask;
+    unsigned long long sign = 1ULL << (width - 1);
+    return (long long)((bits ^ sign) - sign);
+}
+
+// the low `width` bits of value, zero-extended
+static unsigned long long zext_int(long long value, unsigned width) {
+    if (width >= 64) {
+        return (unsigned long long)value;
+    }
+    return (unsigned long long)value & ((1ULL << width) - 1);
+}
+
+// evaluate a binary integer instruction on constants
+// returns false when the result isn't a well defined constant
+// (division by zero, INT_MIN / -1, oversized shifts)
+bool evaluate_int_binary(LLVMOpcode opcode, long long lhs, long long rhs,
+                         unsigned width, long long *result) {
+    unsigned long long ul = zext_int(lhs, width);
+    unsigned long long ur = zext_int(rhs, width);
+    long long min_value = normalize_int(1ULL << (width - 1), width);
+    long long value;
+
+    switch (opcode) {
+        case LLVMAdd:
+            value = (long long)(ul + ur);
+            break;
+        case LLVMSub:
+            value = (long long)(ul - ur);
+            break;
+        case LLVMMul:
+            value = (long long)(ul * ur);
+            break;
+        case LLVMSDiv:
+            if (rhs == 0 || (lhs == min_value && rhs == -1)) {
+                return false;
+            }
+            value = lhs / rhs;
+            break;
+        case LLVMSRem:
+            if (rhs == 0 || (lhs == min_value && rhs == -1)) {
+                return false;
+            }
+            value = lhs % rhs;
+            break;
+        case LLVMUDiv:
+            if (ur == 0) {
+                return false;
+            }
+            value = (long long)(ul / ur);
+            break;
+        case LLVMURem:
+            if (ur == 0) {
+                return false;
+            }
+            value = (long long)(ul % ur);
+            break;
+        case LLVMShl:
+            if (ur >= width) {
+                return false;
+            }
+            value = (long long)(ul << ur);
+            break;
+        case LLVMLShr:
+            if (ur >= width) {
+                return false;
+            }
+            value = (long long)(ul >> ur);
+            break;
+        case LLVMAShr:
+            if (ur >= width) {
+                return false;
+            }
+            value = lhs >> ur;
+            break;
+        case LLVMAnd:
+            value = lhs & rhs;
+            break;
+        case LLVMOr:
+            value = lhs | rhs;
+            break;
+        case LLVMXor:
+            value = lhs ^ rhs;
+            break;
+        default:
+            return false;
+    }
+
+    *result = normalize_int(value, width);
+    return true;
+}
+
+// evaluate an icmp on constants, returns the i1 result as true/false
+bool evaluate_int_compare(LLVMIntPredicate predicate, long long lhs, long long rhs,
+                          unsigned width) {
+    unsigned long long ul = zext_int(lhs, width);
+    unsigned long long ur = zext_int(rhs, width);
+
+    switch (predicate) {
+        case LLVMIntEQ:  return lhs == rhs;
+        case LLVMIntNE:  return lhs != rhs;
+        case LLVMIntSLT: return lhs < rhs;
+        case LLVMIntSLE: return lhs <= rhs;
+        case LLVMIntSGT: return lhs > rhs;
+        case LLVMIntSGE: return lhs >= rhs;
+        case LLVMIntULT: return ul < ur;
+        case LLVMIntULE: return ul <= ur;
+        case LLVMIntUGT: return ul > ur;
+        case LLVMIntUGE: return ul >= ur;
+    }
+    return false;
+}
+
+// ============================================================================
+// DIVISION TRAP HELPERS
+// ============================================================================
+// sdiv/srem trap on x / 0 and INT_MIN / -1, so they may only run on a path
+// that would have run them anyway, unless one of these says they can't trap
+
+// check if an sdiv/srem divides by a constant other than 0 and -1
+bool is_safe_constant_divisor(LLVMValueRef inst) {
+    LLVMValueRef divisor = LLVMGetOperand(inst, 1);
+    if (!LLVMIsAConstantInt(divisor)) {
+        return false;
+    }
+    long long d = LLVMConstIntGetSExtValue(divisor);
+    return d != 0 && d != -1;
+}
+
+static unsigned non_trapping_kind(LLVMValueRef inst) {
+    static const char name[] = "minic.nontrapping";
+    return LLVMGetMDKindIDInContext(LLVMGetTypeContext(LLVMTypeOf(inst)), name, sizeof(name) - 1);
+}
+
+// check if value range analysis marked an sdiv/srem as unable to trap
+bool has_non_trapping_mark(LLVMValueRef inst) {
+    return LLVMGetMetadata(inst, non_trapping_kind(inst)) != NULL;
+}
+
+// add or remove the mark, returns true if that changed anything
+bool set_non_trapping_mark(LLVMValueRef inst, bool marked) {
+    if (has_non_trapping_mark(inst) == marked) {
+        return false;
+    }
+    LLVMValueRef node = NULL;
+    if (marked) {
+        LLVMContextRef context = LLVMGetTypeContext(LLVMTypeOf(inst));
+        node = LLVMMetadataAsValue(context, LLVMMDNodeInContext2(context, NULL, 0));
+    }
+    LLVMSetMetadata(inst, non_trapping_kind(inst), node);
+    return true;
+}
+
+// ============================================================================
+// HELPER FUNCTION: compute_dominators
+// ============================================================================
+// iterative dominator sets: DOM[entry] = {entry},
+// DOM[B] = {B} + intersection of DOM[P] over the predecessors P of B
+void compute_dominators(LLVMValueRef function,
+                        unordered_map<LLVMBasicBlockRef, unordered_set<LLVMBasicBlockRef>> &dom) {
+    dom.clear();
+
+    unordered_map<LLVMBasicBlockRef, vector<LLVMBasicBlockRef>> preds;
+    compute_predecessors(function, preds);
+
+    LLVMBasicBlockRef entry = LLVMGetFirstBasicBlock(function);
+
+    // step 1: entry dominates itself, everything else starts with all blocks
+    unordered_set<LLVMBasicBlockRef> all_blocks;
+    for (LLVMBasicBlockRef bb = entry; bb != NULL; bb = LLVMGetNextBasicBlock(bb)) {
+        all_blocks.insert(bb);
+    }
+    for (LLVMBasicBlockRef bb = entry; bb != NULL; bb = LLVMGetNextBasicBlock(bb)) {
+        if (bb == entry) {
+            dom[bb].insert(entry);
+        } else {
+            dom[bb] = all_blocks;
+        }
+    }
+
+    // step 2: shrink the sets until they stop changing
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (LLVMBasicBlockRef bb = LLVMGetNextBasicBlock(entry);
+             bb != NULL;
+             bb = LLVMGetNextBasicBlock(bb)) {
+
+            unordered_set<LLVMBasicBlockRef> new_dom;
+            bool first = true;
+            for (LLVMBasicBlockRef pred : preds[bb]) {
+                if (first) {
+                    new_dom = dom[pred];
+                    first = false;
+                    continue;
+                }
+                unordered_set<LLVMBasicBlockRef> both;
+                for (LLVMBasicBlockRef d : new_dom) {
+                    if (dom[pred].count(d)) {
+                        both.insert(d);
+                    }
+                }
+                new_dom = both;
+            }
+            new_dom.insert(bb);
+
+            if (new_dom.size() != dom[bb].size()) {
+                dom[bb] = new_dom;
+                changed = true;
+            }
+        }
+    }
+}
@@ -0,0 +1,17 @@
+extern void print(int);
+extern int read();
+
+int func(int n){
+	int i;
+	int t;
+	int c;
+	i = 0;
+	c = 0;
+	while (i < n){
+		t = i * 12 + 7;
+		if (t % 5 == 0)
+			c = c + 1;
+		i = i + 1;
+	}
+	return c;
+}
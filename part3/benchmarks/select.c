@@ -0,0 +1,27 @@
+extern void print(int);
+extern int read();
+
+int func(int n){
+	int i;
+	int x;
+	int s;
+	int m;
+
+	i = 0;
+	s = 0;
+	m = 0;
+	while (i < n){
+		x = read();
+		if (x > 50)
+			s = s + x;
+		else
+			s = s - x;
+		if (x > m)
+			m = x;
+		if (x < 0)
+			print(x);
+		i = i + 1;
+	}
+	print(m);
+	return s;
+}
@@ -0,0 +1,97 @@
+; ModuleID = 'select.c'
+source_filename = "select.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-pc-linux-gnu"
+
+; Function Attrs: noinline nounwind optnone uwtable
+define dso_local i32 @func(i32 noundef %0) #0 {
+  %2 = alloca i32, align 4
+  %3 = alloca i32, align 4
+  %4 = alloca i32, align 4
+  %5 = alloca i32, align 4
+  %6 = alloca i32, align 4
+  store i32 %0, ptr %2, align 4
+  store i32 0, ptr %3, align 4
+  store i32 0, ptr %5, align 4
+  store i32 0, ptr %6, align 4
+  br label %7
+
+7:                                                ; preds = %34, %1
+  %8 = load i32, ptr %3, align 4
+  %9 = load i32, ptr %2, align 4
+  %10 = icmp slt i32 %8, %9
+  br i1 %10, label %11, label %37
+
+11:                                               ; preds = %7
+  %12 = call i32 (...) @read()
+  store i32 %12, ptr %4, align 4
+  %13 = load i32, ptr %4, align 4
+  %14 = icmp sgt i32 %13, 50
+  br i1 %14, label %15, label %19
+
+15:                                               ; preds = %11
+  %16 = load i32, ptr %5, align 4
+  %17 = load i32, ptr %4, align 4
+  %18 = add nsw i32 %16, %17
+  store i32 %18, ptr %5, align 4
+  br label %23
+
+19:                                               ; preds = %11
+  %20 = load i32, ptr %5, align 4
+  %21 = load i32, ptr %4, align 4
+  %22 = sub nsw i32 %20, %21
+  store i32 %22, ptr %5, align 4
+  br label %23
+
+23:                                               ; preds = %19, %15
+  %24 = load i32, ptr %4, align 4
+  %25 = load i32, ptr %6, align 4
+  %26 = icmp sgt i32 %24, %25
+  br i1 %26, label %27, label %29
+
+27:                                               ; preds = %23
+  %28 = load i32, ptr %4, align 4
+  store i32 %28, ptr %6, align 4
+  br label %29
+
+29:                                               ; preds = %27, %23
+  %30 = load i32, ptr %4, align 4
+  %31 = icmp slt i32 %30, 0
+  br i1 %31, label %32, label %34
+
+32:                                               ; preds = %29
+  %33 = load i32, ptr %4, align 4
+  call void @print(i32 noundef %33)
+  br label %34
+
+34:                                               ; preds = %32, %29
+  %35 = load i32, ptr %3, align 4
+  %36 = add nsw i32 %35, 1
+  store i32 %36, ptr %3, align 4
+  br label %7, !llvm.loop !6
+
+37:                                               ; preds = %7
+  %38 = load i32, ptr %6, align 4
+  call void @print(i32 noundef %38)
+  %39 = load i32, ptr %5, align 4
+  ret i32 %39
+}
+
+declare i32 @read(...) #1
+
+declare void @print(i32 noundef) #1
+
+attributes #0 = { noinline nounwind optnone uwtable "frame-pointer"="all" "min-legal-vector-width"="0" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+attributes #1 = { "frame-pointer"="all" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+
+!llvm.module.flags = !{!0, !1, !2, !3, !4}
+!llvm.ident = !{!5}
+
+!0 = !{i32 1, !"wchar_size", i32 4}
+!1 = !{i32 7, !"PIC Level", i32 2}
+!2 = !{i32 7, !"PIE Level", i32 2}
+!3 = !{i32 7, !"uwtable", i32 2}
+!4 = !{i32 7, !"frame-pointer", i32 2}
+!5 = !{!"Ubuntu clang version 15.0.7"}
+!6 = distinct !{!6, !7}
+!7 = !{!"llvm.loop.mustprogress"}
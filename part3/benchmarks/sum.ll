@@ -0,0 +1,49 @@
+; ModuleID = 'sum.c'
+source_filename = "sum.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-pc-linux-gnu"
+
+; Function Attrs: noinline nounwind optnone uwtable
+define dso_local i32 @func(i32 noundef %0) #0 {
+  %2 = alloca i32, align 4
+  %3 = alloca i32, align 4
+  %4 = alloca i32, align 4
+  store i32 %0, ptr %2, align 4
+  store i32 0, ptr %3, align 4
+  store i32 0, ptr %4, align 4
+  br label %5
+
+5:                                                ; preds = %9, %1
+  %6 = load i32, ptr %3, align 4
+  %7 = load i32, ptr %2, align 4
+  %8 = icmp slt i32 %6, %7
+  br i1 %8, label %9, label %15
+
+9:                                                ; preds = %5
+  %10 = load i32, ptr %4, align 4
+  %11 = load i32, ptr %3, align 4
+  %12 = add nsw i32 %10, %11
+  store i32 %12, ptr %4, align 4
+  %13 = load i32, ptr %3, align 4
+  %14 = add nsw i32 %13, 1
+  store i32 %14, ptr %3, align 4
+  br label %5, !llvm.loop !6
+
+15:                                               ; preds = %5
+  %16 = load i32, ptr %4, align 4
+  ret i32 %16
+}
+
+attributes #0 = { noinline nounwind optnone uwtable "frame-pointer"="all" "min-legal-vector-width"="0" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+
+!llvm.module.flags = !{!0, !1, !2, !3, !4}
+!llvm.ident = !{!5}
+
+!0 = !{i32 1, !"wchar_size", i32 4}
+!1 = !{i32 7, !"PIC Level", i32 2}
+!2 = !{i32 7, !"PIE Level", i32 2}
+!3 = !{i32 7, !"uwtable", i32 2}
+!4 = !{i32 7, !"frame-pointer", i32 2}
+!5 = !{!"Ubuntu clang version 15.0.7"}
+!6 = distinct !{!6, !7}
+!7 = !{!"llvm.loop.mustprogress"}
@@ -0,0 +1,220 @@
+#include "optimizer.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+// ============================================================================
+// CFG SIMPLIFICATION
+// ============================================================================
+// cleans up the control flow graph in four steps, repeated until nothing
+// changes:
+//   1. br i1 true/false (or with both targets equal) -> unconditional br
+//   2. empty forwarding blocks (just `br label %S`) are threaded: their
+//      predecessors jump straight to S
+//   3. blocks unreachable from the entry block are deleted
+//   4. a block with a single predecessor, whose predecessor has it as its
+//      single successor, is merged into that predecessor
+
+// step 1: fold conditional branches whose outcome is already known
+static bool fold_constant_branches(LLVMValueRef function) {
+    bool changed = false;
+
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+
+        LLVMValueRef term = LLVMGetBasicBlockTerminator(bb);
+        if (term == NULL || !LLVMIsABranchInst(term) || !LLVMIsConditional(term)) {
+            continue;
+        }
+
+        LLVMValueRef cond = LLVMGetCondition(term);
+        LLVMBasicBlockRef true_bb = LLVMGetSuccessor(term, 0);
+        LLVMBasicBlockRef false_bb = LLVMGetSuccessor(term, 1);
+
+        if (true_bb == false_bb) {
+            // both arms go to the same place, the condition doesn't matter
+            make_branch_unconditional(term, true_bb);
+            changed = true;
+        } else if (LLVMIsAConstantInt(cond)) {
+            // successor 0 is taken when the condition is true
+            make_branch_unconditional(term, LLVMConstIntGetZExtValue(cond) ? true_bb : false_bb);
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+// step 2: predecessors of `B: br label %S` branch to S directly
+static bool thread_forwarding_blocks(LLVMValueRef function) {
+    bool changed = false;
+
+    unordered_map<LLVMBasicBlockRef, vector<LLVMBasicBlockRef>> preds;
+    compute_predecessors(function, preds);
+
+    LLVMBasicBlockRef entry = LLVMGetFirstBasicBlock(function);
+
+    for (LLVMBasicBlockRef bb = LLVMGetNextBasicBlock(entry);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+
+        // the block must hold nothing but an unconditional branch
+        LLVMValueRef term = LLVMGetFirstInstruction(bb);
+        if (term == NULL || term != LLVMGetBasicBlockTerminator(bb) ||
+            !LLVMIsABranchInst(term) || LLVMIsConditional(term)) {
+            continue;
+        }
+
+        LLVMBasicBlockRef succ = LLVMGetSuccessor(term, 0);
+        if (succ == bb) {
+            continue; // empty infinite loop
+        }
+
+        bool succ_has_phis = LLVMGetFirstInstruction(succ) != NULL &&
+                             LLVMIsAPHINode(LLVMGetFirstInstruction(succ));
+
+        for (LLVMBasicBlockRef pred : preds[bb]) {
+            // if pred already reaches succ, succ's phis would need two
+            // different values for the same predecessor
+            if (succ_has_phis) {
+                bool already_pred = false;
+                for (LLVMBasicBlockRef p : preds[succ]) {
+                    if (p == pred) {
+                        already_pred = true;
+                    }
+                }
+                if (already_pred) {
+                    continue;
+                }
+            }
+
+            LLVMValueRef pred_term = LLVMGetBasicBlockTerminator(pred);
+            unsigned num_succs = LLVMGetNumSuccessors(pred_term);
+            for (unsigned i = 0; i < num_succs; i++) {
+                if (LLVMGetSuccessor(pred_term, i) != bb) {
+                    continue;
+                }
+
+                LLVMSetSuccessor(pred_term, i, succ);
+
+                // succ's phis see pred where they used to see bb
+                for (LLVMValueRef phi = LLVMGetFirstInstruction(succ);
+                     phi != NULL && LLVMIsAPHINode(phi);
+                     phi = LLVMGetNextInstruction(phi)) {
+                    unsigned count = LLVMCountIncoming(phi);
+                    for (unsigned k = 0; k < count; k++) {
+                        if (LLVMGetIncomingBlock(phi, k) == bb) {
+                            LLVMValueRef value = LLVMGetIncomingValue(phi, k);
+                            LLVMAddIncoming(phi, &value, &pred, 1);
+                            break;
+                        }
+                    }
+                }
+            }
+
+            preds[succ].push_back(pred);
+            changed = true;
+        }
+        // bb is left without predecessors (unless some were skipped)
+        // and is removed as unreachable
+    }
+
+    return changed;
+}
+
+// step 4: merge straight-line chains pred -> bb into one block
+static bool merge_blocks(LLVMValueRef function) {
+    bool changed = false;
+
+    unordered_map<LLVMBasicBlockRef, vector<LLVMBasicBlockRef>> preds;
+    compute_predecessors(function, preds);
+
+    LLVMBuilderRef builder = LLVMCreateBuilder();
+    LLVMBasicBlockRef entry = LLVMGetFirstBasicBlock(function);
+
+    LLVMBasicBlockRef bb = LLVMGetNextBasicBlock(entry);
+    while (bb != NULL) {
+        LLVMBasicBlockRef next_bb = LLVMGetNextBasicBlock(bb);
+
+        if (preds[bb].size() != 1) {
+            bb = next_bb;
+            continue;
+        }
+        LLVMBasicBlockRef pred = preds[bb][0];
+        LLVMValueRef pred_term = LLVMGetBasicBlockTerminator(pred);
+        if (pred == bb || LLVMGetNumSuccessors(pred_term) != 1) {
+            bb = next_bb;
+            continue;
+        }
+
+        // phis with a single predecessor just forward their one value
+        LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+        while (inst != NULL && LLVMIsAPHINode(inst)) {
+            LLVMValueRef next_inst = LLVMGetNextInstruction(inst);
+            LLVMReplaceAllUsesWith(inst, LLVMGetIncomingValue(inst, 0));
+            LLVMInstructionEraseFromParent(inst);
+            inst = next_inst;
+        }
+
+        // move the rest of bb to the end of pred, replacing pred's branch
+        LLVMInstructionEraseFromParent(pred_term);
+        LLVMPositionBuilderAtEnd(builder, pred);
+        while (inst != NULL) {
+            LLVMValueRef next_inst = LLVMGetNextInstruction(inst);
+            LLVMInstructionRemoveFromParent(inst);
+            LLVMInsertIntoBuilder(builder, inst);
+            inst = next_inst;
+        }
+
+        // bb's successors are now reached from pred
+        LLVMValueRef term = LLVMGetBasicBlockTerminator(pred);
+        unsigned num_succs = LLVMGetNumSuccessors(term);
+        for (unsigned i = 0; i < num_succs; i++) {
+            LLVMBasicBlockRef succ = LLVMGetSuccessor(term, i);
+            replace_phi_incoming_block(succ, bb, pred);
+
+            vector<LLVMBasicBlockRef> &list = preds[succ];
+            for (size_t k = 0; k < list.size(); k++) {
+                if (list[k] == bb) {
+                    list[k] = pred;
+                }
+            }
+        }
+
+        LLVMDeleteBasicBlock(bb);
+        changed = true;
+
+        bb = next_bb;
+    }
+
+    LLVMDisposeBuilder(builder);
+    return changed;
+}
+
+bool cfg_simplification(LLVMModuleRef module) {
+    bool changed = false;
+
+    // iterate through all functions
+    for (LLVMValueRef function = LLVMGetFirstFunction(module);
+         function != NULL;
+         function = LLVMGetNextFunction(function)) {
+
+        if (LLVMGetFirstBasicBlock(function) == NULL) {
+            continue; // declaration (print, read)
+        }
+
+        bool local_changed = true;
+        while (local_changed) {
+            local_changed = false;
+            local_changed |= fold_constant_branches(function);
+            local_changed |= thread_forwarding_blocks(function);
+            local_changed |= remove_unreachable_blocks(function);
+            local_changed |= merge_blocks(function);
+            changed |= local_changed;
+        }
+    }
+
+    return changed;
+}
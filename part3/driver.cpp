@@ -2,11 +2,30 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+static void print_usage(const char *program) {
+    fprintf(stderr, "usage: %s [options] <input.ll>\n", program);
+    fprintf(stderr, "example: %s optimizer_test_results/cfold_add.ll\n", program);
+    fprintf(stderr, "options:\n");
+    print_pipeline_options();
+}
+
 int main(int argc, char **argv) {
     // check command line arguments
-    if (argc != 2) {
-        fprintf(stderr, "usage: %s <input.ll>\n", argv[0]);
-        fprintf(stderr, "example: %s optimizer_test_results/cfold_add.ll\n", argv[0]);
+    const char *input_file = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (parse_pipeline_option(argc, argv, &i)) {
+            continue;
+        }
+        if (argv[i][0] == '-' || input_file != NULL) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        input_file = argv[i];
+    }
+
+    if (input_file == NULL) {
+        print_usage(argv[0]);
         return 1;
     }
     
@@ -18,8 +37,8 @@ int main(int argc, char **argv) {
     char *error_msg = NULL;
     
     // create memory buffer from file
-    if (LLVMCreateMemoryBufferWithContentsOfFile(argv[1], &buffer, &error_msg)) {
-        fprintf(stderr, "error loading file '%s': %s\n", argv[1], error_msg);
+    if (LLVMCreateMemoryBufferWithContentsOfFile(input_file, &buffer, &error_msg)) {
+        fprintf(stderr, "error loading file '%s': %s\n", input_file, error_msg);
         LLVMDisposeMessage(error_msg);
         return 1;
     }
@@ -39,36 +58,11 @@ int main(int argc, char **argv) {
     // ========================================================================
     // STEP 3: run optimizations in a loop until fixed point
     // ========================================================================
-    // we keep running optimizations until nothing changes
-    
-    bool changed = true;
-    int iteration = 0;
-    
-    while (changed) {
-        changed = false;
-        iteration++;
-        
-        // run dead code elimination
-        // removes instructions with no uses
-        bool dce_changed = dead_code_elimination(module);
-        changed |= dce_changed;
-        
-        // run constant folding
-        // pre-computes arithmetic on constants
-        bool cf_changed = constant_folding(module);
-        changed |= cf_changed;
-        
-        // run common subexpression elimination
-        // removes duplicate calculations
-        bool cse_changed = common_subexpression_elimination(module);
-        changed |= cse_changed;
-        
-        // run constant propagation (when implemented)
-        // tracks constants through store/load instructions
-        bool cp_changed = constant_propagation(module);
-        changed |= cp_changed;
+
+    if (!optimize_module(module)) {
+        return 1;
     }
-    
+
     // ========================================================================
     // STEP 4: output the optimized IR to stdout
     // ========================================================================
@@ -0,0 +1,189 @@
+#include "optimizer.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+// ============================================================================
+// DEAD STORE ELIMINATION
+// ============================================================================
+// a store to a promotable alloca is dead if no load can observe it: on
+// every path from the store the slot is written again, or the function
+// returns, before it is read. found with backwards liveness of slots:
+//   LIVE_OUT[B] = union LIVE_IN[S] over successors S
+//   LIVE_IN[B]  = USE[B] + (LIVE_OUT[B] - DEF[B])
+// where USE[B] are the slots B loads before storing to them and DEF[B] the
+// slots it stores to. a slot is dead once the function returns, it is a
+// local variable.
+//
+// afterwards allocas whose only users are stores are deleted along with
+// their stores, nothing can ever read them
+
+// compute LIVE_OUT for every block of the function
+static void compute_live_slots(LLVMValueRef function,
+                               unordered_map<LLVMBasicBlockRef, unordered_set<LLVMValueRef>> &live_out) {
+    unordered_map<LLVMBasicBlockRef, unordered_set<LLVMValueRef>> use;
+    unordered_map<LLVMBasicBlockRef, unordered_set<LLVMValueRef>> def;
+    unordered_map<LLVMBasicBlockRef, unordered_set<LLVMValueRef>> live_in;
+    vector<LLVMBasicBlockRef> blocks;
+
+    // step 1: USE and DEF of every block, walking it forwards
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+
+        blocks.push_back(bb);
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+             inst != NULL;
+             inst = LLVMGetNextInstruction(inst)) {
+
+            if (LLVMIsALoadInst(inst)) {
+                LLVMValueRef slot = get_load_address(inst);
+                if (is_promotable_alloca(slot) && !def[bb].count(slot)) {
+                    use[bb].insert(slot);
+                }
+            } else if (LLVMIsAStoreInst(inst)) {
+                LLVMValueRef slot = get_store_address(inst);
+                if (is_promotable_alloca(slot)) {
+                    def[bb].insert(slot);
+                }
+            }
+        }
+        live_in[bb] = use[bb];
+        live_out[bb];
+    }
+
+    // step 2: iterate to a fixed point, last block first since liveness
+    // flows backwards
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (auto it = blocks.rbegin(); it != blocks.rend(); ++it) {
+            LLVMBasicBlockRef bb = *it;
+
+            unordered_set<LLVMValueRef> new_out;
+            LLVMValueRef term = LLVMGetBasicBlockTerminator(bb);
+            unsigned num_succs = term != NULL ? LLVMGetNumSuccessors(term) : 0;
+            for (unsigned i = 0; i < num_succs; i++) {
+                unordered_set<LLVMValueRef> &succ_in = live_in[LLVMGetSuccessor(term, i)];
+                new_out.insert(succ_in.begin(), succ_in.end());
+            }
+
+            unordered_set<LLVMValueRef> new_in = use[bb];
+            for (LLVMValueRef slot : new_out) {
+                if (!def[bb].count(slot)) {
+                    new_in.insert(slot);
+                }
+            }
+
+            // the sets only ever grow, comparing sizes is enough
+            if (new_in.size() != live_in[bb].size() || new_out.size() != live_out[bb].size()) {
+                changed = true;
+            }
+            live_in[bb] = new_in;
+            live_out[bb] = new_out;
+        }
+    }
+}
+
+// delete stores that no load can observe
+static bool remove_dead_stores(LLVMValueRef function) {
+    unordered_map<LLVMBasicBlockRef, unordered_set<LLVMValueRef>> live_out;
+    compute_live_slots(function, live_out);
+
+    vector<LLVMValueRef> dead;
+
+    // walk each block backwards from LIVE_OUT: a load makes its slot live,
+    // a store kills it, and a store to a slot that isn't live is dead
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+
+        unordered_set<LLVMValueRef> live = live_out[bb];
+        for (LLVMValueRef inst = LLVMGetLastInstruction(bb);
+             inst != NULL;
+             inst = LLVMGetPreviousInstruction(inst)) {
+
+            if (LLVMIsALoadInst(inst)) {
+                live.insert(get_load_address(inst));
+            } else if (LLVMIsAStoreInst(inst)) {
+                LLVMValueRef slot = get_store_address(inst);
+                if (!is_promotable_alloca(slot)) {
+                    continue;
+                }
+                if (!live.count(slot)) {
+                    dead.push_back(inst);
+                }
+                live.erase(slot);
+            }
+        }
+    }
+
+    for (LLVMValueRef store : dead) {
+        LLVMInstructionEraseFromParent(store);
+    }
+
+    return !dead.empty();
+}
+
+// delete allocas that are only ever stored to, and their stores
+static bool remove_write_only_allocas(LLVMValueRef function) {
+    vector<LLVMValueRef> write_only;
+
+    // miniC allocas all live in the entry block
+    for (LLVMValueRef inst = LLVMGetFirstInstruction(LLVMGetFirstBasicBlock(function));
+         inst != NULL;
+         inst = LLVMGetNextInstruction(inst)) {
+
+        if (!LLVMIsAAllocaInst(inst) || !is_promotable_alloca(inst)) {
+            continue;
+        }
+
+        bool only_stores = true;
+        for (LLVMUseRef use = LLVMGetFirstUse(inst);
+             use != NULL;
+             use = LLVMGetNextUse(use)) {
+            if (!LLVMIsAStoreInst(LLVMGetUser(use))) {
+                only_stores = false;
+                break;
+            }
+        }
+        if (only_stores) {
+            write_only.push_back(inst);
+        }
+    }
+
+    for (LLVMValueRef alloca : write_only) {
+        // erasing a store removes it from the use list, so always take
+        // the first remaining use
+        while (LLVMGetFirstUse(alloca) != NULL) {
+            LLVMInstructionEraseFromParent(LLVMGetUser(LLVMGetFirstUse(alloca)));
+        }
+        LLVMInstructionEraseFromParent(alloca);
+    }
+
+    return !write_only.empty();
+}
+
+// ============================================================================
+// MAIN PASS: dead_store_elimination
+// ============================================================================
+bool dead_store_elimination(LLVMModuleRef module) {
+    bool changed = false;
+
+    // iterate through all functions
+    for (LLVMValueRef function = LLVMGetFirstFunction(module);
+         function != NULL;
+         function = LLVMGetNextFunction(function)) {
+
+        if (LLVMGetFirstBasicBlock(function) == NULL) {
+            continue;
+        }
+
+        changed |= remove_dead_stores(function);
+        changed |= remove_write_only_allocas(function);
+    }
+
+    return changed;
+}
@@ -0,0 +1,376 @@
+#include "optimizer.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+// ============================================================================
+// STORE-TO-LOAD FORWARDING
+// ============================================================================
+// replaces loads from promotable allocas with the value the slot is known
+// to hold, across block boundaries:
+//   1. a slot is AVAILABLE at the start of a block if on every path to it
+//      the slot was stored to or loaded from (the value is in a register).
+//      must-analysis: AVAIL_IN[B] = intersection of AVAIL_OUT[P], and
+//      AVAIL_OUT[B] = AVAIL_IN[B] + slots B touches (nothing kills a slot,
+//      only its own loads and stores can reach it)
+//   2. walking each block, a load is replaced by the last value stored to
+//      or loaded from its slot in the block, or, if there is none and the
+//      slot is available on entry, by the value every predecessor ends
+//      with. predecessors that end with different values get a phi at
+//      the top of the block, so only joins that actually feed a removed
+//      load get one
+//   3. phis that turn out to merge a single value (loops that never change
+//      the slot) are removed again
+//
+// stores stay, --dse deletes the ones nobody loads anymore
+
+struct forwarding_state {
+    unordered_map<LLVMBasicBlockRef, vector<LLVMBasicBlockRef>> preds;
+    unordered_map<LLVMBasicBlockRef, unordered_set<LLVMValueRef>> avail_in;
+    unordered_set<LLVMBasicBlockRef> reachable;
+
+    // value of each slot at the start / end of a block, once known
+    unordered_map<LLVMBasicBlockRef, unordered_map<LLVMValueRef, LLVMValueRef>> entry_value;
+    unordered_map<LLVMBasicBlockRef, unordered_map<LLVMValueRef, LLVMValueRef>> exit_value;
+
+    unordered_map<LLVMValueRef, LLVMValueRef> replaced;   // load -> its value
+    vector<LLVMValueRef> new_phis;
+};
+
+// ============================================================================
+// HELPER FUNCTION: is_forwardable_slot
+// ============================================================================
+// a slot we can forward: a promotable alloca that is only ever loaded and
+// stored with its own (integer) type
+bool is_forwardable_slot(LLVMValueRef slot) {
+    if (!is_promotable_alloca(slot)) {
+        return false;
+    }
+    LLVMTypeRef type = LLVMGetAllocatedType(slot);
+    if (LLVMGetTypeKind(type) != LLVMIntegerTypeKind) {
+        return false;
+    }
+
+    for (LLVMUseRef use = LLVMGetFirstUse(slot);
+         use != NULL;
+         use = LLVMGetNextUse(use)) {
+        LLVMValueRef user = LLVMGetUser(use);
+        LLVMTypeRef accessed = LLVMIsALoadInst(user) ? LLVMTypeOf(user)
+                                                     : LLVMTypeOf(LLVMGetOperand(user, 0));
+        if (accessed != type) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// the slot a load or store accesses, if it is forwardable
+static LLVMValueRef accessed_slot(LLVMValueRef inst,
+                                  const unordered_set<LLVMValueRef> &slots) {
+    LLVMValueRef addr = NULL;
+    if (LLVMIsALoadInst(inst)) {
+        addr = get_load_address(inst);
+    } else if (LLVMIsAStoreInst(inst)) {
+        addr = get_store_address(inst);
+    }
+    return addr != NULL && slots.count(addr) ? addr : NULL;
+}
+
+// follow load replacements to the value that survives
+static LLVMValueRef resolve(forwarding_state &st, LLVMValueRef value) {
+    auto it = st.replaced.find(value);
+    while (it != st.replaced.end()) {
+        value = it->second;
+        it = st.replaced.find(value);
+    }
+    return value;
+}
+
+// step 1: AVAIL_IN for every block, and which blocks are reachable
+static void compute_available_slots(LLVMValueRef function,
+                                    const unordered_set<LLVMValueRef> &slots,
+                                    forwarding_state &st) {
+    LLVMBasicBlockRef entry = LLVMGetFirstBasicBlock(function);
+
+    vector<LLVMBasicBlockRef> worklist;
+    worklist.push_back(entry);
+    st.reachable.insert(entry);
+    while (!worklist.empty()) {
+        LLVMBasicBlockRef bb = worklist.back();
+        worklist.pop_back();
+        LLVMValueRef term = LLVMGetBasicBlockTerminator(bb);
+        unsigned num_succs = term != NULL ? LLVMGetNumSuccessors(term) : 0;
+        for (unsigned i = 0; i < num_succs; i++) {
+            LLVMBasicBlockRef succ = LLVMGetSuccessor(term, i);
+            if (st.reachable.insert(succ).second) {
+                worklist.push_back(succ);
+            }
+        }
+    }
+
+    // slots touched in each block
+    unordered_map<LLVMBasicBlockRef, unordered_set<LLVMValueRef>> touched;
+    for (LLVMBasicBlockRef bb = entry; bb != NULL; bb = LLVMGetNextBasicBlock(bb)) {
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+             inst != NULL;
+             inst = LLVMGetNextInstruction(inst)) {
+            LLVMValueRef slot = accessed_slot(inst, slots);
+            if (slot != NULL) {
+                touched[bb].insert(slot);
+            }
+        }
+    }
+
+    // start from "everything" except at the entry and shrink; unreachable
+    // predecessors don't constrain a block
+    unordered_map<LLVMBasicBlockRef, unordered_set<LLVMValueRef>> avail_out;
+    for (LLVMBasicBlockRef bb = entry; bb != NULL; bb = LLVMGetNextBasicBlock(bb)) {
+        avail_out[bb] = bb == entry ? touched[bb] : slots;
+        st.avail_in[bb] = bb == entry ? unordered_set<LLVMValueRef>() : slots;
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (LLVMBasicBlockRef bb = LLVMGetNextBasicBlock(entry);
+             bb != NULL;
+             bb = LLVMGetNextBasicBlock(bb)) {
+
+            unordered_set<LLVMValueRef> new_in = slots;
+            for (LLVMBasicBlockRef pred : st.preds[bb]) {
+                if (!st.reachable.count(pred)) {
+                    continue;
+                }
+                unordered_set<LLVMValueRef> kept;
+                for (LLVMValueRef slot : new_in) {
+                    if (avail_out[pred].count(slot)) {
+                        kept.insert(slot);
+                    }
+                }
+                new_in.swap(kept);
+            }
+
+            unordered_set<LLVMValueRef> new_out = new_in;
+            new_out.insert(touched[bb].begin(), touched[bb].end());
+
+            // the sets only ever shrink, comparing sizes is enough
+            if (new_out.size() != avail_out[bb].size()) {
+                changed = true;
+            }
+            st.avail_in[bb] = new_in;
+            avail_out[bb] = new_out;
+        }
+    }
+}
+
+static LLVMValueRef value_at_exit(forwarding_state &st, LLVMBasicBlockRef bb, LLVMValueRef slot);
+
+// value of slot on entry to bb (the slot must be available there)
+static LLVMValueRef value_at_entry(forwarding_state &st, LLVMBasicBlockRef bb, LLVMValueRef slot) {
+    auto it = st.entry_value[bb].find(slot);
+    if (it != st.entry_value[bb].end()) {
+        return it->second;
+    }
+
+    vector<LLVMBasicBlockRef> &preds = st.preds[bb];
+    if (preds.size() == 1) {
+        LLVMValueRef value = value_at_exit(st, preds[0], slot);
+        st.entry_value[bb][slot] = value;
+        return value;
+    }
+
+    // a join: place the phi before asking the predecessors, so a loop
+    // coming back around finds it instead of recursing forever
+    LLVMBuilderRef builder = LLVMCreateBuilder();
+    LLVMPositionBuilderBefore(builder, LLVMGetFirstInstruction(bb));
+    LLVMValueRef phi = LLVMBuildPhi(builder, LLVMGetAllocatedType(slot), "");
+    LLVMDisposeBuilder(builder);
+    st.entry_value[bb][slot] = phi;
+    st.new_phis.push_back(phi);
+
+    for (LLVMBasicBlockRef pred : preds) {
+        LLVMValueRef value = st.reachable.count(pred)
+                                 ? value_at_exit(st, pred, slot)
+                                 : LLVMGetUndef(LLVMGetAllocatedType(slot));
+
+        // one entry per edge, a conditional branch may reach bb twice
+        LLVMValueRef term = LLVMGetBasicBlockTerminator(pred);
+        unsigned num_succs = LLVMGetNumSuccessors(term);
+        for (unsigned i = 0; i < num_succs; i++) {
+            if (LLVMGetSuccessor(term, i) == bb) {
+                LLVMBasicBlockRef from = pred;
+                LLVMAddIncoming(phi, &value, &from, 1);
+            }
+        }
+    }
+    return phi;
+}
+
+// value of slot at the end of bb: the last load or store of it in bb, or
+// whatever it held on entry
+static LLVMValueRef value_at_exit(forwarding_state &st, LLVMBasicBlockRef bb, LLVMValueRef slot) {
+    auto it = st.exit_value[bb].find(slot);
+    if (it != st.exit_value[bb].end()) {
+        return it->second;
+    }
+
+    LLVMValueRef value = NULL;
+    for (LLVMValueRef inst = LLVMGetLastInstruction(bb);
+         inst != NULL && value == NULL;
+         inst = LLVMGetPreviousInstruction(inst)) {
+        if (LLVMIsAStoreInst(inst) && get_store_address(inst) == slot) {
+            value = LLVMGetOperand(inst, 0);
+        } else if (LLVMIsALoadInst(inst) && get_load_address(inst) == slot) {
+            value = inst;
+        }
+    }
+    if (value == NULL) {
+        value = value_at_entry(st, bb, slot);
+    }
+
+    st.exit_value[bb][slot] = value;
+    return value;
+}
+
+// step 2: find the value of every load that can be forwarded
+static void forward_loads(LLVMValueRef function, const unordered_set<LLVMValueRef> &slots,
+                          forwarding_state &st) {
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+
+        if (!st.reachable.count(bb)) {
+            continue;
+        }
+
+        unordered_map<LLVMValueRef, LLVMValueRef> current;
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+             inst != NULL;
+             inst = LLVMGetNextInstruction(inst)) {
+
+            LLVMValueRef slot = accessed_slot(inst, slots);
+            if (slot == NULL) {
+                continue;
+            }
+
+            if (LLVMIsAStoreInst(inst)) {
+                current[slot] = LLVMGetOperand(inst, 0);
+                continue;
+            }
+
+            auto it = current.find(slot);
+            if (it != current.end()) {
+                st.replaced[inst] = it->second;
+            } else if (st.avail_in[bb].count(slot)) {
+                st.replaced[inst] = value_at_entry(st, bb, slot);
+                current[slot] = st.replaced[inst];
+            } else {
+                // nothing known yet, this load is where the value comes from
+                current[slot] = inst;
+            }
+        }
+    }
+}
+
+// step 3: a phi whose inputs are all one value (or itself) is that value
+static void remove_trivial_phis(forwarding_state &st) {
+    unordered_set<LLVMValueRef> removed;
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (LLVMValueRef phi : st.new_phis) {
+            if (removed.count(phi)) {
+                continue;
+            }
+
+            LLVMValueRef same = NULL;
+            bool trivial = true;
+            unsigned count = LLVMCountIncoming(phi);
+            for (unsigned i = 0; i < count; i++) {
+                LLVMValueRef value = LLVMGetIncomingValue(phi, i);
+                if (value == phi || value == same) {
+                    continue;
+                }
+                if (same != NULL) {
+                    trivial = false;
+                    break;
+                }
+                same = value;
+            }
+            if (!trivial || same == NULL) {
+                continue;
+            }
+
+            LLVMReplaceAllUsesWith(phi, same);
+            LLVMInstructionEraseFromParent(phi);
+            removed.insert(phi);
+            changed = true;
+        }
+    }
+}
+
+// ============================================================================
+// HELPER FUNCTION: forward_slot_values
+// ============================================================================
+// forwards the loads of the given slots (allocas of this function that
+// satisfy is_forwardable_slot); other passes use it to turn temporaries
+// they stored into SSA values
+bool forward_slot_values(LLVMValueRef function, const unordered_set<LLVMValueRef> &slots) {
+    forwarding_state st;
+    compute_predecessors(function, st.preds);
+    compute_available_slots(function, slots, st);
+    forward_loads(function, slots, st);
+
+    if (st.replaced.empty()) {
+        return false;
+    }
+
+    // replace first, delete after: a value may still name a load that
+    // is itself being replaced, resolve() follows the chain
+    for (auto &pair : st.replaced) {
+        LLVMReplaceAllUsesWith(pair.first, resolve(st, pair.second));
+    }
+    for (auto &pair : st.replaced) {
+        LLVMInstructionEraseFromParent(pair.first);
+    }
+
+    remove_trivial_phis(st);
+    return true;
+}
+
+// ============================================================================
+// MAIN PASS: store_to_load_forwarding
+// ============================================================================
+bool store_to_load_forwarding(LLVMModuleRef module) {
+    bool changed = false;
+
+    // iterate through all functions
+    for (LLVMValueRef function = LLVMGetFirstFunction(module);
+         function != NULL;
+         function = LLVMGetNextFunction(function)) {
+
+        LLVMBasicBlockRef entry = LLVMGetFirstBasicBlock(function);
+        if (entry == NULL) {
+            continue;
+        }
+
+        unordered_set<LLVMValueRef> slots;
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(entry);
+             inst != NULL;
+             inst = LLVMGetNextInstruction(inst)) {
+            if (LLVMIsAAllocaInst(inst) && is_forwardable_slot(inst)) {
+                slots.insert(inst);
+            }
+        }
+
+        if (!slots.empty()) {
+            changed |= forward_slot_values(function, slots);
+        }
+    }
+
+    return changed;
+}
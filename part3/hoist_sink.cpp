@@ -0,0 +1,167 @@
+#include "optimizer.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+// ============================================================================
+// CODE HOISTING AND SINKING
+// ============================================================================
+// if/else arms that do the same thing, like `if (a > b) c = 25; else
+// c = 25;`, compute it twice in the code and keep the branch alive:
+//   - hoist: when every successor of a conditional branch is entered only
+//     from that branch and starts with the same instruction, one copy moves
+//     above the branch and the others are deleted
+//   - sink: when every predecessor of a join has the join as its only
+//     successor and ends with the same instruction (one with no users, a
+//     store or a call), one copy moves to the top of the join
+// repeated until nothing moves. arms left with just a branch are what
+// --simplify-cfg threads and folds away.
+//
+// the instruction is the first (or last) in every arm, so it keeps its
+// place relative to every other load, store and call on each path, and
+// identical operands are defined above all the arms
+
+// first instruction of bb if it is not a phi or the terminator
+static LLVMValueRef first_movable(LLVMBasicBlockRef bb) {
+    LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+    if (inst == NULL || LLVMIsAPHINode(inst) || inst == LLVMGetBasicBlockTerminator(bb)) {
+        return NULL;
+    }
+    return inst;
+}
+
+// instruction just before bb's terminator, if there is one and it isn't a phi
+static LLVMValueRef last_movable(LLVMBasicBlockRef bb) {
+    LLVMValueRef term = LLVMGetBasicBlockTerminator(bb);
+    LLVMValueRef inst = term != NULL ? LLVMGetPreviousInstruction(term) : NULL;
+    if (inst == NULL || LLVMIsAPHINode(inst)) {
+        return NULL;
+    }
+    return inst;
+}
+
+// never moved: allocas belong to the entry block
+static bool can_move(LLVMValueRef inst) {
+    return inst != NULL && !LLVMIsAAllocaInst(inst);
+}
+
+// the distinct successors of bb
+static void distinct_successors(LLVMBasicBlockRef bb, vector<LLVMBasicBlockRef> &succs) {
+    LLVMValueRef term = LLVMGetBasicBlockTerminator(bb);
+    unsigned num_succs = term != NULL ? LLVMGetNumSuccessors(term) : 0;
+    for (unsigned i = 0; i < num_succs; i++) {
+        LLVMBasicBlockRef succ = LLVMGetSuccessor(term, i);
+        bool seen = false;
+        for (LLVMBasicBlockRef s : succs) {
+            seen |= s == succ;
+        }
+        if (!seen) {
+            succs.push_back(succ);
+        }
+    }
+}
+
+// keep the first instruction of the list, delete the rest
+static void merge_copies(const vector<LLVMValueRef> &copies) {
+    for (size_t i = 1; i < copies.size(); i++) {
+        LLVMReplaceAllUsesWith(copies[i], copies[0]);
+        LLVMInstructionEraseFromParent(copies[i]);
+    }
+}
+
+// hoist the common first instruction of bb's successors above its branch
+static bool hoist_from_successors(LLVMBasicBlockRef bb,
+                                  unordered_map<LLVMBasicBlockRef, vector<LLVMBasicBlockRef>> &preds) {
+    vector<LLVMBasicBlockRef> succs;
+    distinct_successors(bb, succs);
+    if (succs.size() < 2) {
+        return false;
+    }
+
+    vector<LLVMValueRef> copies;
+    for (LLVMBasicBlockRef succ : succs) {
+        LLVMValueRef inst = first_movable(succ);
+        if (succ == bb || preds[succ].size() != 1 || !can_move(inst) ||
+            (!copies.empty() && !instructions_equal(copies[0], inst))) {
+            return false;
+        }
+        copies.push_back(inst);
+    }
+
+    LLVMBuilderRef builder = LLVMCreateBuilder();
+    LLVMPositionBuilderBefore(builder, LLVMGetBasicBlockTerminator(bb));
+    LLVMInstructionRemoveFromParent(copies[0]);
+    LLVMInsertIntoBuilder(builder, copies[0]);
+    LLVMDisposeBuilder(builder);
+
+    merge_copies(copies);
+    return true;
+}
+
+// sink the common last instruction of bb's predecessors into bb
+static bool sink_from_predecessors(LLVMBasicBlockRef bb,
+                                   unordered_map<LLVMBasicBlockRef, vector<LLVMBasicBlockRef>> &preds) {
+    if (preds[bb].size() < 2) {
+        return false;
+    }
+
+    vector<LLVMValueRef> copies;
+    for (LLVMBasicBlockRef pred : preds[bb]) {
+        LLVMValueRef inst = last_movable(pred);
+        if (pred == bb || LLVMGetNumSuccessors(LLVMGetBasicBlockTerminator(pred)) != 1 ||
+            !can_move(inst) || LLVMGetFirstUse(inst) != NULL ||
+            (!copies.empty() && !instructions_equal(copies[0], inst))) {
+            return false;
+        }
+        copies.push_back(inst);
+    }
+
+    // below the phis
+    LLVMValueRef position = LLVMGetFirstInstruction(bb);
+    while (LLVMIsAPHINode(position)) {
+        position = LLVMGetNextInstruction(position);
+    }
+
+    LLVMBuilderRef builder = LLVMCreateBuilder();
+    LLVMPositionBuilderBefore(builder, position);
+    LLVMInstructionRemoveFromParent(copies[0]);
+    LLVMInsertIntoBuilder(builder, copies[0]);
+    LLVMDisposeBuilder(builder);
+
+    merge_copies(copies);
+    return true;
+}
+
+// ============================================================================
+// MAIN PASS: code_hoisting_sinking
+// ============================================================================
+bool code_hoisting_sinking(LLVMModuleRef module) {
+    bool changed = false;
+
+    // iterate through all functions
+    for (LLVMValueRef function = LLVMGetFirstFunction(module);
+         function != NULL;
+         function = LLVMGetNextFunction(function)) {
+
+        // moving instructions doesn't change the cfg, the predecessors
+        // stay valid
+        unordered_map<LLVMBasicBlockRef, vector<LLVMBasicBlockRef>> preds;
+        compute_predecessors(function, preds);
+
+        bool moved = true;
+        while (moved) {
+            moved = false;
+
+            for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+                 bb != NULL;
+                 bb = LLVMGetNextBasicBlock(bb)) {
+                moved |= hoist_from_successors(bb, preds);
+                moved |= sink_from_predecessors(bb, preds);
+            }
+            changed |= moved;
+        }
+    }
+
+    return changed;
+}
@@ -0,0 +1,241 @@
+#include "optimizer.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+// ============================================================================
+// IF-CONVERSION
+// ============================================================================
+// a short if/else that only computes values turns into straight-line code:
+// both arms run unconditionally and the phis at the join become selects.
+//
+//   bb:   br i1 %c, label %t, label %f          bb:  %x = add ...
+//   t:    %x = add ...    br label %join   ->         %y = sub ...
+//   f:    %y = sub ...    br label %join              %v = select i1 %c, %x, %y
+//   join: %v = phi [ %x, %t ], [ %y, %f ]             br label %join
+//
+// the triangle (an if without else, one arm going straight to the join) is
+// handled the same way, with the value from bb on the empty side.
+//
+// the arms may only hold instructions that are safe to run when their arm
+// wasn't taken (no memory, no calls, no division that could trap), which
+// in miniC means running --forward first. if_convert_cost limits the extra
+// work: instructions per arm, and phis turned into selects. --simplify-cfg
+// merges bb and the join afterwards.
+//
+// the branch disappears, so it can't be mispredicted: worth it for
+// data-dependent conditions, a loss for ones a predictor gets right anyway
+// (a cost model can't tell those apart without profiles)
+
+if_convert_options if_convert_cost = {4, 2};
+
+// true if value is, or is computed in the arm from, an operand of the
+// compare the branch into the arm tests. those are the only values whose
+// ranges the arm's condition narrows
+static bool depends_on_condition(LLVMValueRef value, LLVMBasicBlockRef arm, LLVMValueRef cond) {
+    if (LLVMIsAICmpInst(cond) &&
+        (value == LLVMGetOperand(cond, 0) || value == LLVMGetOperand(cond, 1))) {
+        return true;
+    }
+    if (!LLVMIsAInstruction(value) || LLVMGetInstructionParent(value) != arm) {
+        return false;
+    }
+    int num_ops = LLVMGetNumOperands(value);
+    for (int i = 0; i < num_ops; i++) {
+        if (depends_on_condition(LLVMGetOperand(value, i), arm, cond)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// instructions of arm that can run speculatively before it (cond is the
+// condition of the branch into the arm)
+static bool is_speculatable(LLVMValueRef inst, LLVMBasicBlockRef arm, LLVMValueRef cond) {
+    switch (LLVMGetInstructionOpcode(inst)) {
+        case LLVMAdd: case LLVMSub: case LLVMMul:
+        case LLVMShl: case LLVMLShr: case LLVMAShr:
+        case LLVMAnd: case LLVMOr: case LLVMXor:
+        case LLVMICmp: case LLVMZExt: case LLVMSExt: case LLVMTrunc:
+        case LLVMSelect:
+            return true;
+
+        case LLVMSDiv: case LLVMSRem:
+            // a constant divisor other than 0 and -1, or a range-analysis
+            // mark that doesn't rest on the arm's own condition
+            if (is_safe_constant_divisor(inst)) {
+                return true;
+            }
+            return has_non_trapping_mark(inst) &&
+                   !depends_on_condition(LLVMGetOperand(inst, 1), arm, cond);
+
+        default:
+            return false;
+    }
+}
+
+// an arm: entered only from bb, leaves only to join, and cheap enough to
+// run on every path
+static bool is_convertible_arm(LLVMBasicBlockRef arm, LLVMBasicBlockRef join,
+                               unordered_map<LLVMBasicBlockRef, vector<LLVMBasicBlockRef>> &preds) {
+    LLVMValueRef term = LLVMGetBasicBlockTerminator(arm);
+    if (preds[arm].size() != 1 || !LLVMIsABranchInst(term) || LLVMIsConditional(term) ||
+        LLVMGetSuccessor(term, 0) != join) {
+        return false;
+    }
+
+    LLVMValueRef cond = LLVMGetCondition(LLVMGetBasicBlockTerminator(preds[arm][0]));
+    int size = 0;
+    for (LLVMValueRef inst = LLVMGetFirstInstruction(arm);
+         inst != term;
+         inst = LLVMGetNextInstruction(inst)) {
+        if (!is_speculatable(inst, arm, cond) || ++size > if_convert_cost.max_arm_size) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// the value phi receives along the edge from block from
+static LLVMValueRef incoming_from(LLVMValueRef phi, LLVMBasicBlockRef from) {
+    unsigned count = LLVMCountIncoming(phi);
+    for (unsigned i = 0; i < count; i++) {
+        if (LLVMGetIncomingBlock(phi, i) == from) {
+            return LLVMGetIncomingValue(phi, i);
+        }
+    }
+    return NULL;
+}
+
+// if-convert the branch at the end of bb, if it is a small diamond or triangle
+static bool convert_branch(LLVMBasicBlockRef bb,
+                           unordered_map<LLVMBasicBlockRef, vector<LLVMBasicBlockRef>> &preds) {
+    LLVMValueRef term = LLVMGetBasicBlockTerminator(bb);
+    if (term == NULL || !LLVMIsABranchInst(term) || !LLVMIsConditional(term)) {
+        return false;
+    }
+
+    LLVMBasicBlockRef true_bb = LLVMGetSuccessor(term, 0);
+    LLVMBasicBlockRef false_bb = LLVMGetSuccessor(term, 1);
+    if (true_bb == false_bb || true_bb == bb || false_bb == bb) {
+        return false;
+    }
+
+    // the blocks the values come from on each side, and the arms to remove
+    LLVMBasicBlockRef join = NULL;
+    LLVMBasicBlockRef true_from = NULL, false_from = NULL;
+    vector<LLVMBasicBlockRef> arms;
+
+    LLVMValueRef true_term = LLVMGetBasicBlockTerminator(true_bb);
+    LLVMValueRef false_term = LLVMGetBasicBlockTerminator(false_bb);
+    LLVMBasicBlockRef true_next = LLVMIsABranchInst(true_term) && !LLVMIsConditional(true_term)
+                                      ? LLVMGetSuccessor(true_term, 0) : NULL;
+    LLVMBasicBlockRef false_next = LLVMIsABranchInst(false_term) && !LLVMIsConditional(false_term)
+                                       ? LLVMGetSuccessor(false_term, 0) : NULL;
+
+    if (true_next != NULL && true_next == false_next) {
+        join = true_next;                          // diamond
+        true_from = true_bb;
+        false_from = false_bb;
+        arms.push_back(true_bb);
+        arms.push_back(false_bb);
+    } else if (true_next == false_bb) {
+        join = false_bb;                           // triangle, then-arm only
+        true_from = true_bb;
+        false_from = bb;
+        arms.push_back(true_bb);
+    } else if (false_next == true_bb) {
+        join = true_bb;                            // triangle, else-arm only
+        true_from = bb;
+        false_from = false_bb;
+        arms.push_back(false_bb);
+    } else {
+        return false;
+    }
+
+    // the join must be reached from the two sides only, or its phis would
+    // have to keep entries for other predecessors
+    if (join == bb || preds[join].size() != 2) {
+        return false;
+    }
+    for (LLVMBasicBlockRef arm : arms) {
+        if (!is_convertible_arm(arm, join, preds)) {
+            return false;
+        }
+    }
+
+    vector<LLVMValueRef> phis;
+    for (LLVMValueRef inst = LLVMGetFirstInstruction(join);
+         inst != NULL && LLVMIsAPHINode(inst);
+         inst = LLVMGetNextInstruction(inst)) {
+        phis.push_back(inst);
+    }
+    if ((int)phis.size() > if_convert_cost.max_selects) {
+        return false;
+    }
+
+    // step 1: run the arms in bb, before its branch
+    LLVMBuilderRef builder = LLVMCreateBuilder();
+    LLVMPositionBuilderBefore(builder, term);
+    for (LLVMBasicBlockRef arm : arms) {
+        LLVMValueRef arm_term = LLVMGetBasicBlockTerminator(arm);
+        while (LLVMGetFirstInstruction(arm) != arm_term) {
+            LLVMValueRef inst = LLVMGetFirstInstruction(arm);
+            LLVMInstructionRemoveFromParent(inst);
+            LLVMInsertIntoBuilder(builder, inst);
+        }
+    }
+
+    // step 2: phis become selects on the branch condition
+    LLVMValueRef cond = LLVMGetCondition(term);
+    for (LLVMValueRef phi : phis) {
+        LLVMValueRef select = LLVMBuildSelect(builder, cond, incoming_from(phi, true_from),
+                                              incoming_from(phi, false_from), "");
+        LLVMReplaceAllUsesWith(phi, select);
+        LLVMInstructionEraseFromParent(phi);
+    }
+
+    // step 3: bb goes straight to the join, the arms are left empty
+    LLVMBuildBr(builder, join);
+    LLVMDisposeBuilder(builder);
+    LLVMInstructionEraseFromParent(term);
+
+    for (LLVMBasicBlockRef arm : arms) {
+        LLVMDeleteBasicBlock(arm);
+    }
+    return true;
+}
+
+// ============================================================================
+// MAIN PASS: if_conversion
+// ============================================================================
+bool if_conversion(LLVMModuleRef module) {
+    bool changed = false;
+
+    // iterate through all functions
+    for (LLVMValueRef function = LLVMGetFirstFunction(module);
+         function != NULL;
+         function = LLVMGetNextFunction(function)) {
+
+        recheck_non_trapping_marks(function);
+
+        // one conversion at a time, each one changes the predecessors
+        bool converted = true;
+        while (converted) {
+            converted = false;
+
+            unordered_map<LLVMBasicBlockRef, vector<LLVMBasicBlockRef>> preds;
+            compute_predecessors(function, preds);
+
+            for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+                 bb != NULL && !converted;
+                 bb = LLVMGetNextBasicBlock(bb)) {
+                converted = convert_branch(bb, preds);
+            }
+            changed |= converted;
+        }
+    }
+
+    return changed;
+}
@@ -0,0 +1,749 @@
+#include "optimizer.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+// ============================================================================
+// INDUCTION VARIABLES
+// ============================================================================
+// a small scalar-evolution: inside a loop, values are described as affine
+// functions  scale * i + offset (+ k * one loop-invariant value)  of a basic
+// induction variable i, the counter slot updated by `i = i + step` once per
+// iteration. i always means its value at the start of the current
+// iteration, so a load of i after the update reads i + step.
+//
+// with that, for every loop (innermost first):
+//   - strength reduction: a multiply that is affine in i becomes a header
+//     phi that starts at scale * i0 + offset and grows by scale * step on
+//     every trip around the loop (one add instead of load + mul)
+//   - closed form: a loop `while (i < n) { ... i = i + 1; }` whose body only
+//     adds affine values to slots is replaced by the sums themselves:
+//         trips = max(0, n - i0)
+//         s += trips * (scale * i0 + offset) + scale * trips * (trips - 1) / 2
+//     and the preheader jumps straight to the exit
+
+// a value as a function of the induction variable
+struct affine_expr {
+    long long scale;            // coefficient of i (0 if the value doesn't depend on it)
+    long long offset;           // constant part
+    LLVMValueRef invariant;     // loop-invariant value, or NULL
+    long long invariant_scale;  // coefficient of the invariant
+    long long self_scale;       // coefficient of the slot being accumulated (closed form)
+};
+
+// where a load of the induction variable sits relative to its update
+enum iv_phase { IV_BEFORE_UPDATE, IV_AFTER_UPDATE, IV_UNKNOWN };
+
+struct iv_context {
+    loop_info *loop;
+    unordered_map<LLVMBasicBlockRef, unordered_set<LLVMBasicBlockRef>> dom;
+    unordered_set<LLVMValueRef> stored_slots;   // slots written inside the loop
+    const induction_variable *iv;
+    unsigned width;
+    LLVMValueRef self_update;   // store of the slot being accumulated, or NULL
+};
+
+// true if `first` comes before `second` in the same block
+static bool comes_before(LLVMValueRef first, LLVMValueRef second) {
+    for (LLVMValueRef inst = LLVMGetNextInstruction(first);
+         inst != NULL;
+         inst = LLVMGetNextInstruction(inst)) {
+        if (inst == second) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// blocks of the loops nested inside loop
+static void inner_loop_blocks(loop_info *loop, unordered_set<LLVMBasicBlockRef> &inner) {
+    for (loop_info *child : loop->children) {
+        inner.insert(child->blocks.begin(), child->blocks.end());
+    }
+}
+
+// ============================================================================
+// HELPER FUNCTION: find_induction_variables
+// ============================================================================
+// a slot is a basic induction variable when the loop stores to it exactly
+// once, that store is `load(slot) + c` (or `- c`) with the load earlier in
+// the same block, and its block dominates every latch without being part
+// of a nested loop, so it runs exactly once per iteration
+void find_induction_variables(loop_info *loop, vector<induction_variable> &ivs) {
+    ivs.clear();
+
+    LLVMValueRef function = LLVMGetBasicBlockParent(loop->header);
+    unordered_map<LLVMBasicBlockRef, unordered_set<LLVMBasicBlockRef>> dom;
+    compute_dominators(function, dom);
+
+    unordered_set<LLVMBasicBlockRef> inner;
+    inner_loop_blocks(loop, inner);
+
+    // stores per slot, slots in program order
+    vector<LLVMValueRef> slots;
+    unordered_map<LLVMValueRef, vector<LLVMValueRef>> stores;
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+
+        if (!loop->blocks.count(bb)) {
+            continue;
+        }
+
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+             inst != NULL;
+             inst = LLVMGetNextInstruction(inst)) {
+            if (LLVMIsAStoreInst(inst)) {
+                LLVMValueRef addr = get_store_address(inst);
+                if (stores[addr].empty()) {
+                    slots.push_back(addr);
+                }
+                stores[addr].push_back(inst);
+            }
+        }
+    }
+
+    for (LLVMValueRef slot : slots) {
+        if (stores[slot].size() != 1 || !is_promotable_alloca(slot)) {
+            continue;
+        }
+
+        LLVMValueRef store = stores[slot][0];
+        LLVMBasicBlockRef bb = LLVMGetInstructionParent(store);
+        if (inner.count(bb)) {
+            continue;
+        }
+
+        bool every_iteration = true;
+        for (LLVMBasicBlockRef latch : loop->latches) {
+            if (!dom[latch].count(bb)) {
+                every_iteration = false;
+            }
+        }
+        if (!every_iteration) {
+            continue;
+        }
+
+        // the stored value: load(slot) + c, c + load(slot) or load(slot) - c
+        LLVMValueRef value = LLVMGetOperand(store, 0);
+        unsigned width = int_width(value);
+        if (width == 0 || !LLVMIsAInstruction(value) ||
+            LLVMGetInstructionParent(value) != bb) {
+            continue;
+        }
+
+        LLVMOpcode opcode = LLVMGetInstructionOpcode(value);
+        LLVMValueRef lhs = LLVMGetOperand(value, 0);
+        LLVMValueRef rhs = LLVMGetOperand(value, 1);
+        if (opcode == LLVMAdd && LLVMIsAConstantInt(lhs)) {
+            LLVMValueRef tmp = lhs;
+            lhs = rhs;
+            rhs = tmp;
+        }
+        if ((opcode != LLVMAdd && opcode != LLVMSub) || !LLVMIsAConstantInt(rhs) ||
+            !LLVMIsALoadInst(lhs) || get_load_address(lhs) != slot ||
+            LLVMGetInstructionParent(lhs) != bb || !comes_before(lhs, store)) {
+            continue;
+        }
+
+        long long step = LLVMConstIntGetSExtValue(rhs);
+        if (opcode == LLVMSub) {
+            step = -step;
+        }
+
+        induction_variable iv;
+        iv.slot = slot;
+        iv.update = store;
+        iv.step = normalize_int(step, width);
+        ivs.push_back(iv);
+    }
+}
+
+// ============================================================================
+// AFFINE EXPRESSIONS
+// ============================================================================
+
+// a load of the induction variable reads i before the update and i + step
+// after it. the update block runs once per iteration, so blocks it
+// dominates come after it and blocks that dominate it come before
+static iv_phase load_phase(iv_context &ctx, LLVMValueRef load, LLVMValueRef update) {
+    LLVMBasicBlockRef load_bb = LLVMGetInstructionParent(load);
+    LLVMBasicBlockRef update_bb = LLVMGetInstructionParent(update);
+
+    if (load_bb == update_bb) {
+        return comes_before(load, update) ? IV_BEFORE_UPDATE : IV_AFTER_UPDATE;
+    }
+    if (ctx.dom[update_bb].count(load_bb)) {
+        return IV_BEFORE_UPDATE;
+    }
+    if (ctx.dom[load_bb].count(update_bb)) {
+        return IV_AFTER_UPDATE;
+    }
+    return IV_UNKNOWN;
+}
+
+static affine_expr make_affine(long long scale, long long offset, LLVMValueRef invariant) {
+    affine_expr e;
+    e.scale = scale;
+    e.offset = offset;
+    e.invariant = invariant;
+    e.invariant_scale = invariant != NULL ? 1 : 0;
+    e.self_scale = 0;
+    return e;
+}
+
+// true if e is a plain constant
+static bool is_constant_affine(const affine_expr &e) {
+    return e.scale == 0 && e.invariant == NULL && e.self_scale == 0;
+}
+
+// wrapping arithmetic at the width of the induction variable
+static long long wrap_add(long long a, long long b, unsigned width) {
+    return normalize_int((long long)((unsigned long long)a + (unsigned long long)b), width);
+}
+
+static long long wrap_mul(long long a, long long b, unsigned width) {
+    return normalize_int((long long)((unsigned long long)a * (unsigned long long)b), width);
+}
+
+// describe value as an affine function of ctx.iv (false if it isn't one)
+static bool affine_of(iv_context &ctx, LLVMValueRef value, affine_expr *out) {
+    if (int_width(value) != ctx.width) {
+        return false;
+    }
+
+    if (LLVMIsAConstantInt(value)) {
+        *out = make_affine(0, LLVMConstIntGetSExtValue(value), NULL);
+        return true;
+    }
+
+    // arguments and values computed before the loop are invariant
+    if (!LLVMIsAInstruction(value) ||
+        !ctx.loop->blocks.count(LLVMGetInstructionParent(value))) {
+        *out = make_affine(0, 0, value);
+        return true;
+    }
+
+    affine_expr lhs, rhs;
+    LLVMOpcode opcode = LLVMGetInstructionOpcode(value);
+
+    switch (opcode) {
+        case LLVMLoad: {
+            LLVMValueRef addr = get_load_address(value);
+            if (ctx.self_update != NULL && addr == get_store_address(ctx.self_update)) {
+                // the accumulated slot, as it was when the iteration started
+                if (load_phase(ctx, value, ctx.self_update) != IV_BEFORE_UPDATE) {
+                    return false;
+                }
+                *out = make_affine(0, 0, NULL);
+                out->self_scale = 1;
+                return true;
+            }
+            if (addr == ctx.iv->slot) {
+                iv_phase phase = load_phase(ctx, value, ctx.iv->update);
+                if (phase == IV_UNKNOWN) {
+                    return false;
+                }
+                *out = make_affine(1, phase == IV_AFTER_UPDATE ? ctx.iv->step : 0, NULL);
+                return true;
+            }
+            if (is_promotable_alloca(addr) && !ctx.stored_slots.count(addr)) {
+                *out = make_affine(0, 0, value);
+                return true;
+            }
+            return false;
+        }
+
+        case LLVMAdd:
+        case LLVMSub:
+        case LLVMMul:
+        case LLVMShl:
+            if (!affine_of(ctx, LLVMGetOperand(value, 0), &lhs) ||
+                !affine_of(ctx, LLVMGetOperand(value, 1), &rhs)) {
+                return false;
+            }
+            break;
+
+        default:
+            return false;
+    }
+
+    unsigned w = ctx.width;
+
+    if (opcode == LLVMShl) {
+        // x << k is x * 2^k
+        if (!is_constant_affine(rhs) || rhs.offset < 0 || rhs.offset >= (long long)w) {
+            return false;
+        }
+        rhs = make_affine(0, normalize_int(1LL << rhs.offset, w), NULL);
+        opcode = LLVMMul;
+    }
+
+    if (opcode == LLVMMul) {
+        // one side must be a constant
+        if (!is_constant_affine(lhs)) {
+            affine_expr tmp = lhs;
+            lhs = rhs;
+            rhs = tmp;
+        }
+        if (!is_constant_affine(lhs)) {
+            return false;
+        }
+        long long k = lhs.offset;
+        *out = rhs;
+        out->scale = wrap_mul(rhs.scale, k, w);
+        out->offset = wrap_mul(rhs.offset, k, w);
+        out->invariant_scale = wrap_mul(rhs.invariant_scale, k, w);
+        out->self_scale = wrap_mul(rhs.self_scale, k, w);
+        return true;
+    }
+
+    if (opcode == LLVMSub) {
+        rhs.scale = wrap_mul(rhs.scale, -1, w);
+        rhs.offset = wrap_mul(rhs.offset, -1, w);
+        rhs.invariant_scale = wrap_mul(rhs.invariant_scale, -1, w);
+        rhs.self_scale = wrap_mul(rhs.self_scale, -1, w);
+    }
+
+    // add (or sub with the right side negated); only one invariant value fits
+    if (lhs.invariant != NULL && rhs.invariant != NULL && lhs.invariant != rhs.invariant) {
+        return false;
+    }
+    out->scale = wrap_add(lhs.scale, rhs.scale, w);
+    out->offset = wrap_add(lhs.offset, rhs.offset, w);
+    out->invariant = lhs.invariant != NULL ? lhs.invariant : rhs.invariant;
+    out->invariant_scale = wrap_add(lhs.invariant_scale, rhs.invariant_scale, w);
+    out->self_scale = wrap_add(lhs.self_scale, rhs.self_scale, w);
+    if (out->invariant_scale == 0) {
+        out->invariant = NULL;
+    }
+    return true;
+}
+
+// set up ctx for one induction variable of the loop
+static void init_context(iv_context &ctx, loop_info *loop, const induction_variable *iv) {
+    LLVMValueRef function = LLVMGetBasicBlockParent(loop->header);
+
+    ctx.loop = loop;
+    ctx.iv = iv;
+    ctx.width = int_width(LLVMGetOperand(iv->update, 0));
+    ctx.self_update = NULL;
+    ctx.dom.clear();
+    ctx.stored_slots.clear();
+    compute_dominators(function, ctx.dom);
+
+    for (LLVMBasicBlockRef bb : loop->blocks) {
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+             inst != NULL;
+             inst = LLVMGetNextInstruction(inst)) {
+            if (LLVMIsAStoreInst(inst)) {
+                ctx.stored_slots.insert(get_store_address(inst));
+            }
+        }
+    }
+}
+
+// true if every user of inst is inside the loop
+static bool used_only_in_loop(loop_info *loop, LLVMValueRef inst) {
+    for (LLVMUseRef use = LLVMGetFirstUse(inst); use != NULL; use = LLVMGetNextUse(use)) {
+        LLVMValueRef user = LLVMGetUser(use);
+        if (!LLVMIsAInstruction(user) || !loop->blocks.count(LLVMGetInstructionParent(user))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// STRENGTH REDUCTION
+// ============================================================================
+
+// one scale * i + offset sequence, carried by a header phi
+struct iv_recurrence {
+    long long scale;
+    long long offset;
+    LLVMValueRef phi;
+};
+
+static bool reduce_multiplies(loop_info *loop, const induction_variable &iv) {
+    iv_context ctx;
+    init_context(ctx, loop, &iv);
+
+    LLVMValueRef function = LLVMGetBasicBlockParent(loop->header);
+    LLVMTypeRef type = LLVMTypeOf(LLVMGetOperand(iv.update, 0));
+
+    // step 1: multiplies (and shifts) that are affine in i
+    vector<LLVMValueRef> candidates;
+    vector<affine_expr> forms;
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+
+        if (!loop->blocks.count(bb)) {
+            continue;
+        }
+
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+             inst != NULL;
+             inst = LLVMGetNextInstruction(inst)) {
+            LLVMOpcode opcode = LLVMGetInstructionOpcode(inst);
+            if (opcode != LLVMMul && opcode != LLVMShl) {
+                continue;
+            }
+
+            affine_expr e;
+            if (affine_of(ctx, inst, &e) && e.scale != 0 && e.invariant == NULL &&
+                used_only_in_loop(loop, inst)) {
+                candidates.push_back(inst);
+                forms.push_back(e);
+            }
+        }
+    }
+
+    if (candidates.empty()) {
+        return false;
+    }
+
+    // step 2: one phi per distinct (scale, offset)
+    LLVMBasicBlockRef preheader = ensure_preheader(loop);
+    LLVMBasicBlockRef header = loop->header;
+    LLVMBuilderRef builder = LLVMCreateBuilder();
+
+    LLVMValueRef first_non_phi = LLVMGetFirstInstruction(header);
+    while (LLVMIsAPHINode(first_non_phi)) {
+        first_non_phi = LLVMGetNextInstruction(first_non_phi);
+    }
+
+    LLVMPositionBuilderBefore(builder, LLVMGetBasicBlockTerminator(preheader));
+    LLVMValueRef start = LLVMBuildLoad2(builder, type, iv.slot, "");
+
+    vector<iv_recurrence> recurrences;
+    for (size_t c = 0; c < candidates.size(); c++) {
+        const affine_expr &e = forms[c];
+
+        LLVMValueRef phi = NULL;
+        for (const iv_recurrence &r : recurrences) {
+            if (r.scale == e.scale && r.offset == e.offset) {
+                phi = r.phi;
+            }
+        }
+
+        if (phi == NULL) {
+            // scale * i0 + offset, in the preheader
+            LLVMPositionBuilderBefore(builder, LLVMGetBasicBlockTerminator(preheader));
+            LLVMValueRef init = LLVMBuildMul(builder, start,
+                                             LLVMConstInt(type, (unsigned long long)e.scale, 1), "");
+            if (e.offset != 0) {
+                init = LLVMBuildAdd(builder, init,
+                                    LLVMConstInt(type, (unsigned long long)e.offset, 1), "");
+            }
+
+            // phi + scale * step, right after the header phis
+            long long stride = wrap_mul(e.scale, iv.step, ctx.width);
+            LLVMPositionBuilderBefore(builder, LLVMGetFirstInstruction(header));
+            phi = LLVMBuildPhi(builder, type, "");
+            LLVMPositionBuilderBefore(builder, first_non_phi);
+            LLVMValueRef next = LLVMBuildAdd(builder, phi,
+                                             LLVMConstInt(type, (unsigned long long)stride, 1), "");
+
+            LLVMBasicBlockRef from = preheader;
+            LLVMAddIncoming(phi, &init, &from, 1);
+            for (LLVMBasicBlockRef latch : loop->latches) {
+                from = latch;
+                LLVMAddIncoming(phi, &next, &from, 1);
+            }
+
+            iv_recurrence r;
+            r.scale = e.scale;
+            r.offset = e.offset;
+            r.phi = phi;
+            recurrences.push_back(r);
+        }
+
+        LLVMReplaceAllUsesWith(candidates[c], phi);
+        LLVMInstructionEraseFromParent(candidates[c]);
+    }
+
+    LLVMDisposeBuilder(builder);
+    return true;
+}
+
+// ============================================================================
+// CLOSED FORM
+// ============================================================================
+
+// one slot the loop adds to: s = s + per_iteration
+struct accumulator {
+    LLVMValueRef slot;
+    affine_expr per_iteration;
+};
+
+// true if inst can be dropped along with the loop (no effects besides the
+// stores the closed form takes over)
+static bool is_replaceable_opcode(LLVMValueRef inst) {
+    switch (LLVMGetInstructionOpcode(inst)) {
+        case LLVMAdd: case LLVMSub: case LLVMMul:
+        case LLVMShl: case LLVMLShr: case LLVMAShr:
+        case LLVMAnd: case LLVMOr: case LLVMXor:
+        case LLVMICmp: case LLVMZExt: case LLVMSExt: case LLVMTrunc:
+        case LLVMSelect: case LLVMLoad: case LLVMStore: case LLVMBr:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static LLVMValueRef const_of(LLVMTypeRef type, long long value) {
+    return LLVMConstInt(type, (unsigned long long)value, 1);
+}
+
+// value * k, without emitting multiplies by 0 or 1
+static LLVMValueRef build_scaled(LLVMBuilderRef builder, LLVMValueRef value, long long k) {
+    if (k == 0) {
+        return const_of(LLVMTypeOf(value), 0);
+    }
+    if (k == 1) {
+        return value;
+    }
+    return LLVMBuildMul(builder, value, const_of(LLVMTypeOf(value), k), "");
+}
+
+// offset + k * invariant of e, built in the preheader. affine_of only makes
+// invariants of values from before the loop and of loads of slots the loop
+// never writes, which are simply loaded again
+static LLVMValueRef build_invariant_part(loop_info *loop, const affine_expr &e,
+                                         LLVMTypeRef type, LLVMBuilderRef builder) {
+    if (e.invariant == NULL) {
+        return const_of(type, e.offset);
+    }
+
+    LLVMValueRef value = e.invariant;
+    if (LLVMIsAInstruction(value) && loop->blocks.count(LLVMGetInstructionParent(value))) {
+        value = LLVMBuildLoad2(builder, type, get_load_address(value), "");
+    }
+    value = build_scaled(builder, value, e.invariant_scale);
+    if (e.offset != 0) {
+        value = LLVMBuildAdd(builder, value, const_of(type, e.offset), "");
+    }
+    return value;
+}
+
+static bool replace_with_closed_form(loop_info *loop, const vector<induction_variable> &ivs) {
+    // the header runs once more than the body, so it must not be the latch
+    if (!loop->children.empty() || loop->latches.size() != 1 ||
+        loop->latches[0] == loop->header) {
+        return false;
+    }
+
+    LLVMBasicBlockRef header = loop->header;
+    LLVMValueRef function = LLVMGetBasicBlockParent(header);
+
+    // step 1: the header is the only way out: br (icmp slt/sle i, n), body, exit
+    LLVMValueRef term = LLVMGetBasicBlockTerminator(header);
+    if (!LLVMIsABranchInst(term) || !LLVMIsConditional(term)) {
+        return false;
+    }
+    LLVMBasicBlockRef exit = LLVMGetSuccessor(term, 1);
+    if (!loop->blocks.count(LLVMGetSuccessor(term, 0)) || loop->blocks.count(exit)) {
+        return false;
+    }
+    LLVMValueRef first = LLVMGetFirstInstruction(exit);
+    if (first != NULL && LLVMIsAPHINode(first)) {
+        return false;
+    }
+
+    for (LLVMBasicBlockRef bb : loop->blocks) {
+        if (bb == header) {
+            continue;
+        }
+        LLVMValueRef bb_term = LLVMGetBasicBlockTerminator(bb);
+        unsigned num_succs = LLVMGetNumSuccessors(bb_term);
+        for (unsigned i = 0; i < num_succs; i++) {
+            if (!loop->blocks.count(LLVMGetSuccessor(bb_term, i))) {
+                return false;
+            }
+        }
+    }
+
+    LLVMValueRef cond = LLVMGetCondition(term);
+    if (!LLVMIsAICmpInst(cond)) {
+        return false;
+    }
+    LLVMIntPredicate pred = LLVMGetICmpPredicate(cond);
+    if (pred != LLVMIntSLT && pred != LLVMIntSLE) {
+        return false;
+    }
+
+    // step 2: the compared counter is an induction variable counting up by 1
+    iv_context ctx;
+    const induction_variable *counter = NULL;
+    affine_expr bound;
+    for (const induction_variable &iv : ivs) {
+        if (iv.step != 1) {
+            continue;
+        }
+        init_context(ctx, loop, &iv);
+        affine_expr lhs;
+        if (affine_of(ctx, LLVMGetOperand(cond, 0), &lhs) &&
+            lhs.scale == 1 && lhs.offset == 0 && lhs.invariant == NULL &&
+            affine_of(ctx, LLVMGetOperand(cond, 1), &bound) && bound.scale == 0) {
+            counter = &iv;
+            break;
+        }
+    }
+    if (counter == NULL) {
+        return false;
+    }
+
+    // step 3: nothing in the loop but arithmetic, loads, and stores of the
+    // form s = s + (affine in i), one per slot, on every iteration
+    vector<accumulator> accumulators;
+    unordered_map<LLVMValueRef, int> store_count;
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+
+        if (!loop->blocks.count(bb)) {
+            continue;
+        }
+
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+             inst != NULL;
+             inst = LLVMGetNextInstruction(inst)) {
+            if (!is_replaceable_opcode(inst) || !used_only_in_loop(loop, inst)) {
+                return false;
+            }
+            if (!LLVMIsAStoreInst(inst)) {
+                continue;
+            }
+
+            LLVMValueRef slot = get_store_address(inst);
+            if (++store_count[slot] > 1 || !is_promotable_alloca(slot) || bb == header ||
+                !ctx.dom[loop->latches[0]].count(bb)) {
+                return false;
+            }
+
+            // the stored value must be s + (affine in i), where s is the
+            // slot's value from the start of the iteration
+            accumulator acc;
+            acc.slot = slot;
+            ctx.self_update = inst;
+            bool affine = affine_of(ctx, LLVMGetOperand(inst, 0), &acc.per_iteration);
+            ctx.self_update = NULL;
+            if (!affine || acc.per_iteration.self_scale != 1) {
+                return false;
+            }
+            acc.per_iteration.self_scale = 0;
+            accumulators.push_back(acc);
+        }
+    }
+
+    // step 4: compute the final values in the preheader
+    LLVMTypeRef type = LLVMTypeOf(LLVMGetOperand(counter->update, 0));
+    LLVMBasicBlockRef preheader = ensure_preheader(loop);
+    LLVMBuilderRef builder = LLVMCreateBuilder();
+    LLVMPositionBuilderBefore(builder, LLVMGetBasicBlockTerminator(preheader));
+
+    // read everything before anything is written
+    vector<LLVMValueRef> start_values;
+    LLVMValueRef i0 = NULL;
+    for (const accumulator &acc : accumulators) {
+        LLVMValueRef start = LLVMBuildLoad2(builder, type, acc.slot, "");
+        start_values.push_back(start);
+        if (acc.slot == counter->slot) {
+            i0 = start;
+        }
+    }
+
+    LLVMValueRef n = build_invariant_part(loop, bound, type, builder);
+
+    // trips = i0 < n ? n - i0 : 0   (n - i0 + 1 and <= for sle)
+    LLVMValueRef in_range = LLVMBuildICmp(builder, pred, i0, n, "");
+    LLVMValueRef diff = LLVMBuildSub(builder, n, i0, "");
+    if (pred == LLVMIntSLE) {
+        diff = LLVMBuildAdd(builder, diff, const_of(type, 1), "");
+    }
+    LLVMValueRef trips = LLVMBuildSelect(builder, in_range, diff, const_of(type, 0), "");
+
+    // trips * (trips - 1) / 2, halving whichever factor is even so the
+    // product is exact modulo 2^width
+    LLVMValueRef triangle = NULL;
+    for (const accumulator &acc : accumulators) {
+        if (acc.per_iteration.scale != 0 && triangle == NULL) {
+            LLVMValueRef minus_one = LLVMBuildSub(builder, trips, const_of(type, 1), "");
+            LLVMValueRef low_bit = LLVMBuildAnd(builder, trips, const_of(type, 1), "");
+            LLVMValueRef even = LLVMBuildICmp(builder, LLVMIntEQ, low_bit, const_of(type, 0), "");
+            LLVMValueRef a = LLVMBuildSelect(builder, even,
+                                             LLVMBuildLShr(builder, trips, const_of(type, 1), ""),
+                                             trips, "");
+            LLVMValueRef b = LLVMBuildSelect(builder, even, minus_one,
+                                             LLVMBuildLShr(builder, minus_one, const_of(type, 1), ""),
+                                             "");
+            triangle = LLVMBuildMul(builder, a, b, "");
+        }
+    }
+
+    // s = s0 + trips * (scale * i0 + offset + k * inv) + scale * triangle
+    vector<LLVMValueRef> final_values;
+    for (size_t k = 0; k < accumulators.size(); k++) {
+        const affine_expr &e = accumulators[k].per_iteration;
+
+        LLVMValueRef first_term = build_invariant_part(loop, e, type, builder);
+        if (e.scale != 0) {
+            first_term = LLVMBuildAdd(builder, first_term, build_scaled(builder, i0, e.scale), "");
+        }
+        LLVMValueRef total = LLVMIsAConstantInt(first_term)
+                                 ? build_scaled(builder, trips, LLVMConstIntGetSExtValue(first_term))
+                                 : LLVMBuildMul(builder, trips, first_term, "");
+        if (e.scale != 0) {
+            total = LLVMBuildAdd(builder, total, build_scaled(builder, triangle, e.scale), "");
+        }
+        final_values.push_back(LLVMBuildAdd(builder, start_values[k], total, ""));
+    }
+
+    for (size_t k = 0; k < accumulators.size(); k++) {
+        LLVMBuildStore(builder, final_values[k], accumulators[k].slot);
+    }
+
+    LLVMDisposeBuilder(builder);
+
+    // step 5: skip the loop, it is now unreachable
+    make_branch_unconditional(LLVMGetBasicBlockTerminator(preheader), exit);
+    remove_unreachable_blocks(function);
+    return true;
+}
+
+bool induction_variable_optimization(LLVMModuleRef module) {
+    bool changed = false;
+
+    // iterate through all functions
+    for (LLVMValueRef function = LLVMGetFirstFunction(module);
+         function != NULL;
+         function = LLVMGetNextFunction(function)) {
+
+        vector<loop_info *> loops;
+        find_loops(function, loops);
+
+        // innermost loops first
+        for (loop_info *loop : loops) {
+            vector<induction_variable> ivs;
+            find_induction_variables(loop, ivs);
+
+            if (replace_with_closed_form(loop, ivs)) {
+                // blocks were deleted, the other loops are rediscovered on
+                // the next round of the driver's fixed-point loop
+                changed = true;
+                break;
+            }
+
+            for (const induction_variable &iv : ivs) {
+                changed |= reduce_multiplies(loop, iv);
+            }
+        }
+
+        free_loops(loops);
+    }
+
+    return changed;
+}
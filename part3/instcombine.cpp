@@ -0,0 +1,281 @@
+#include "optimizer.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+// ============================================================================
+// INSTRUCTION COMBINING
+// ============================================================================
+// a table of small rewrite rules, applied in one linear sweep over every
+// block. each rule looks at one instruction and either returns a simpler
+// value to replace it with, or NULL if it doesn't apply. rules for an
+// opcode are tried in table order and the first hit wins.
+//
+// because the sweep goes top to bottom, a value folded early in a block is
+// already a constant when its users further down are visited
+// (icmp slt 10, 20 -> true, then zext true -> 1)
+//
+// adding a pattern = writing one combine_fn and adding a row to the table
+
+typedef LLVMValueRef (*combine_fn)(LLVMValueRef inst, LLVMBuilderRef builder);
+
+struct combine_rule {
+    LLVMOpcode opcode;
+    const char *name;
+    combine_fn apply;
+};
+
+// true if value is the integer constant c
+static bool is_const_value(LLVMValueRef value, long long c) {
+    return LLVMIsAConstantInt(value) && LLVMConstIntGetSExtValue(value) == c;
+}
+
+static LLVMValueRef make_const(LLVMValueRef like, long long value) {
+    return LLVMConstInt(LLVMTypeOf(like), (unsigned long long)value, 1);
+}
+
+// ============================================================================
+// CONSTANT RULES
+// ============================================================================
+
+// add/sub/mul/sdiv/... with two constant operands
+// evaluate_int_binary refuses x/0 and INT_MIN/-1, so those are left alone
+static LLVMValueRef fold_constant_binary(LLVMValueRef inst, LLVMBuilderRef builder) {
+    LLVMValueRef op1 = LLVMGetOperand(inst, 0);
+    LLVMValueRef op2 = LLVMGetOperand(inst, 1);
+    unsigned width = int_width(inst);
+
+    if (width == 0 || !LLVMIsAConstantInt(op1) || !LLVMIsAConstantInt(op2)) {
+        return NULL;
+    }
+
+    long long result;
+    if (!evaluate_int_binary(LLVMGetInstructionOpcode(inst),
+                             LLVMConstIntGetSExtValue(op1), LLVMConstIntGetSExtValue(op2),
+                             width, &result)) {
+        return NULL;
+    }
+    return make_const(inst, result);
+}
+
+// icmp with two constant operands
+static LLVMValueRef fold_constant_icmp(LLVMValueRef inst, LLVMBuilderRef builder) {
+    LLVMValueRef op1 = LLVMGetOperand(inst, 0);
+    LLVMValueRef op2 = LLVMGetOperand(inst, 1);
+    unsigned width = int_width(op1);
+
+    if (width == 0 || !LLVMIsAConstantInt(op1) || !LLVMIsAConstantInt(op2)) {
+        return NULL;
+    }
+
+    bool result = evaluate_int_compare(LLVMGetICmpPredicate(inst),
+                                       LLVMConstIntGetSExtValue(op1),
+                                       LLVMConstIntGetSExtValue(op2), width);
+    return make_const(inst, result ? 1 : 0);
+}
+
+// zext/sext/trunc of a constant
+static LLVMValueRef fold_constant_cast(LLVMValueRef inst, LLVMBuilderRef builder) {
+    LLVMValueRef op = LLVMGetOperand(inst, 0);
+    if (int_width(inst) == 0 || int_width(op) == 0 || !LLVMIsAConstantInt(op)) {
+        return NULL;
+    }
+
+    if (LLVMGetInstructionOpcode(inst) == LLVMZExt) {
+        return LLVMConstInt(LLVMTypeOf(inst), LLVMConstIntGetZExtValue(op), 0);
+    }
+    // sext keeps the sign, trunc just drops high bits
+    return make_const(inst, LLVMConstIntGetSExtValue(op));
+}
+
+// ============================================================================
+// ALGEBRAIC IDENTITIES
+// ============================================================================
+
+// x + 0 -> x, 0 + x -> x
+static LLVMValueRef fold_add_zero(LLVMValueRef inst, LLVMBuilderRef builder) {
+    if (is_const_value(LLVMGetOperand(inst, 1), 0)) return LLVMGetOperand(inst, 0);
+    if (is_const_value(LLVMGetOperand(inst, 0), 0)) return LLVMGetOperand(inst, 1);
+    return NULL;
+}
+
+// x - 0 -> x
+static LLVMValueRef fold_sub_zero(LLVMValueRef inst, LLVMBuilderRef builder) {
+    if (is_const_value(LLVMGetOperand(inst, 1), 0)) return LLVMGetOperand(inst, 0);
+    return NULL;
+}
+
+// x - x -> 0, x ^ x -> 0
+static LLVMValueRef fold_self_cancel(LLVMValueRef inst, LLVMBuilderRef builder) {
+    if (LLVMGetOperand(inst, 0) == LLVMGetOperand(inst, 1)) return make_const(inst, 0);
+    return NULL;
+}
+
+// x & x -> x, x | x -> x
+static LLVMValueRef fold_self_idempotent(LLVMValueRef inst, LLVMBuilderRef builder) {
+    if (LLVMGetOperand(inst, 0) == LLVMGetOperand(inst, 1)) return LLVMGetOperand(inst, 0);
+    return NULL;
+}
+
+// x * 1 -> x, 1 * x -> x
+static LLVMValueRef fold_mul_one(LLVMValueRef inst, LLVMBuilderRef builder) {
+    if (is_const_value(LLVMGetOperand(inst, 1), 1)) return LLVMGetOperand(inst, 0);
+    if (is_const_value(LLVMGetOperand(inst, 0), 1)) return LLVMGetOperand(inst, 1);
+    return NULL;
+}
+
+// x * 0 -> 0, 0 * x -> 0
+static LLVMValueRef fold_mul_zero(LLVMValueRef inst, LLVMBuilderRef builder) {
+    if (is_const_value(LLVMGetOperand(inst, 1), 0)) return LLVMGetOperand(inst, 1);
+    if (is_const_value(LLVMGetOperand(inst, 0), 0)) return LLVMGetOperand(inst, 0);
+    return NULL;
+}
+
+// x / 1 -> x
+static LLVMValueRef fold_div_one(LLVMValueRef inst, LLVMBuilderRef builder) {
+    if (is_const_value(LLVMGetOperand(inst, 1), 1)) return LLVMGetOperand(inst, 0);
+    return NULL;
+}
+
+// icmp pred x, x -> true for eq/le/ge, false for ne/lt/gt
+static LLVMValueRef fold_icmp_self(LLVMValueRef inst, LLVMBuilderRef builder) {
+    if (LLVMGetOperand(inst, 0) != LLVMGetOperand(inst, 1)) {
+        return NULL;
+    }
+    switch (LLVMGetICmpPredicate(inst)) {
+        case LLVMIntEQ: case LLVMIntSLE: case LLVMIntSGE:
+        case LLVMIntULE: case LLVMIntUGE:
+            return make_const(inst, 1);
+        default:
+            return make_const(inst, 0);
+    }
+}
+
+// ============================================================================
+// STRENGTH REDUCTION
+// ============================================================================
+
+// log2 of c if c is a power of two greater than 1, otherwise -1
+static int power_of_two_shift(LLVMValueRef value) {
+    if (!LLVMIsAConstantInt(value)) {
+        return -1;
+    }
+    long long c = LLVMConstIntGetSExtValue(value);
+    if (c <= 1 || (c & (c - 1)) != 0) {
+        return -1;
+    }
+    int k = 0;
+    while ((1LL << k) != c) {
+        k++;
+    }
+    return k;
+}
+
+// x * 2^k -> x << k (either operand order)
+static LLVMValueRef reduce_mul_pow2(LLVMValueRef inst, LLVMBuilderRef builder) {
+    LLVMValueRef x = LLVMGetOperand(inst, 0);
+    int k = power_of_two_shift(LLVMGetOperand(inst, 1));
+    if (k < 0) {
+        x = LLVMGetOperand(inst, 1);
+        k = power_of_two_shift(LLVMGetOperand(inst, 0));
+    }
+    if (k < 0 || LLVMIsAConstantInt(x)) {
+        return NULL;
+    }
+
+    LLVMPositionBuilderBefore(builder, inst);
+    return LLVMBuildShl(builder, x, make_const(inst, k), "");
+}
+
+// ============================================================================
+// RULE TABLE
+// ============================================================================
+// constant folds come first, so fully constant operations never reach the
+// identity and strength reduction rules
+
+static const combine_rule combine_rules[] = {
+    // constant folding
+    { LLVMAdd,   "constant add",        fold_constant_binary },
+    { LLVMSub,   "constant sub",        fold_constant_binary },
+    { LLVMMul,   "constant mul",        fold_constant_binary },
+    { LLVMSDiv,  "constant sdiv",       fold_constant_binary },
+    { LLVMSRem,  "constant srem",       fold_constant_binary },
+    { LLVMShl,   "constant shl",        fold_constant_binary },
+    { LLVMAShr,  "constant ashr",       fold_constant_binary },
+    { LLVMAnd,   "constant and",        fold_constant_binary },
+    { LLVMOr,    "constant or",         fold_constant_binary },
+    { LLVMXor,   "constant xor",        fold_constant_binary },
+    { LLVMICmp,  "constant icmp",       fold_constant_icmp },
+    { LLVMZExt,  "constant zext",       fold_constant_cast },
+    { LLVMSExt,  "constant sext",       fold_constant_cast },
+    { LLVMTrunc, "constant trunc",      fold_constant_cast },
+
+    // algebraic identities
+    { LLVMAdd,   "x + 0",               fold_add_zero },
+    { LLVMSub,   "x - 0",               fold_sub_zero },
+    { LLVMSub,   "x - x",               fold_self_cancel },
+    { LLVMXor,   "x ^ x",               fold_self_cancel },
+    { LLVMAnd,   "x & x",               fold_self_idempotent },
+    { LLVMOr,    "x | x",               fold_self_idempotent },
+    { LLVMMul,   "x * 0",               fold_mul_zero },
+    { LLVMMul,   "x * 1",               fold_mul_one },
+    { LLVMSDiv,  "x / 1",               fold_div_one },
+    { LLVMICmp,  "icmp x, x",           fold_icmp_self },
+
+    // strength reduction
+    { LLVMMul,   "x * 2^k -> shl",      reduce_mul_pow2 },
+};
+
+static const int num_combine_rules = sizeof(combine_rules) / sizeof(combine_rules[0]);
+
+bool instruction_combining(LLVMModuleRef module) {
+    bool changed = false;
+
+    // index the table by opcode once, so each instruction only tries its own rules
+    unordered_map<int, vector<const combine_rule *>> rules_by_opcode;
+    for (int i = 0; i < num_combine_rules; i++) {
+        rules_by_opcode[combine_rules[i].opcode].push_back(&combine_rules[i]);
+    }
+
+    LLVMBuilderRef builder = LLVMCreateBuilder();
+
+    // iterate through all functions
+    for (LLVMValueRef function = LLVMGetFirstFunction(module);
+         function != NULL;
+         function = LLVMGetNextFunction(function)) {
+
+        // iterate through all basic blocks
+        for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+             bb != NULL;
+             bb = LLVMGetNextBasicBlock(bb)) {
+
+            // iterate through instructions (one sweep, top to bottom)
+            LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+            while (inst != NULL) {
+                LLVMValueRef next_inst = LLVMGetNextInstruction(inst);
+
+                auto it = rules_by_opcode.find(LLVMGetInstructionOpcode(inst));
+                if (it != rules_by_opcode.end()) {
+                    for (const combine_rule *rule : it->second) {
+                        LLVMValueRef replacement = rule->apply(inst, builder);
+                        if (replacement == NULL) {
+                            continue;
+                        }
+
+                        // arithmetic has no side effects, drop it right away
+                        LLVMReplaceAllUsesWith(inst, replacement);
+                        LLVMInstructionEraseFromParent(inst);
+                        changed = true;
+                        break;
+                    }
+                }
+
+                inst = next_inst;
+            }
+        }
+    }
+
+    LLVMDisposeBuilder(builder);
+    return changed;
+}
@@ -0,0 +1,262 @@
+#include "optimizer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std;
+
+// ============================================================================
+// IR INTERPRETER
+// ============================================================================
+// runs one function of a module directly on the IR and counts every
+// instruction it executes. this is how the optimizer reports dynamic
+// instruction counts (--count) without a backend: interpret before the
+// passes run, interpret again after, compare.
+//
+// it covers what miniC produces: integer allocas, loads and stores,
+// arithmetic, icmp, casts, select, phi, br and calls to print/read.
+//
+// conditional branches also go through a model of a branch predictor, one
+// 2-bit saturating counter per branch instruction, so passes that remove
+// hard-to-predict branches (--if-convert) show up in the counts
+
+// stop runaway programs (the interpreter has no other way out of a
+// non-terminating loop). the biggest benchmark, nested.c at n = 1000, takes
+// about 15 million, so this leaves room without making a stuck --count wait
+static const long long MAX_STEPS = 100000000LL;
+
+struct interpreter_state {
+    unordered_map<LLVMValueRef, long long> values;   // SSA values
+    unordered_map<LLVMValueRef, long long> memory;   // alloca slots
+    unordered_map<LLVMValueRef, int> predictor;      // 2-bit counter per branch
+    LLVMValueRef argument;
+    long long argument_value;
+    size_t next_input;                               // reads done so far
+};
+
+// the value of the next read(): from stdin the first time it is asked for,
+// from the buffer on every later run
+static long long next_input(interpreter_state &st, interpreter_input *input) {
+    if (st.next_input == input->values.size()) {
+        int x = 0;
+        if (scanf("%d", &x) != 1) {
+            x = 0;
+        }
+        input->values.push_back(x);
+    }
+    return input->values[st.next_input++];
+}
+
+// predict a conditional branch and train the counter on the outcome
+// (0-1 predict not taken, 2-3 taken; new branches start weakly taken)
+static bool predicted_wrong(interpreter_state &st, LLVMValueRef branch, bool taken) {
+    auto it = st.predictor.find(branch);
+    if (it == st.predictor.end()) {
+        it = st.predictor.insert(make_pair(branch, 2)).first;
+    }
+    bool wrong = (it->second >= 2) != taken;
+    if (taken && it->second < 3) {
+        it->second++;
+    } else if (!taken && it->second > 0) {
+        it->second--;
+    }
+    return wrong;
+}
+
+// value of an operand: constant, argument or previously computed instruction
+static bool operand_value(interpreter_state &st, LLVMValueRef value, long long *out) {
+    if (LLVMIsAConstantInt(value)) {
+        *out = LLVMConstIntGetSExtValue(value);
+        return true;
+    }
+    if (LLVMIsUndef(value)) {
+        *out = 0;
+        return true;
+    }
+    if (value == st.argument) {
+        *out = st.argument_value;
+        return true;
+    }
+    auto it = st.values.find(value);
+    if (it == st.values.end()) {
+        fprintf(stderr, "interpreter: use of a value that was never computed\n");
+        return false;
+    }
+    *out = it->second;
+    return true;
+}
+
+bool interpret_function(LLVMValueRef function, long long argument,
+                        interpreter_input *input, interpreter_result *result) {
+    interpreter_state st;
+    st.argument = LLVMCountParams(function) > 0 ? LLVMGetParam(function, 0) : NULL;
+    st.argument_value = argument;
+    st.next_input = 0;
+
+    result->return_value = 0;
+    result->instructions = 0;
+    result->mispredicted = 0;
+    result->printed.clear();
+
+    LLVMBasicBlockRef prev_bb = NULL;
+    LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+    if (bb == NULL) {
+        fprintf(stderr, "interpreter: function has no body\n");
+        return false;
+    }
+
+    while (true) {
+        LLVMBasicBlockRef next_bb = NULL;
+
+        // phis read their inputs all at once, on entry to the block
+        unordered_map<LLVMValueRef, long long> phi_values;
+        LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+        for (; inst != NULL && LLVMIsAPHINode(inst); inst = LLVMGetNextInstruction(inst)) {
+            unsigned count = LLVMCountIncoming(inst);
+            bool found = false;
+            for (unsigned i = 0; i < count; i++) {
+                if (LLVMGetIncomingBlock(inst, i) == prev_bb) {
+                    long long v;
+                    if (!operand_value(st, LLVMGetIncomingValue(inst, i), &v)) {
+                        return false;
+                    }
+                    phi_values[inst] = v;
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) {
+                fprintf(stderr, "interpreter: phi has no entry for the incoming edge\n");
+                return false;
+            }
+            result->instructions++;
+        }
+        for (auto &pair : phi_values) {
+            st.values[pair.first] = pair.second;
+        }
+
+        for (; inst != NULL; inst = LLVMGetNextInstruction(inst)) {
+            if (++result->instructions > MAX_STEPS) {
+                fprintf(stderr, "interpreter: step limit reached\n");
+                return false;
+            }
+
+            LLVMOpcode opcode = LLVMGetInstructionOpcode(inst);
+            unsigned width = int_width(inst);
+            long long a = 0, b = 0, c = 0;
+
+            switch (opcode) {
+                case LLVMAlloca:
+                    st.memory[inst] = 0;
+                    break;
+
+                case LLVMLoad: {
+                    auto it = st.memory.find(get_load_address(inst));
+                    if (it == st.memory.end()) {
+                        fprintf(stderr, "interpreter: load from unknown memory\n");
+                        return false;
+                    }
+                    st.values[inst] = normalize_int(it->second, width);
+                    break;
+                }
+
+                case LLVMStore:
+                    if (!operand_value(st, LLVMGetOperand(inst, 0), &a)) return false;
+                    st.memory[get_store_address(inst)] = a;
+                    break;
+
+                case LLVMAdd: case LLVMSub: case LLVMMul:
+                case LLVMSDiv: case LLVMUDiv: case LLVMSRem: case LLVMURem:
+                case LLVMShl: case LLVMLShr: case LLVMAShr:
+                case LLVMAnd: case LLVMOr: case LLVMXor:
+                    if (!operand_value(st, LLVMGetOperand(inst, 0), &a)) return false;
+                    if (!operand_value(st, LLVMGetOperand(inst, 1), &b)) return false;
+                    if (!evaluate_int_binary(opcode, a, b, width, &c)) {
+                        fprintf(stderr, "interpreter: arithmetic trap\n");
+                        return false;
+                    }
+                    st.values[inst] = c;
+                    break;
+
+                case LLVMICmp: {
+                    LLVMValueRef op1 = LLVMGetOperand(inst, 0);
+                    if (!operand_value(st, op1, &a)) return false;
+                    if (!operand_value(st, LLVMGetOperand(inst, 1), &b)) return false;
+                    st.values[inst] = evaluate_int_compare(LLVMGetICmpPredicate(inst), a, b,
+                                                           int_width(op1)) ? -1 : 0;
+                    break;
+                }
+
+                case LLVMZExt: {
+                    LLVMValueRef op = LLVMGetOperand(inst, 0);
+                    if (!operand_value(st, op, &a)) return false;
+                    unsigned from = int_width(op);
+                    if (from < 64) {
+                        a = (long long)((unsigned long long)a & ((1ULL << from) - 1));
+                    }
+                    st.values[inst] = normalize_int(a, width);
+                    break;
+                }
+
+                case LLVMSExt: case LLVMTrunc:
+                    if (!operand_value(st, LLVMGetOperand(inst, 0), &a)) return false;
+                    st.values[inst] = normalize_int(a, width);
+                    break;
+
+                case LLVMSelect:
+                    if (!operand_value(st, LLVMGetOperand(inst, 0), &a)) return false;
+                    if (!operand_value(st, LLVMGetOperand(inst, a != 0 ? 1 : 2), &b)) return false;
+                    st.values[inst] = b;
+                    break;
+
+                case LLVMCall: {
+                    int num_ops = LLVMGetNumOperands(inst);
+                    LLVMValueRef callee = LLVMGetOperand(inst, num_ops - 1);
+                    size_t len = 0;
+                    const char *name = LLVMGetValueName2(callee, &len);
+
+                    if (strcmp(name, "print") == 0) {
+                        if (!operand_value(st, LLVMGetOperand(inst, 0), &a)) return false;
+                        result->printed.push_back(a);
+                    } else if (strcmp(name, "read") == 0) {
+                        st.values[inst] = next_input(st, input);
+                    } else {
+                        fprintf(stderr, "interpreter: call to unknown function %s\n", name);
+                        return false;
+                    }
+                    break;
+                }
+
+                case LLVMBr:
+                    if (LLVMIsConditional(inst)) {
+                        if (!operand_value(st, LLVMGetCondition(inst), &a)) return false;
+                        next_bb = LLVMGetSuccessor(inst, a != 0 ? 0 : 1);
+                        if (predicted_wrong(st, inst, a != 0)) {
+                            result->mispredicted++;
+                        }
+                    } else {
+                        next_bb = LLVMGetSuccessor(inst, 0);
+                    }
+                    break;
+
+                case LLVMRet:
+                    if (LLVMGetNumOperands(inst) > 0) {
+                        if (!operand_value(st, LLVMGetOperand(inst, 0), &a)) return false;
+                        result->return_value = a;
+                    }
+                    return true;
+
+                default:
+                    fprintf(stderr, "interpreter: unsupported instruction\n");
+                    return false;
+            }
+        }
+
+        if (next_bb == NULL) {
+            fprintf(stderr, "interpreter: block without a branch\n");
+            return false;
+        }
+        prev_bb = bb;
+        bb = next_bb;
+    }
+}
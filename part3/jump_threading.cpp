@@ -0,0 +1,429 @@
+#include "optimizer.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+// ============================================================================
+// JUMP THREADING
+// ============================================================================
+// a branch right after a join often tests something one of the incoming
+// paths already knows:
+//
+//   if (x < 10) s = s + x;          entry: br (x < 10), then, join
+//   print(s);                       then:  ...  br join
+//   if (x < 10) s = s * 2;          join:  print(s)  br (x < 10), t2, f2
+//
+// on the edge then -> join, x < 10 is true, on entry -> join it is false.
+// each such edge gets its own copy of join that ends in a plain branch to
+// the known target, so the second test is never evaluated.
+//
+// what an edge P -> B knows about B's condition:
+//   - a phi of B (or an icmp of B on phis) takes P's incoming values, which
+//     may be constants: the flag in `f = 0; if (..) f = 1; if (f) ..`
+//   - the conditional branches on the chain of single-predecessor blocks
+//     leading to P: their condition is true on one edge and false on the
+//     other, and an icmp with the same operands and the same (or inverse,
+//     or swapped) predicate follows from it
+//
+// B is copied, so only small blocks are threaded (jump_thread_cost), and
+// never loop headers: threading the back edge would duplicate the header
+// into the loop. values of B used elsewhere have two definitions after
+// copying; they go through temporary allocas (stored in both copies,
+// loaded at the uses) that forward_slot_values turns back into phis.
+// B is deleted as soon as every predecessor was threaded, so threading the
+// last one (or the only one) just folds its branch
+//
+// facts are only equalities of SSA values, x < 10 doesn't imply x < 20 here
+
+jump_thread_options jump_thread_cost = {6};
+
+// the value phi receives along the edge from block from
+static LLVMValueRef incoming_from(LLVMValueRef phi, LLVMBasicBlockRef from) {
+    unsigned count = LLVMCountIncoming(phi);
+    for (unsigned i = 0; i < count; i++) {
+        if (LLVMGetIncomingBlock(phi, i) == from) {
+            return LLVMGetIncomingValue(phi, i);
+        }
+    }
+    return NULL;
+}
+
+// number of edges from -> to
+static unsigned count_edges(LLVMBasicBlockRef from, LLVMBasicBlockRef to) {
+    LLVMValueRef term = LLVMGetBasicBlockTerminator(from);
+    unsigned num_succs = LLVMGetNumSuccessors(term);
+    unsigned count = 0;
+    for (unsigned i = 0; i < num_succs; i++) {
+        if (LLVMGetSuccessor(term, i) == to) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// ----------------------------------------------------------------------------
+// what an edge knows
+// ----------------------------------------------------------------------------
+
+// !(a p b) is a p' b
+static LLVMIntPredicate inverse_predicate(LLVMIntPredicate p) {
+    switch (p) {
+        case LLVMIntEQ:  return LLVMIntNE;
+        case LLVMIntNE:  return LLVMIntEQ;
+        case LLVMIntSLT: return LLVMIntSGE;
+        case LLVMIntSGE: return LLVMIntSLT;
+        case LLVMIntSGT: return LLVMIntSLE;
+        case LLVMIntSLE: return LLVMIntSGT;
+        case LLVMIntULT: return LLVMIntUGE;
+        case LLVMIntUGE: return LLVMIntULT;
+        case LLVMIntUGT: return LLVMIntULE;
+        default:         return LLVMIntUGT;   // ULE
+    }
+}
+
+// a p b is b p' a
+static LLVMIntPredicate swapped_predicate(LLVMIntPredicate p) {
+    switch (p) {
+        case LLVMIntSLT: return LLVMIntSGT;
+        case LLVMIntSGT: return LLVMIntSLT;
+        case LLVMIntSLE: return LLVMIntSGE;
+        case LLVMIntSGE: return LLVMIntSLE;
+        case LLVMIntULT: return LLVMIntUGT;
+        case LLVMIntUGT: return LLVMIntULT;
+        case LLVMIntULE: return LLVMIntUGE;
+        case LLVMIntUGE: return LLVMIntULE;
+        default:         return p;            // EQ, NE
+    }
+}
+
+// a phi of bb reads as its incoming value from pred, anything else as itself
+static LLVMValueRef value_on_edge(LLVMValueRef value, LLVMBasicBlockRef bb,
+                                  LLVMBasicBlockRef pred) {
+    if (LLVMIsAPHINode(value) && LLVMGetInstructionParent(value) == bb) {
+        return incoming_from(value, pred);
+    }
+    return value;
+}
+
+// bb's branch condition as seen on the edge from pred: either a value, or
+// an icmp whose operands are taken on the edge
+struct edge_condition {
+    LLVMValueRef value;
+    bool is_compare;
+    LLVMIntPredicate predicate;
+    LLVMValueRef lhs, rhs;
+};
+
+// 1 or 0 if cond is known from `fact is true`, -1 if it isn't
+static int implied_by(const edge_condition &cond, LLVMValueRef fact, bool fact_value) {
+    if (cond.value == fact) {
+        return fact_value;
+    }
+    if (!cond.is_compare || !LLVMIsAICmpInst(fact)) {
+        return -1;
+    }
+
+    LLVMIntPredicate p = LLVMGetICmpPredicate(fact);
+    LLVMValueRef lhs = LLVMGetOperand(fact, 0);
+    LLVMValueRef rhs = LLVMGetOperand(fact, 1);
+    if (cond.lhs == rhs && cond.rhs == lhs) {
+        p = swapped_predicate(p);
+    } else if (cond.lhs != lhs || cond.rhs != rhs) {
+        return -1;
+    }
+
+    if (cond.predicate == p) {
+        return fact_value;
+    }
+    if (cond.predicate == inverse_predicate(p)) {
+        return !fact_value;
+    }
+    return -1;
+}
+
+// 1 if bb's branch goes to successor 0 whenever it is entered from pred,
+// 0 if it goes to successor 1, -1 if that depends on more than the edge
+static int known_outcome(LLVMBasicBlockRef bb, LLVMBasicBlockRef pred,
+                         unordered_map<LLVMBasicBlockRef, vector<LLVMBasicBlockRef>> &preds) {
+    LLVMValueRef cond_value = LLVMGetCondition(LLVMGetBasicBlockTerminator(bb));
+
+    edge_condition cond;
+    cond.value = value_on_edge(cond_value, bb, pred);
+    cond.is_compare = false;
+    if (LLVMIsAConstantInt(cond.value)) {
+        return LLVMConstIntGetZExtValue(cond.value) != 0;
+    }
+
+    // an icmp of bb is evaluated on the edge, one from elsewhere is a fact
+    // like any other
+    if (LLVMIsAICmpInst(cond_value)) {
+        cond.is_compare = true;
+        cond.predicate = LLVMGetICmpPredicate(cond_value);
+        cond.lhs = value_on_edge(LLVMGetOperand(cond_value, 0), bb, pred);
+        cond.rhs = value_on_edge(LLVMGetOperand(cond_value, 1), bb, pred);
+        if (LLVMIsAConstantInt(cond.lhs) && LLVMIsAConstantInt(cond.rhs)) {
+            unsigned width = LLVMGetIntTypeWidth(LLVMTypeOf(cond.lhs));
+            return evaluate_int_compare(cond.predicate, LLVMConstIntGetSExtValue(cond.lhs),
+                                        LLVMConstIntGetSExtValue(cond.rhs), width);
+        }
+    }
+
+    // walk up the chain of single-predecessor blocks: each edge on it
+    // dominates pred -> bb, so whatever it tested still holds
+    LLVMBasicBlockRef to = bb;
+    LLVMBasicBlockRef from = pred;
+    unordered_set<LLVMBasicBlockRef> visited;
+    while (from != bb && visited.insert(from).second) {
+        LLVMValueRef term = LLVMGetBasicBlockTerminator(from);
+        if (LLVMIsABranchInst(term) && LLVMIsConditional(term) &&
+            LLVMGetSuccessor(term, 0) != LLVMGetSuccessor(term, 1)) {
+            int outcome = implied_by(cond, LLVMGetCondition(term),
+                                     LLVMGetSuccessor(term, 0) == to);
+            if (outcome != -1) {
+                return outcome;
+            }
+        }
+
+        if (preds[from].size() != 1) {
+            break;
+        }
+        to = from;
+        from = preds[from][0];
+    }
+    return -1;
+}
+
+// ----------------------------------------------------------------------------
+// threading an edge
+// ----------------------------------------------------------------------------
+
+// bb can be copied: small, and every value it defines for other blocks
+// fits in a forwardable temporary
+static bool is_threadable_block(LLVMBasicBlockRef bb) {
+    LLVMValueRef term = LLVMGetBasicBlockTerminator(bb);
+    if (term == NULL || !LLVMIsABranchInst(term) || !LLVMIsConditional(term) ||
+        LLVMGetSuccessor(term, 0) == LLVMGetSuccessor(term, 1)) {
+        return false;
+    }
+
+    int size = 0;
+    for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+         inst != term;
+         inst = LLVMGetNextInstruction(inst)) {
+        if (LLVMIsAAllocaInst(inst)) {
+            return false;
+        }
+        if (!LLVMIsAPHINode(inst) && ++size > jump_thread_cost.max_block_size) {
+            return false;
+        }
+        if (LLVMGetTypeKind(LLVMTypeOf(inst)) != LLVMIntegerTypeKind &&
+            LLVMGetFirstUse(inst) != NULL) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// first instruction after the phis
+static LLVMValueRef first_non_phi(LLVMBasicBlockRef bb) {
+    LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+    while (LLVMIsAPHINode(inst)) {
+        inst = LLVMGetNextInstruction(inst);
+    }
+    return inst;
+}
+
+// values of bb used outside it (or by a phi, which reads them at the end
+// of a predecessor) are stored to a temporary and loaded where used
+static void demote_escaping_values(LLVMBasicBlockRef bb, unordered_set<LLVMValueRef> &temps) {
+    LLVMValueRef function = LLVMGetBasicBlockParent(bb);
+    LLVMBasicBlockRef entry = LLVMGetFirstBasicBlock(function);
+    LLVMBuilderRef builder = LLVMCreateBuilder();
+
+    // the loads for phis that bb feeds land in bb, so take the list first
+    vector<LLVMValueRef> insts;
+    LLVMValueRef term = LLVMGetBasicBlockTerminator(bb);
+    for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+         inst != term;
+         inst = LLVMGetNextInstruction(inst)) {
+        insts.push_back(inst);
+    }
+
+    for (LLVMValueRef inst : insts) {
+        vector<LLVMValueRef> users;
+        for (LLVMUseRef use = LLVMGetFirstUse(inst); use != NULL; use = LLVMGetNextUse(use)) {
+            LLVMValueRef user = LLVMGetUser(use);
+            if (LLVMIsAPHINode(user) || LLVMGetInstructionParent(user) != bb) {
+                users.push_back(user);
+            }
+        }
+        if (users.empty()) {
+            continue;
+        }
+
+        LLVMTypeRef type = LLVMTypeOf(inst);
+        LLVMPositionBuilderBefore(builder, LLVMGetFirstInstruction(entry));
+        LLVMValueRef temp = LLVMBuildAlloca(builder, type, "");
+        temps.insert(temp);
+
+        LLVMPositionBuilderBefore(builder, LLVMIsAPHINode(inst) ? first_non_phi(bb)
+                                                                : LLVMGetNextInstruction(inst));
+        LLVMBuildStore(builder, inst, temp);
+
+        for (LLVMValueRef user : users) {
+            if (LLVMIsAPHINode(user)) {
+                unsigned count = LLVMCountIncoming(user);
+                for (unsigned k = 0; k < count; k++) {
+                    if (LLVMGetIncomingValue(user, k) == inst) {
+                        LLVMBasicBlockRef from = LLVMGetIncomingBlock(user, k);
+                        LLVMPositionBuilderBefore(builder, LLVMGetBasicBlockTerminator(from));
+                        LLVMSetOperand(user, k, LLVMBuildLoad2(builder, type, temp, ""));
+                    }
+                }
+                continue;
+            }
+
+            int num_ops = LLVMGetNumOperands(user);
+            for (int i = 0; i < num_ops; i++) {
+                if (LLVMGetOperand(user, i) == inst) {
+                    LLVMPositionBuilderBefore(builder, user);
+                    LLVMSetOperand(user, i, LLVMBuildLoad2(builder, type, temp, ""));
+                }
+            }
+        }
+    }
+
+    LLVMDisposeBuilder(builder);
+}
+
+// give pred its own copy of bb that branches straight to target
+static void thread_edge(LLVMBasicBlockRef bb, LLVMBasicBlockRef pred,
+                        LLVMBasicBlockRef target) {
+    LLVMValueRef function = LLVMGetBasicBlockParent(bb);
+    LLVMContextRef context = LLVMGetModuleContext(LLVMGetGlobalParent(function));
+    LLVMBasicBlockRef copy = LLVMAppendBasicBlockInContext(context, function, "");
+    LLVMMoveBasicBlockAfter(copy, bb);
+
+    LLVMBuilderRef builder = LLVMCreateBuilderInContext(context);
+    LLVMPositionBuilderAtEnd(builder, copy);
+
+    // the phis become pred's values, the rest is cloned with its operands
+    // renamed to the copies
+    unordered_map<LLVMValueRef, LLVMValueRef> copies;
+    LLVMValueRef term = LLVMGetBasicBlockTerminator(bb);
+    for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+         inst != term;
+         inst = LLVMGetNextInstruction(inst)) {
+        if (LLVMIsAPHINode(inst)) {
+            copies[inst] = incoming_from(inst, pred);
+            continue;
+        }
+        LLVMValueRef clone = LLVMInstructionClone(inst);
+        int num_ops = LLVMGetNumOperands(clone);
+        for (int i = 0; i < num_ops; i++) {
+            auto it = copies.find(LLVMGetOperand(clone, i));
+            if (it != copies.end()) {
+                LLVMSetOperand(clone, i, it->second);
+            }
+        }
+        // a division's range held for bb's phis, not for what pred sends
+        // them: the copy may trap until --ranges says otherwise
+        set_non_trapping_mark(clone, false);
+        LLVMInsertIntoBuilder(builder, clone);
+        copies[inst] = clone;
+    }
+    LLVMBuildBr(builder, target);
+    LLVMDisposeBuilder(builder);
+
+    // target's phis get the copy's version of what bb sends them
+    for (LLVMValueRef phi = LLVMGetFirstInstruction(target);
+         phi != NULL && LLVMIsAPHINode(phi);
+         phi = LLVMGetNextInstruction(phi)) {
+        LLVMValueRef value = incoming_from(phi, bb);
+        auto it = copies.find(value);
+        if (it != copies.end()) {
+            value = it->second;
+        }
+        LLVMAddIncoming(phi, &value, &copy, 1);
+    }
+
+    retarget_branch(pred, bb, copy);
+    remove_phi_incoming(bb, pred);
+}
+
+// find one edge with a known outcome and thread it
+static bool thread_one_edge(LLVMValueRef function) {
+    unordered_map<LLVMBasicBlockRef, vector<LLVMBasicBlockRef>> preds;
+    compute_predecessors(function, preds);
+    unordered_map<LLVMBasicBlockRef, unordered_set<LLVMBasicBlockRef>> dom;
+    compute_dominators(function, dom);
+
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+
+        if (preds[bb].empty() || !is_threadable_block(bb)) {
+            continue;
+        }
+
+        for (LLVMBasicBlockRef pred : preds[bb]) {
+            // a back edge (bb is a loop header), or one of two edges from
+            // a branch with both arms on bb
+            if (dom[pred].count(bb) || count_edges(pred, bb) != 1) {
+                continue;
+            }
+
+            int outcome = known_outcome(bb, pred, preds);
+            if (outcome == -1) {
+                continue;
+            }
+            LLVMBasicBlockRef target = LLVMGetSuccessor(LLVMGetBasicBlockTerminator(bb),
+                                                        outcome ? 0 : 1);
+            if (target == bb) {
+                continue;
+            }
+
+            unordered_set<LLVMValueRef> temps;
+            demote_escaping_values(bb, temps);
+            thread_edge(bb, pred, target);
+            remove_unreachable_blocks(function);
+            if (!temps.empty()) {
+                forward_slot_values(function, temps);
+                for (LLVMValueRef temp : temps) {
+                    while (LLVMGetFirstUse(temp) != NULL) {
+                        LLVMInstructionEraseFromParent(LLVMGetUser(LLVMGetFirstUse(temp)));
+                    }
+                    LLVMInstructionEraseFromParent(temp);
+                }
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================================================
+// MAIN PASS: jump_threading
+// ============================================================================
+bool jump_threading(LLVMModuleRef module) {
+    bool changed = false;
+
+    // iterate through all functions
+    for (LLVMValueRef function = LLVMGetFirstFunction(module);
+         function != NULL;
+         function = LLVMGetNextFunction(function)) {
+
+        if (LLVMGetFirstBasicBlock(function) == NULL) {
+            continue;
+        }
+
+        // one edge at a time, each one changes the cfg and the phis the
+        // next one looks at
+        while (thread_one_edge(function)) {
+            changed = true;
+        }
+    }
+
+    return changed;
+}
@@ -0,0 +1,280 @@
+#include "optimizer.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+// ============================================================================
+// LOOP-INVARIANT CODE MOTION
+// ============================================================================
+// for every loop, innermost first:
+//   - hoist: pure instructions whose operands are all defined outside the
+//     loop, and loads from allocas that nothing inside the loop may write
+//     (alias.cpp), move to the end of the preheader (created only when there is
+//     something to hoist). these never trap, so it is
+//     fine to run them even if the loop body would not have
+//   - sink: a store to a promotable alloca that the loop never reads, that
+//     is the loop's only store to it, and that executes on every path to
+//     every loop exit, moves into the exit blocks
+//
+// hoisting out of an inner loop lands in its preheader, which is part of
+// the outer loop, so the outer loop gets a chance to hoist it again
+
+// true if inst has no side effects and can't trap
+static bool is_hoistable_opcode(LLVMValueRef inst) {
+    switch (LLVMGetInstructionOpcode(inst)) {
+        case LLVMAdd: case LLVMSub: case LLVMMul:
+        case LLVMShl: case LLVMLShr: case LLVMAShr:
+        case LLVMAnd: case LLVMOr: case LLVMXor:
+        case LLVMICmp: case LLVMZExt: case LLVMSExt: case LLVMTrunc:
+        case LLVMSelect:
+            return true;
+
+        case LLVMSDiv: case LLVMSRem:
+            // a constant divisor other than 0 and -1, or a range-analysis mark
+            return is_safe_constant_divisor(inst) || has_non_trapping_mark(inst);
+
+        default:
+            return false;
+    }
+}
+
+// true if value is computed outside the loop (or is already being hoisted)
+static bool defined_outside(loop_info *loop, const unordered_set<LLVMValueRef> &hoisted,
+                            LLVMValueRef value) {
+    if (!LLVMIsAInstruction(value)) {
+        return true;
+    }
+    return !loop->blocks.count(LLVMGetInstructionParent(value)) || hoisted.count(value);
+}
+
+// move invariant instructions to the preheader
+static bool hoist_invariants(loop_info *loop) {
+    LLVMValueRef function = LLVMGetBasicBlockParent(loop->header);
+
+    // instructions inside the loop that may write memory; a load is not
+    // invariant if one of them may write its address
+    vector<LLVMValueRef> writers;
+    for (LLVMBasicBlockRef bb : loop->blocks) {
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+             inst != NULL;
+             inst = LLVMGetNextInstruction(inst)) {
+            if (LLVMIsAStoreInst(inst) || LLVMIsACallInst(inst)) {
+                writers.push_back(inst);
+            }
+        }
+    }
+
+    // step 1: collect invariants until no more are found. an instruction is
+    // only added once its operands are outside the loop or already in the
+    // list, so the list is in a valid order to re-insert
+    vector<LLVMValueRef> to_hoist;
+    unordered_set<LLVMValueRef> hoisted;
+
+    bool found = true;
+    while (found) {
+        found = false;
+
+        for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+             bb != NULL;
+             bb = LLVMGetNextBasicBlock(bb)) {
+
+            if (!loop->blocks.count(bb)) {
+                continue;
+            }
+
+            for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+                 inst != NULL;
+                 inst = LLVMGetNextInstruction(inst)) {
+
+                if (hoisted.count(inst)) {
+                    continue;
+                }
+
+                bool invariant = false;
+                if (LLVMIsALoadInst(inst)) {
+                    // an alloca can always be loaded from, even on a path
+                    // where the loop would not have run
+                    LLVMValueRef addr = get_load_address(inst);
+                    invariant = LLVMIsAAllocaInst(addr) != NULL;
+                    for (LLVMValueRef writer : writers) {
+                        if (get_mod_ref(writer, addr) & MR_MOD) {
+                            invariant = false;
+                            break;
+                        }
+                    }
+                } else if (is_hoistable_opcode(inst)) {
+                    invariant = true;
+                    int num_ops = LLVMGetNumOperands(inst);
+                    for (int i = 0; i < num_ops; i++) {
+                        if (!defined_outside(loop, hoisted, LLVMGetOperand(inst, i))) {
+                            invariant = false;
+                            break;
+                        }
+                    }
+
+                    // the range behind a marked division was computed
+                    // where its divisor is now, it doesn't follow it
+                    if (invariant &&
+                        (LLVMGetInstructionOpcode(inst) == LLVMSDiv ||
+                         LLVMGetInstructionOpcode(inst) == LLVMSRem) &&
+                        !is_safe_constant_divisor(inst) &&
+                        hoisted.count(LLVMGetOperand(inst, 1))) {
+                        invariant = false;
+                    }
+                }
+
+                if (invariant) {
+                    to_hoist.push_back(inst);
+                    hoisted.insert(inst);
+                    found = true;
+                }
+            }
+        }
+    }
+
+    if (to_hoist.empty()) {
+        return false;
+    }
+
+    // step 2: move them, in order, to the end of the preheader
+    LLVMBasicBlockRef preheader = ensure_preheader(loop);
+    LLVMBuilderRef builder = LLVMCreateBuilder();
+    LLVMPositionBuilderBefore(builder, LLVMGetBasicBlockTerminator(preheader));
+
+    for (LLVMValueRef inst : to_hoist) {
+        LLVMInstructionRemoveFromParent(inst);
+        LLVMInsertIntoBuilder(builder, inst);
+    }
+
+    LLVMDisposeBuilder(builder);
+    return true;
+}
+
+// move stores whose value is only observed after the loop into the exits
+static bool sink_stores(loop_info *loop) {
+    bool changed = false;
+
+    LLVMValueRef function = LLVMGetBasicBlockParent(loop->header);
+    unordered_map<LLVMBasicBlockRef, unordered_set<LLVMBasicBlockRef>> dom;
+    unordered_map<LLVMBasicBlockRef, vector<LLVMBasicBlockRef>> preds;
+    compute_dominators(function, dom);
+    compute_predecessors(function, preds);
+
+    vector<LLVMBasicBlockRef> exits;
+    get_exit_blocks(loop, exits);
+    if (exits.empty()) {
+        return false;
+    }
+
+    // every exit must be entered only from inside the loop
+    for (LLVMBasicBlockRef exit : exits) {
+        for (LLVMBasicBlockRef pred : preds[exit]) {
+            if (!loop->blocks.count(pred)) {
+                return false;
+            }
+        }
+    }
+
+    // blocks inside the loop that branch out of it
+    vector<LLVMBasicBlockRef> exiting;
+    for (LLVMBasicBlockRef bb : loop->blocks) {
+        LLVMValueRef term = LLVMGetBasicBlockTerminator(bb);
+        unsigned num_succs = LLVMGetNumSuccessors(term);
+        for (unsigned i = 0; i < num_succs; i++) {
+            if (!loop->blocks.count(LLVMGetSuccessor(term, i))) {
+                exiting.push_back(bb);
+                break;
+            }
+        }
+    }
+
+    // count loads and stores per slot inside the loop
+    unordered_map<LLVMValueRef, int> loads;
+    unordered_map<LLVMValueRef, vector<LLVMValueRef>> stores;
+    vector<LLVMValueRef> slots;
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+
+        if (!loop->blocks.count(bb)) {
+            continue;
+        }
+
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+             inst != NULL;
+             inst = LLVMGetNextInstruction(inst)) {
+            if (LLVMIsALoadInst(inst)) {
+                loads[get_load_address(inst)]++;
+            } else if (LLVMIsAStoreInst(inst)) {
+                LLVMValueRef addr = get_store_address(inst);
+                if (stores[addr].empty()) {
+                    slots.push_back(addr);
+                }
+                stores[addr].push_back(inst);
+            }
+        }
+    }
+
+    for (LLVMValueRef addr : slots) {
+        if (stores[addr].size() != 1 || loads[addr] != 0 || !is_promotable_alloca(addr)) {
+            continue;
+        }
+
+        LLVMValueRef store = stores[addr][0];
+        LLVMBasicBlockRef store_bb = LLVMGetInstructionParent(store);
+
+        bool on_every_exit_path = true;
+        for (LLVMBasicBlockRef bb : exiting) {
+            if (!dom[bb].count(store_bb)) {
+                on_every_exit_path = false;
+                break;
+            }
+        }
+        if (!on_every_exit_path) {
+            continue;
+        }
+
+        // the last value stored is what the exits see
+        LLVMBuilderRef builder = LLVMCreateBuilder();
+        for (LLVMBasicBlockRef exit : exits) {
+            LLVMValueRef first = LLVMGetFirstInstruction(exit);
+            while (LLVMIsAPHINode(first)) {
+                first = LLVMGetNextInstruction(first);
+            }
+            LLVMPositionBuilderBefore(builder, first);
+            LLVMInsertIntoBuilder(builder, LLVMInstructionClone(store));
+        }
+        LLVMDisposeBuilder(builder);
+
+        LLVMInstructionEraseFromParent(store);
+        changed = true;
+    }
+
+    return changed;
+}
+
+bool loop_invariant_code_motion(LLVMModuleRef module) {
+    bool changed = false;
+
+    // iterate through all functions
+    for (LLVMValueRef function = LLVMGetFirstFunction(module);
+         function != NULL;
+         function = LLVMGetNextFunction(function)) {
+
+        recheck_non_trapping_marks(function);
+
+        vector<loop_info *> loops;
+        find_loops(function, loops);
+
+        // innermost loops first
+        for (loop_info *loop : loops) {
+            changed |= hoist_invariants(loop);
+            changed |= sink_stores(loop);
+        }
+
+        free_loops(loops);
+    }
+
+    return changed;
+}
@@ -0,0 +1,214 @@
+#include "optimizer.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+
+using namespace std;
+
+// ============================================================================
+// NATURAL LOOP DETECTION
+// ============================================================================
+// a back edge is an edge T -> H where H dominates T. the natural loop of
+// that edge is H plus every block that can reach T without going through H.
+// back edges that share a header form one loop (miniC `while` loops have a
+// single latch, but `if` inside the body can give more after cfg cleanup).
+//
+// loops are nested by containment: the parent of a loop is the smallest
+// other loop whose blocks include its header
+
+static bool loop_is_smaller(const loop_info *a, const loop_info *b) {
+    return a->blocks.size() < b->blocks.size();
+}
+
+void find_loops(LLVMValueRef function, vector<loop_info *> &loops) {
+    loops.clear();
+
+    if (LLVMGetFirstBasicBlock(function) == NULL) {
+        return;
+    }
+
+    unordered_map<LLVMBasicBlockRef, unordered_set<LLVMBasicBlockRef>> dom;
+    unordered_map<LLVMBasicBlockRef, vector<LLVMBasicBlockRef>> preds;
+    compute_dominators(function, dom);
+    compute_predecessors(function, preds);
+
+    unordered_map<LLVMBasicBlockRef, loop_info *> by_header;
+
+    // step 1: find back edges and grow the loop body backwards from the latch
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+
+        LLVMValueRef term = LLVMGetBasicBlockTerminator(bb);
+        if (term == NULL) {
+            continue;
+        }
+
+        unsigned num_succs = LLVMGetNumSuccessors(term);
+        for (unsigned i = 0; i < num_succs; i++) {
+            LLVMBasicBlockRef header = LLVMGetSuccessor(term, i);
+            if (!dom[bb].count(header)) {
+                continue; // not a back edge
+            }
+
+            loop_info *loop = by_header[header];
+            if (loop == NULL) {
+                loop = new loop_info();
+                loop->header = header;
+                loop->parent = NULL;
+                loop->depth = 1;
+                loop->blocks.insert(header);
+                by_header[header] = loop;
+                loops.push_back(loop);
+            }
+            if (find(loop->latches.begin(), loop->latches.end(), bb) == loop->latches.end()) {
+                loop->latches.push_back(bb);
+            }
+
+            vector<LLVMBasicBlockRef> stack;
+            if (loop->blocks.insert(bb).second) {
+                stack.push_back(bb);
+            }
+            while (!stack.empty()) {
+                LLVMBasicBlockRef node = stack.back();
+                stack.pop_back();
+                for (LLVMBasicBlockRef pred : preds[node]) {
+                    if (loop->blocks.insert(pred).second) {
+                        stack.push_back(pred);
+                    }
+                }
+            }
+        }
+    }
+
+    // step 2: the parent of each loop is the smallest loop containing its header
+    stable_sort(loops.begin(), loops.end(), loop_is_smaller);
+    for (size_t i = 0; i < loops.size(); i++) {
+        for (size_t j = i + 1; j < loops.size(); j++) {
+            if (loops[j]->blocks.count(loops[i]->header) && loops[j] != loops[i]) {
+                loops[i]->parent = loops[j];
+                loops[j]->children.push_back(loops[i]);
+                break;
+            }
+        }
+    }
+
+    // step 3: depth = number of enclosing loops (outermost is 1)
+    for (loop_info *loop : loops) {
+        loop->depth = 1;
+        for (loop_info *p = loop->parent; p != NULL; p = p->parent) {
+            loop->depth++;
+        }
+    }
+
+    // loops come out innermost first, so a pass can handle inner loops
+    // before the loops that contain them
+}
+
+void free_loops(vector<loop_info *> &loops) {
+    for (loop_info *loop : loops) {
+        delete loop;
+    }
+    loops.clear();
+}
+
+// ============================================================================
+// HELPER FUNCTION: get_exit_blocks
+// ============================================================================
+// blocks outside the loop that a block inside the loop branches to
+void get_exit_blocks(loop_info *loop, vector<LLVMBasicBlockRef> &exits) {
+    exits.clear();
+
+    LLVMValueRef function = LLVMGetBasicBlockParent(loop->header);
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+
+        if (!loop->blocks.count(bb)) {
+            continue;
+        }
+
+        LLVMValueRef term = LLVMGetBasicBlockTerminator(bb);
+        unsigned num_succs = LLVMGetNumSuccessors(term);
+        for (unsigned i = 0; i < num_succs; i++) {
+            LLVMBasicBlockRef succ = LLVMGetSuccessor(term, i);
+            if (!loop->blocks.count(succ) &&
+                find(exits.begin(), exits.end(), succ) == exits.end()) {
+                exits.push_back(succ);
+            }
+        }
+    }
+}
+
+// ============================================================================
+// HELPER FUNCTION: ensure_preheader
+// ============================================================================
+// returns the loop's preheader: the one block outside the loop that branches
+// to the header and nowhere else. if there isn't one, a new block is placed
+// before the header and every entry edge is routed through it (header phis
+// get their outside values from the new block)
+LLVMBasicBlockRef ensure_preheader(loop_info *loop) {
+    LLVMBasicBlockRef header = loop->header;
+    LLVMValueRef function = LLVMGetBasicBlockParent(header);
+
+    unordered_map<LLVMBasicBlockRef, vector<LLVMBasicBlockRef>> preds;
+    compute_predecessors(function, preds);
+
+    vector<LLVMBasicBlockRef> outside;
+    for (LLVMBasicBlockRef pred : preds[header]) {
+        if (!loop->blocks.count(pred)) {
+            outside.push_back(pred);
+        }
+    }
+
+    // already have one
+    if (outside.size() == 1 &&
+        LLVMGetNumSuccessors(LLVMGetBasicBlockTerminator(outside[0])) == 1) {
+        return outside[0];
+    }
+
+    LLVMContextRef context = LLVMGetModuleContext(LLVMGetGlobalParent(function));
+    LLVMBasicBlockRef preheader = LLVMInsertBasicBlockInContext(context, header, "");
+    LLVMBuilderRef builder = LLVMCreateBuilder();
+
+    // header phis: the outside entries collapse into one phi in the preheader
+    LLVMPositionBuilderAtEnd(builder, preheader);
+    for (LLVMValueRef phi = LLVMGetFirstInstruction(header);
+         phi != NULL && LLVMIsAPHINode(phi);
+         phi = LLVMGetNextInstruction(phi)) {
+
+        LLVMValueRef outside_phi = LLVMBuildPhi(builder, LLVMTypeOf(phi), "");
+        unsigned count = LLVMCountIncoming(phi);
+        for (unsigned i = 0; i < count; i++) {
+            LLVMBasicBlockRef from = LLVMGetIncomingBlock(phi, i);
+            if (!loop->blocks.count(from)) {
+                LLVMValueRef value = LLVMGetIncomingValue(phi, i);
+                LLVMAddIncoming(outside_phi, &value, &from, 1);
+            }
+        }
+        LLVMBasicBlockRef from = preheader;
+        LLVMAddIncoming(phi, &outside_phi, &from, 1);
+    }
+    LLVMBuildBr(builder, header);
+    LLVMDisposeBuilder(builder);
+
+    for (LLVMBasicBlockRef pred : outside) {
+        remove_phi_incoming(header, pred);
+
+        LLVMValueRef term = LLVMGetBasicBlockTerminator(pred);
+        unsigned num_succs = LLVMGetNumSuccessors(term);
+        for (unsigned i = 0; i < num_succs; i++) {
+            if (LLVMGetSuccessor(term, i) == header) {
+                LLVMSetSuccessor(term, i, preheader);
+            }
+        }
+    }
+
+    // the preheader sits inside every loop that encloses this one
+    for (loop_info *p = loop->parent; p != NULL; p = p->parent) {
+        p->blocks.insert(preheader);
+    }
+
+    return preheader;
+}
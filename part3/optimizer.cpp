@@ -160,6 +160,16 @@ bool instructions_equal(LLVMValueRef inst1, LLVMValueRef inst2) {
         return false;
     }
     
+    // icmp slt %a, %b and icmp sgt %a, %b share opcode and operands,
+    // zext %a to i32 and zext %a to i64 too
+    if (LLVMGetInstructionOpcode(inst1) == LLVMICmp &&
+        LLVMGetICmpPredicate(inst1) != LLVMGetICmpPredicate(inst2)) {
+        return false;
+    }
+    if (LLVMTypeOf(inst1) != LLVMTypeOf(inst2)) {
+        return false;
+    }
+    
     // check if they have the same number of operands
     int num_ops = LLVMGetNumOperands(inst1);
     if (num_ops != LLVMGetNumOperands(inst2)) {
@@ -220,7 +230,7 @@ bool common_subexpression_elimination(LLVMModuleRef module) {
                     if (instructions_equal(inst_a, inst_b)) {
                         
                         // SPECIAL CASE: if both are load instructions
-                        // need to check if a store happened between them
+                        // need to check if memory changed between them
                         if (LLVMGetInstructionOpcode(inst_a) == LLVMLoad) {
                             bool safe = true;
                             LLVMValueRef load_addr = LLVMGetOperand(inst_a, 0);
@@ -230,13 +240,11 @@ bool common_subexpression_elimination(LLVMModuleRef module) {
                                  between != inst_b && between != NULL;
                                  between = LLVMGetNextInstruction(between)) {
                                 
-                                // if there's a store to the same address, not safe!
-                                if (LLVMGetInstructionOpcode(between) == LLVMStore) {
-                                    LLVMValueRef store_addr = LLVMGetOperand(between, 1);
-                                    if (store_addr == load_addr) {
-                                        safe = false;
-                                        break;
-                                    }
+                                // a store that may alias the address, or a call
+                                // that may write it, is not safe!
+                                if (get_mod_ref(between, load_addr) & MR_MOD) {
+                                    safe = false;
+                                    break;
                                 }
                             }
                             
@@ -445,6 +453,6 @@ bool stores_to_same_address(LLVMValueRef store1, LLVMValueRef store2) {
     LLVMValueRef addr1 = get_store_address(store1);
     LLVMValueRef addr2 = get_store_address(store2);
 
-    // compare addresses for pointer equality
-    return addr1 == addr2;
+    // only a store to the very same location overwrites the other
+    return alias(addr1, addr2) == MUST_ALIAS;
 }
\ No newline at end of file
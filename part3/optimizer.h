@@ -5,6 +5,10 @@
 #include <llvm-c/IRReader.h>
 #include <llvm-c/Types.h>
 
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 // ============================================================================
 // LOCAL OPTIMIZATIONS
 // ============================================================================
@@ -18,6 +22,15 @@ bool constant_folding(LLVMModuleRef module);
 // common subexpression elimination: removes duplicate calculations
 bool common_subexpression_elimination(LLVMModuleRef module);
 
+// instruction combining: table of local rewrites (constant icmp/sdiv/zext,
+// x+0, x*1, x*0, x-x, x/1, x*2^k -> shl) applied in one sweep
+bool instruction_combining(LLVMModuleRef module);
+
+// division by constants: x / c and x % c on i32 and narrower become a
+// multiply by a magic number keeping the high half, shifts and a fixup
+// (shift with rounding when |c| is a power of two)
+bool division_by_constant(LLVMModuleRef module);
+
 // ============================================================================
 // GLOBAL OPTIMIZATION 
 // ============================================================================
@@ -25,6 +38,111 @@ bool common_subexpression_elimination(LLVMModuleRef module);
 // constant propagation: tracks constants through store/load instructions
 bool constant_propagation(LLVMModuleRef module);
 
+// sparse conditional constant propagation: finds constants and unreachable
+// blocks together, folds branches on constant conditions and deletes dead arms
+bool sparse_conditional_constant_propagation(LLVMModuleRef module);
+
+// value range analysis: tracks a signed interval per integer value, narrowed
+// by the branches that guard it and widened at loop merge points, folds the
+// compares it decides and marks divisions that can't trap
+bool value_range_analysis(LLVMModuleRef module);
+
+// solve the ranges again and drop the can't-trap marks the current divisors
+// no longer earn (it never adds one): for passes that trust the marks
+void recheck_non_trapping_marks(LLVMValueRef function);
+
+// cfg simplification: folds constant branches, removes unreachable blocks,
+// threads empty forwarding blocks and merges straight-line block chains
+bool cfg_simplification(LLVMModuleRef module);
+
+// dead store elimination: deletes stores to local variables that are
+// overwritten (or the function returns) before any load, found with
+// backwards liveness, and allocas that are only ever stored to
+bool dead_store_elimination(LLVMModuleRef module);
+
+// store-to-load forwarding: replaces loads of local variables with the value
+// last stored or loaded on every path to them, adding phis at joins where
+// the paths disagree
+bool store_to_load_forwarding(LLVMModuleRef module);
+
+// partial redundancy elimination: lazy code motion moves pure computations
+// to the latest points where every path needs them, removing computations
+// that were already done on some of the paths into a join
+bool partial_redundancy_elimination(LLVMModuleRef module);
+
+// code hoisting and sinking: an instruction that starts every successor of
+// a branch moves above it, one that ends every predecessor of a join moves
+// into the join, so identical if/else arms become empty
+bool code_hoisting_sinking(LLVMModuleRef module);
+
+// loop-invariant code motion: hoists invariant computations and loads of
+// slots the loop never writes into the preheader, sinks stores to the exits
+bool loop_invariant_code_motion(LLVMModuleRef module);
+
+// induction variables: strength-reduces multiplies of a loop counter to an
+// add per iteration, and replaces counting loops that only accumulate
+// affine sums with their closed form
+bool induction_variable_optimization(LLVMModuleRef module);
+
+// loop unrolling: innermost counting loops with a small constant trip count
+// are unrolled completely, others run several bodies per test ahead of a
+// remainder loop (sizes are limited by unroll_cost)
+bool loop_unrolling(LLVMModuleRef module);
+
+// size limits for loop unrolling, counted in IR instructions
+struct unroll_options {
+    int full_max_trips;     // fully unroll loops that run at most this often
+    int full_max_size;      // ... and whose trips * body size fits in this
+    int partial_factor;     // otherwise run this many bodies per test
+    int partial_max_size;   // ... if factor * body size fits in this
+};
+extern unroll_options unroll_cost;
+
+// if-conversion: small if/else diamonds and triangles whose arms only
+// compute values run both arms and pick the result with select
+bool if_conversion(LLVMModuleRef module);
+
+// limits for if-conversion
+struct if_convert_options {
+    int max_arm_size;       // instructions per arm run on every path
+    int max_selects;        // phis at the join turned into selects
+};
+extern if_convert_options if_convert_cost;
+
+// jump threading: an edge into a small block whose branch it already
+// decides (a constant phi input, or a condition tested on the way there)
+// gets its own copy of the block that jumps straight to the known target
+bool jump_threading(LLVMModuleRef module);
+
+// limits for jump threading
+struct jump_thread_options {
+    int max_block_size;     // largest block copied, phis and branch not counted
+};
+extern jump_thread_options jump_thread_cost;
+
+// ============================================================================
+// PASS PIPELINE (pipeline.cpp)
+// ============================================================================
+
+// take the pipeline option at argv[*i] (a pass flag, a pass limit or
+// --count <n>), moving *i past its value; false if it isn't one of them
+bool parse_pipeline_option(int argc, char **argv, int *i);
+
+// true if an enabled pass (--indvars, --unroll) only recognises loop
+// counters that live in allocas, read by a load in the loop header: a
+// front end that builds SSA should build allocas instead, or the pass
+// finds no loop to change
+bool pipeline_needs_allocas();
+
+// the pipeline options, one line each, for usage messages (stderr)
+void print_pipeline_options();
+
+// run the default passes and the enabled optional ones until nothing
+// changes. with --count the first function is interpreted before and after
+// and the counts go to stderr; false if it can't be interpreted or the
+// results differ
+bool optimize_module(LLVMModuleRef module);
+
 // ============================================================================
 // HELPER FUNCTIONS
 // ============================================================================
@@ -52,4 +170,163 @@ LLVMValueRef get_load_address(LLVMValueRef inst);
 // check if two store instructions write to the same address
 bool stores_to_same_address(LLVMValueRef store1, LLVMValueRef store2);
 
+// ============================================================================
+// ANALYSIS HELPERS (analysis.cpp)
+// ============================================================================
+
+// check if an alloca is only used as the address of loads and stores
+bool is_promotable_alloca(LLVMValueRef alloca);
+
+// map each block to the blocks that branch to it
+void compute_predecessors(LLVMValueRef function,
+                          std::unordered_map<LLVMBasicBlockRef, std::vector<LLVMBasicBlockRef>> &preds);
+
+// remove the incoming entries for pred from every phi in bb
+void remove_phi_incoming(LLVMBasicBlockRef bb, LLVMBasicBlockRef pred);
+
+// make the phis in bb take old_pred's incoming values from new_pred instead
+void replace_phi_incoming_block(LLVMBasicBlockRef bb, LLVMBasicBlockRef old_pred,
+                                LLVMBasicBlockRef new_pred);
+
+// make every branch from `from` to old_target go to new_target (phis untouched)
+void retarget_branch(LLVMBasicBlockRef from, LLVMBasicBlockRef old_target,
+                     LLVMBasicBlockRef new_target);
+
+// replace a terminator with an unconditional branch, fixing successor phis
+void make_branch_unconditional(LLVMValueRef term, LLVMBasicBlockRef target);
+
+// delete every block of the function that is not in live
+bool delete_dead_blocks(LLVMValueRef function,
+                        const std::unordered_set<LLVMBasicBlockRef> &live);
+
+// delete every block the entry block can't reach
+bool remove_unreachable_blocks(LLVMValueRef function);
+
+// map each load from a promotable alloca to the stores that may reach it
+void compute_reaching_stores(LLVMValueRef function,
+                             std::unordered_map<LLVMValueRef, std::unordered_set<LLVMValueRef>> &reaching);
+
+// map each block to the set of blocks that dominate it
+void compute_dominators(LLVMValueRef function,
+                        std::unordered_map<LLVMBasicBlockRef, std::unordered_set<LLVMBasicBlockRef>> &dom);
+
+// integer width of a value, or 0 if it isn't a (<= 64 bit) integer
+unsigned int_width(LLVMValueRef value);
+
+// sign-extend the low width bits of an integer constant
+long long normalize_int(long long value, unsigned width);
+
+// evaluate add/sub/mul/div/rem/shift/logic on constants (false if undefined)
+bool evaluate_int_binary(LLVMOpcode opcode, long long lhs, long long rhs,
+                         unsigned width, long long *result);
+
+// evaluate an icmp predicate on constants
+bool evaluate_int_compare(LLVMIntPredicate predicate, long long lhs, long long rhs,
+                          unsigned width);
+
+// check if an sdiv/srem divides by a constant other than 0 and -1
+bool is_safe_constant_divisor(LLVMValueRef inst);
+
+// check if value range analysis marked an sdiv/srem as unable to trap: its
+// divisor is neither 0 nor -1 (which holds where the divisor is computed
+// now, not if it moves: passes that copy a division drop the mark on the
+// copy, and --ranges decides again. nor after the divisor is replaced,
+// which is why the passes that trust it call recheck_non_trapping_marks)
+bool has_non_trapping_mark(LLVMValueRef inst);
+
+// add or remove that mark, returns true if it changed
+bool set_non_trapping_mark(LLVMValueRef inst, bool marked);
+
+// store-to-load forwarding helpers (forwarding.cpp)
+
+// check if a promotable alloca is only loaded and stored with its own integer type
+bool is_forwardable_slot(LLVMValueRef slot);
+
+// forward stored values to the loads of these forwardable slots of function
+bool forward_slot_values(LLVMValueRef function,
+                         const std::unordered_set<LLVMValueRef> &slots);
+
+// ============================================================================
+// ALIAS ANALYSIS (alias.cpp)
+// ============================================================================
+
+enum alias_result { NO_ALIAS, MAY_ALIAS, MUST_ALIAS };
+
+// what an instruction may do to a memory location (a bit set)
+enum mod_ref_result { MR_NONE = 0, MR_REF = 1, MR_MOD = 2, MR_MOD_REF = 3 };
+
+// the alloca, global or other value a pointer is derived from
+// (looks through getelementptr and bitcast)
+LLVMValueRef underlying_object(LLVMValueRef ptr);
+
+// check if an alloca's address is only used by loads and stores (possibly
+// through getelementptr/bitcast), so no call or foreign pointer can reach it
+bool is_non_escaping_alloca(LLVMValueRef alloca);
+
+// can the two pointers refer to the same memory?
+alias_result alias(LLVMValueRef ptr1, LLVMValueRef ptr2);
+
+// may inst read (MR_REF) or write (MR_MOD) the memory ptr points to?
+mod_ref_result get_mod_ref(LLVMValueRef inst, LLVMValueRef ptr);
+
+// ============================================================================
+// LOOP ANALYSIS (loops.cpp)
+// ============================================================================
+
+// a natural loop: the header plus every block that reaches a latch
+// (a block with a back edge to the header) without passing the header
+struct loop_info {
+    LLVMBasicBlockRef header;
+    std::unordered_set<LLVMBasicBlockRef> blocks;
+    std::vector<LLVMBasicBlockRef> latches;
+    loop_info *parent;                  // innermost enclosing loop, or NULL
+    std::vector<loop_info *> children;  // loops nested directly inside
+    int depth;                          // 1 for outermost loops
+};
+
+// find every natural loop of a function, innermost loops first
+void find_loops(LLVMValueRef function, std::vector<loop_info *> &loops);
+
+// free the loops returned by find_loops
+void free_loops(std::vector<loop_info *> &loops);
+
+// blocks outside the loop that the loop branches to
+void get_exit_blocks(loop_info *loop, std::vector<LLVMBasicBlockRef> &exits);
+
+// return the loop's preheader, creating one if needed
+LLVMBasicBlockRef ensure_preheader(loop_info *loop);
+
+// a basic induction variable: a promotable alloca whose only store in the
+// loop is slot = load(slot) + step, executed once on every iteration
+struct induction_variable {
+    LLVMValueRef slot;
+    LLVMValueRef update;    // the store
+    long long step;
+};
+
+// find the basic induction variables of a loop (induction.cpp)
+void find_induction_variables(loop_info *loop, std::vector<induction_variable> &ivs);
+
+// ============================================================================
+// IR INTERPRETER (interpreter.cpp)
+// ============================================================================
+
+struct interpreter_result {
+    long long return_value;
+    long long instructions;         // dynamic instruction count
+    long long mispredicted;         // conditional branches a 2-bit predictor got wrong
+    std::vector<long long> printed; // values passed to print()
+};
+
+// what read() returns, in order: read from stdin once, replayed by every
+// run that shares it
+struct interpreter_input {
+    std::vector<long long> values;
+};
+
+// run function(argument) on the IR itself (false on an unsupported
+// instruction, a trap or a runaway loop)
+bool interpret_function(LLVMValueRef function, long long argument,
+                        interpreter_input *input, interpreter_result *result);
+
 #endif
\ No newline at end of file
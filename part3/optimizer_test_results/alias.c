@@ -0,0 +1,15 @@
+extern void print(int);
+extern int read();
+extern void update(int *);
+
+int func(int i){
+	int a;
+	int b;
+
+	a = i;
+	b = i;
+	print(a + b);
+	update(&b);
+	print(a + b);
+	return (a + b);
+}
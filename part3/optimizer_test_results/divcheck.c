@@ -0,0 +1,68 @@
+extern void print(int);
+extern int read();
+
+int func(int n){
+	int i;
+	int x;
+
+	i = 0;
+	while (i < n){
+		x = read();
+		print(x / 3);
+		print(x % 3);
+		print(x / 5);
+		print(x % 5);
+		print(x / 6);
+		print(x % 6);
+		print(x / 7);
+		print(x % 7);
+		print(x / 10);
+		print(x % 10);
+		print(x / 11);
+		print(x % 11);
+		print(x / 12);
+		print(x % 12);
+		print(x / 25);
+		print(x % 25);
+		print(x / 100);
+		print(x % 100);
+		print(x / 125);
+		print(x % 125);
+		print(x / 641);
+		print(x % 641);
+		print(x / 1000);
+		print(x % 1000);
+		print(x / 65537);
+		print(x % 65537);
+		print(x / 2147483647);
+		print(x % 2147483647);
+		print(x / -3);
+		print(x % -3);
+		print(x / -7);
+		print(x % -7);
+		print(x / -10);
+		print(x % -10);
+		print(x / -641);
+		print(x % -641);
+		print(x / -2147483647);
+		print(x % -2147483647);
+		print(x / 2);
+		print(x % 2);
+		print(x / 4);
+		print(x % 4);
+		print(x / 8);
+		print(x % 8);
+		print(x / 1024);
+		print(x % 1024);
+		print(x / 1073741824);
+		print(x % 1073741824);
+		print(x / -2);
+		print(x % -2);
+		print(x / -16);
+		print(x % -16);
+		print(x / (-2147483647 - 1));
+		print(x % (-2147483647 - 1));
+		i = i + 1;
+	}
+	return i;
+}
@@ -0,0 +1,213 @@
+; ModuleID = 'divcheck.c'
+source_filename = "divcheck.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-pc-linux-gnu"
+
+; Function Attrs: noinline nounwind optnone uwtable
+define dso_local i32 @func(i32 noundef %0) #0 {
+  %2 = alloca i32, align 4
+  %3 = alloca i32, align 4
+  %4 = alloca i32, align 4
+  store i32 %0, ptr %2, align 4
+  store i32 0, ptr %3, align 4
+  br label %5
+
+5:                                                ; preds = %9, %1
+  %6 = load i32, ptr %3, align 4
+  %7 = load i32, ptr %2, align 4
+  %8 = icmp slt i32 %6, %7
+  br i1 %8, label %9, label %121
+
+9:                                                ; preds = %5
+  %10 = call i32 (...) @read()
+  store i32 %10, ptr %4, align 4
+  %11 = load i32, ptr %4, align 4
+  %12 = sdiv i32 %11, 3
+  call void @print(i32 noundef %12)
+  %13 = load i32, ptr %4, align 4
+  %14 = srem i32 %13, 3
+  call void @print(i32 noundef %14)
+  %15 = load i32, ptr %4, align 4
+  %16 = sdiv i32 %15, 5
+  call void @print(i32 noundef %16)
+  %17 = load i32, ptr %4, align 4
+  %18 = srem i32 %17, 5
+  call void @print(i32 noundef %18)
+  %19 = load i32, ptr %4, align 4
+  %20 = sdiv i32 %19, 6
+  call void @print(i32 noundef %20)
+  %21 = load i32, ptr %4, align 4
+  %22 = srem i32 %21, 6
+  call void @print(i32 noundef %22)
+  %23 = load i32, ptr %4, align 4
+  %24 = sdiv i32 %23, 7
+  call void @print(i32 noundef %24)
+  %25 = load i32, ptr %4, align 4
+  %26 = srem i32 %25, 7
+  call void @print(i32 noundef %26)
+  %27 = load i32, ptr %4, align 4
+  %28 = sdiv i32 %27, 10
+  call void @print(i32 noundef %28)
+  %29 = load i32, ptr %4, align 4
+  %30 = srem i32 %29, 10
+  call void @print(i32 noundef %30)
+  %31 = load i32, ptr %4, align 4
+  %32 = sdiv i32 %31, 11
+  call void @print(i32 noundef %32)
+  %33 = load i32, ptr %4, align 4
+  %34 = srem i32 %33, 11
+  call void @print(i32 noundef %34)
+  %35 = load i32, ptr %4, align 4
+  %36 = sdiv i32 %35, 12
+  call void @print(i32 noundef %36)
+  %37 = load i32, ptr %4, align 4
+  %38 = srem i32 %37, 12
+  call void @print(i32 noundef %38)
+  %39 = load i32, ptr %4, align 4
+  %40 = sdiv i32 %39, 25
+  call void @print(i32 noundef %40)
+  %41 = load i32, ptr %4, align 4
+  %42 = srem i32 %41, 25
+  call void @print(i32 noundef %42)
+  %43 = load i32, ptr %4, align 4
+  %44 = sdiv i32 %43, 100
+  call void @print(i32 noundef %44)
+  %45 = load i32, ptr %4, align 4
+  %46 = srem i32 %45, 100
+  call void @print(i32 noundef %46)
+  %47 = load i32, ptr %4, align 4
+  %48 = sdiv i32 %47, 125
+  call void @print(i32 noundef %48)
+  %49 = load i32, ptr %4, align 4
+  %50 = srem i32 %49, 125
+  call void @print(i32 noundef %50)
+  %51 = load i32, ptr %4, align 4
+  %52 = sdiv i32 %51, 641
+  call void @print(i32 noundef %52)
+  %53 = load i32, ptr %4, align 4
+  %54 = srem i32 %53, 641
+  call void @print(i32 noundef %54)
+  %55 = load i32, ptr %4, align 4
+  %56 = sdiv i32 %55, 1000
+  call void @print(i32 noundef %56)
+  %57 = load i32, ptr %4, align 4
+  %58 = srem i32 %57, 1000
+  call void @print(i32 noundef %58)
+  %59 = load i32, ptr %4, align 4
+  %60 = sdiv i32 %59, 65537
+  call void @print(i32 noundef %60)
+  %61 = load i32, ptr %4, align 4
+  %62 = srem i32 %61, 65537
+  call void @print(i32 noundef %62)
+  %63 = load i32, ptr %4, align 4
+  %64 = sdiv i32 %63, 2147483647
+  call void @print(i32 noundef %64)
+  %65 = load i32, ptr %4, align 4
+  %66 = srem i32 %65, 2147483647
+  call void @print(i32 noundef %66)
+  %67 = load i32, ptr %4, align 4
+  %68 = sdiv i32 %67, -3
+  call void @print(i32 noundef %68)
+  %69 = load i32, ptr %4, align 4
+  %70 = srem i32 %69, -3
+  call void @print(i32 noundef %70)
+  %71 = load i32, ptr %4, align 4
+  %72 = sdiv i32 %71, -7
+  call void @print(i32 noundef %72)
+  %73 = load i32, ptr %4, align 4
+  %74 = srem i32 %73, -7
+  call void @print(i32 noundef %74)
+  %75 = load i32, ptr %4, align 4
+  %76 = sdiv i32 %75, -10
+  call void @print(i32 noundef %76)
+  %77 = load i32, ptr %4, align 4
+  %78 = srem i32 %77, -10
+  call void @print(i32 noundef %78)
+  %79 = load i32, ptr %4, align 4
+  %80 = sdiv i32 %79, -641
+  call void @print(i32 noundef %80)
+  %81 = load i32, ptr %4, align 4
+  %82 = srem i32 %81, -641
+  call void @print(i32 noundef %82)
+  %83 = load i32, ptr %4, align 4
+  %84 = sdiv i32 %83, -2147483647
+  call void @print(i32 noundef %84)
+  %85 = load i32, ptr %4, align 4
+  %86 = srem i32 %85, -2147483647
+  call void @print(i32 noundef %86)
+  %87 = load i32, ptr %4, align 4
+  %88 = sdiv i32 %87, 2
+  call void @print(i32 noundef %88)
+  %89 = load i32, ptr %4, align 4
+  %90 = srem i32 %89, 2
+  call void @print(i32 noundef %90)
+  %91 = load i32, ptr %4, align 4
+  %92 = sdiv i32 %91, 4
+  call void @print(i32 noundef %92)
+  %93 = load i32, ptr %4, align 4
+  %94 = srem i32 %93, 4
+  call void @print(i32 noundef %94)
+  %95 = load i32, ptr %4, align 4
+  %96 = sdiv i32 %95, 8
+  call void @print(i32 noundef %96)
+  %97 = load i32, ptr %4, align 4
+  %98 = srem i32 %97, 8
+  call void @print(i32 noundef %98)
+  %99 = load i32, ptr %4, align 4
+  %100 = sdiv i32 %99, 1024
+  call void @print(i32 noundef %100)
+  %101 = load i32, ptr %4, align 4
+  %102 = srem i32 %101, 1024
+  call void @print(i32 noundef %102)
+  %103 = load i32, ptr %4, align 4
+  %104 = sdiv i32 %103, 1073741824
+  call void @print(i32 noundef %104)
+  %105 = load i32, ptr %4, align 4
+  %106 = srem i32 %105, 1073741824
+  call void @print(i32 noundef %106)
+  %107 = load i32, ptr %4, align 4
+  %108 = sdiv i32 %107, -2
+  call void @print(i32 noundef %108)
+  %109 = load i32, ptr %4, align 4
+  %110 = srem i32 %109, -2
+  call void @print(i32 noundef %110)
+  %111 = load i32, ptr %4, align 4
+  %112 = sdiv i32 %111, -16
+  call void @print(i32 noundef %112)
+  %113 = load i32, ptr %4, align 4
+  %114 = srem i32 %113, -16
+  call void @print(i32 noundef %114)
+  %115 = load i32, ptr %4, align 4
+  %116 = sdiv i32 %115, -2147483648
+  call void @print(i32 noundef %116)
+  %117 = load i32, ptr %4, align 4
+  %118 = srem i32 %117, -2147483648
+  call void @print(i32 noundef %118)
+  %119 = load i32, ptr %3, align 4
+  %120 = add nsw i32 %119, 1
+  store i32 %120, ptr %3, align 4
+  br label %5, !llvm.loop !6
+
+121:                                              ; preds = %5
+  %122 = load i32, ptr %3, align 4
+  ret i32 %122
+}
+
+declare i32 @read(...) #1
+
+declare void @print(i32 noundef) #1
+
+attributes #0 = { noinline nounwind optnone uwtable "frame-pointer"="all" "min-legal-vector-width"="0" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+attributes #1 = { "frame-pointer"="all" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+
+!llvm.module.flags = !{!0, !1, !2, !3, !4}
+!llvm.ident = !{!5}
+
+!0 = !{i32 1, !"wchar_size", i32 4}
+!1 = !{i32 7, !"PIC Level", i32 2}
+!2 = !{i32 7, !"PIE Level", i32 2}
+!3 = !{i32 7, !"uwtable", i32 2}
+!4 = !{i32 7, !"frame-pointer", i32 2}
+!5 = !{!"Ubuntu clang version 15.0.7"}
+!6 = distinct !{!6, !7}
+!7 = !{!"llvm.loop.mustprogress"}
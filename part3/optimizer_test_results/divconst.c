@@ -0,0 +1,12 @@
+extern void print(int);
+extern int read();
+
+int func(int n){
+	int x;
+
+	x = read();
+	print(x / 7);
+	print(x % 5);
+	print(x / -8);
+	return x / 16;
+}
@@ -0,0 +1,59 @@
+; ModuleID = 'optimizer_test_results/divconst.ll'
+source_filename = "divconst.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-pc-linux-gnu"
+
+; Function Attrs: noinline nounwind optnone uwtable
+define dso_local i32 @func(i32 noundef %0) #0 {
+  %2 = alloca i32, align 4
+  %3 = alloca i32, align 4
+  store i32 %0, ptr %2, align 4
+  %4 = call i32 (...) @read()
+  store i32 %4, ptr %3, align 4
+  %5 = load i32, ptr %3, align 4
+  %6 = sext i32 %5 to i64
+  %7 = mul i64 %6, -1840700269
+  %8 = ashr i64 %7, 32
+  %9 = trunc i64 %8 to i32
+  %10 = add i32 %9, %5
+  %11 = ashr i32 %10, 2
+  %12 = lshr i32 %11, 31
+  %13 = add i32 %11, %12
+  call void @print(i32 noundef %13)
+  %14 = mul i64 %6, 1717986919
+  %15 = ashr i64 %14, 32
+  %16 = trunc i64 %15 to i32
+  %17 = ashr i32 %16, 1
+  %18 = lshr i32 %17, 31
+  %19 = add i32 %17, %18
+  %20 = mul i32 %19, 5
+  %21 = sub i32 %5, %20
+  call void @print(i32 noundef %21)
+  %22 = ashr i32 %5, 31
+  %23 = lshr i32 %22, 29
+  %24 = add i32 %5, %23
+  %25 = ashr i32 %24, 3
+  %26 = sub i32 0, %25
+  call void @print(i32 noundef %26)
+  %27 = lshr i32 %22, 28
+  %28 = add i32 %5, %27
+  %29 = ashr i32 %28, 4
+  ret i32 %29
+}
+
+declare i32 @read(...) #1
+
+declare void @print(i32 noundef) #1
+
+attributes #0 = { noinline nounwind optnone uwtable "frame-pointer"="all" "min-legal-vector-width"="0" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+attributes #1 = { "frame-pointer"="all" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+
+!llvm.module.flags = !{!0, !1, !2, !3, !4}
+!llvm.ident = !{!5}
+
+!0 = !{i32 1, !"wchar_size", i32 4}
+!1 = !{i32 7, !"PIC Level", i32 2}
+!2 = !{i32 7, !"PIE Level", i32 2}
+!3 = !{i32 7, !"uwtable", i32 2}
+!4 = !{i32 7, !"frame-pointer", i32 2}
+!5 = !{!"Ubuntu clang version 15.0.7"}
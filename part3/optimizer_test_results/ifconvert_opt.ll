@@ -0,0 +1,58 @@
+; ModuleID = 'optimizer_test_results/ifconvert.ll'
+source_filename = "ifconvert.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-pc-linux-gnu"
+
+; Function Attrs: noinline nounwind optnone uwtable
+define dso_local i32 @func(i32 noundef %0) #0 {
+  br label %2
+
+2:                                                ; preds = %17, %1
+  %3 = phi i32 [ 0, %1 ], [ %14, %17 ]
+  %4 = phi i32 [ 0, %1 ], [ %12, %17 ]
+  %5 = phi i32 [ 0, %1 ], [ %18, %17 ]
+  %6 = icmp slt i32 %5, %0
+  br i1 %6, label %7, label %19
+
+7:                                                ; preds = %2
+  %8 = call i32 (...) @read()
+  %9 = icmp sgt i32 %8, 50
+  %10 = add nsw i32 %4, %8
+  %11 = sub nsw i32 %4, %8
+  %12 = select i1 %9, i32 %10, i32 %11
+  %13 = icmp sgt i32 %8, %3
+  %14 = select i1 %13, i32 %8, i32 %3
+  %15 = icmp slt i32 %8, 0
+  br i1 %15, label %16, label %17
+
+16:                                               ; preds = %7
+  call void @print(i32 noundef %8)
+  br label %17
+
+17:                                               ; preds = %16, %7
+  %18 = add nsw i32 %5, 1
+  br label %2, !llvm.loop !6
+
+19:                                               ; preds = %2
+  call void @print(i32 noundef %3)
+  ret i32 %4
+}
+
+declare i32 @read(...) #1
+
+declare void @print(i32 noundef) #1
+
+attributes #0 = { noinline nounwind optnone uwtable "frame-pointer"="all" "min-legal-vector-width"="0" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+attributes #1 = { "frame-pointer"="all" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+
+!llvm.module.flags = !{!0, !1, !2, !3, !4}
+!llvm.ident = !{!5}
+
+!0 = !{i32 1, !"wchar_size", i32 4}
+!1 = !{i32 7, !"PIC Level", i32 2}
+!2 = !{i32 7, !"PIE Level", i32 2}
+!3 = !{i32 7, !"uwtable", i32 2}
+!4 = !{i32 7, !"frame-pointer", i32 2}
+!5 = !{!"Ubuntu clang version 15.0.7"}
+!6 = distinct !{!6, !7}
+!7 = !{!"llvm.loop.mustprogress"}
@@ -0,0 +1,24 @@
+extern void print(int);
+extern int read();
+
+int func(int n){
+	int i;
+	int s;
+	int t;
+	int c;
+	i = 0;
+	s = 0;
+	while (i < n){
+		s = s + i * 3 + 1;
+		i = i + 1;
+	}
+	i = 0;
+	c = 0;
+	while (i < n){
+		t = i * 5;
+		if (t > s)
+			c = c + 1;
+		i = i + 1;
+	}
+	return s + c;
+}
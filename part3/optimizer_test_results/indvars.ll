@@ -0,0 +1,88 @@
+; ModuleID = 'indvars.c'
+source_filename = "indvars.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-pc-linux-gnu"
+
+; Function Attrs: noinline nounwind optnone uwtable
+define dso_local i32 @func(i32 noundef %0) #0 {
+  %2 = alloca i32, align 4
+  %3 = alloca i32, align 4
+  %4 = alloca i32, align 4
+  %5 = alloca i32, align 4
+  %6 = alloca i32, align 4
+  store i32 %0, ptr %2, align 4
+  store i32 0, ptr %3, align 4
+  store i32 0, ptr %4, align 4
+  br label %7
+
+7:                                                ; preds = %11, %1
+  %8 = load i32, ptr %3, align 4
+  %9 = load i32, ptr %2, align 4
+  %10 = icmp slt i32 %8, %9
+  br i1 %10, label %11, label %19
+
+11:                                               ; preds = %7
+  %12 = load i32, ptr %4, align 4
+  %13 = load i32, ptr %3, align 4
+  %14 = mul nsw i32 %13, 3
+  %15 = add nsw i32 %12, %14
+  %16 = add nsw i32 %15, 1
+  store i32 %16, ptr %4, align 4
+  %17 = load i32, ptr %3, align 4
+  %18 = add nsw i32 %17, 1
+  store i32 %18, ptr %3, align 4
+  br label %7, !llvm.loop !6
+
+19:                                               ; preds = %7
+  store i32 0, ptr %3, align 4
+  store i32 0, ptr %6, align 4
+  br label %20
+
+20:                                               ; preds = %33, %19
+  %21 = load i32, ptr %3, align 4
+  %22 = load i32, ptr %2, align 4
+  %23 = icmp slt i32 %21, %22
+  br i1 %23, label %24, label %36
+
+24:                                               ; preds = %20
+  %25 = load i32, ptr %3, align 4
+  %26 = mul nsw i32 %25, 5
+  store i32 %26, ptr %5, align 4
+  %27 = load i32, ptr %5, align 4
+  %28 = load i32, ptr %4, align 4
+  %29 = icmp sgt i32 %27, %28
+  br i1 %29, label %30, label %33
+
+30:                                               ; preds = %24
+  %31 = load i32, ptr %6, align 4
+  %32 = add nsw i32 %31, 1
+  store i32 %32, ptr %6, align 4
+  br label %33
+
+33:                                               ; preds = %30, %24
+  %34 = load i32, ptr %3, align 4
+  %35 = add nsw i32 %34, 1
+  store i32 %35, ptr %3, align 4
+  br label %20, !llvm.loop !8
+
+36:                                               ; preds = %20
+  %37 = load i32, ptr %4, align 4
+  %38 = load i32, ptr %6, align 4
+  %39 = add nsw i32 %37, %38
+  ret i32 %39
+}
+
+attributes #0 = { noinline nounwind optnone uwtable "frame-pointer"="all" "min-legal-vector-width"="0" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+
+!llvm.module.flags = !{!0, !1, !2, !3, !4}
+!llvm.ident = !{!5}
+
+!0 = !{i32 1, !"wchar_size", i32 4}
+!1 = !{i32 7, !"PIC Level", i32 2}
+!2 = !{i32 7, !"PIE Level", i32 2}
+!3 = !{i32 7, !"uwtable", i32 2}
+!4 = !{i32 7, !"frame-pointer", i32 2}
+!5 = !{!"Ubuntu clang version 15.0.7"}
+!6 = distinct !{!6, !7}
+!7 = !{!"llvm.loop.mustprogress"}
+!8 = distinct !{!8, !7}
@@ -0,0 +1,94 @@
+; ModuleID = 'optimizer_test_results/indvars.ll'
+source_filename = "indvars.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-pc-linux-gnu"
+
+; Function Attrs: noinline nounwind optnone uwtable
+define dso_local i32 @func(i32 noundef %0) #0 {
+  %2 = alloca i32, align 4
+  %3 = alloca i32, align 4
+  %4 = alloca i32, align 4
+  %5 = alloca i32, align 4
+  %6 = alloca i32, align 4
+  store i32 %0, ptr %2, align 4
+  store i32 0, ptr %3, align 4
+  store i32 0, ptr %4, align 4
+  %7 = load i32, ptr %4, align 4
+  %8 = load i32, ptr %3, align 4
+  %9 = load i32, ptr %2, align 4
+  %10 = icmp slt i32 %8, %9
+  %11 = sub i32 %9, %8
+  %12 = select i1 %10, i32 %11, i32 0
+  %13 = sub i32 %12, 1
+  %14 = and i32 %12, 1
+  %15 = icmp eq i32 %14, 0
+  %16 = lshr i32 %12, 1
+  %17 = select i1 %15, i32 %16, i32 %12
+  %18 = lshr i32 %13, 1
+  %19 = select i1 %15, i32 %13, i32 %18
+  %20 = mul i32 %17, %19
+  %21 = mul i32 %8, 3
+  %22 = add i32 1, %21
+  %23 = mul i32 %12, %22
+  %24 = mul i32 %20, 3
+  %25 = add i32 %23, %24
+  %26 = add i32 %7, %25
+  %27 = add i32 %8, %12
+  store i32 %26, ptr %4, align 4
+  store i32 %27, ptr %3, align 4
+  br label %28
+
+28:                                               ; preds = %1
+  store i32 0, ptr %3, align 4
+  store i32 0, ptr %6, align 4
+  %29 = load i32, ptr %3, align 4
+  %30 = mul i32 %29, 5
+  br label %31
+
+31:                                               ; preds = %44, %28
+  %32 = phi i32 [ %30, %28 ], [ %33, %44 ]
+  %33 = add i32 %32, 5
+  %34 = load i32, ptr %3, align 4
+  %35 = load i32, ptr %2, align 4
+  %36 = icmp slt i32 %34, %35
+  br i1 %36, label %37, label %47
+
+37:                                               ; preds = %31
+  store i32 %32, ptr %5, align 4
+  %38 = load i32, ptr %5, align 4
+  %39 = load i32, ptr %4, align 4
+  %40 = icmp sgt i32 %38, %39
+  br i1 %40, label %41, label %44
+
+41:                                               ; preds = %37
+  %42 = load i32, ptr %6, align 4
+  %43 = add nsw i32 %42, 1
+  store i32 %43, ptr %6, align 4
+  br label %44
+
+44:                                               ; preds = %41, %37
+  %45 = load i32, ptr %3, align 4
+  %46 = add nsw i32 %45, 1
+  store i32 %46, ptr %3, align 4
+  br label %31, !llvm.loop !6
+
+47:                                               ; preds = %31
+  %48 = load i32, ptr %4, align 4
+  %49 = load i32, ptr %6, align 4
+  %50 = add nsw i32 %48, %49
+  ret i32 %50
+}
+
+attributes #0 = { noinline nounwind optnone uwtable "frame-pointer"="all" "min-legal-vector-width"="0" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+
+!llvm.module.flags = !{!0, !1, !2, !3, !4}
+!llvm.ident = !{!5}
+
+!0 = !{i32 1, !"wchar_size", i32 4}
+!1 = !{i32 7, !"PIC Level", i32 2}
+!2 = !{i32 7, !"PIE Level", i32 2}
+!3 = !{i32 7, !"uwtable", i32 2}
+!4 = !{i32 7, !"frame-pointer", i32 2}
+!5 = !{!"Ubuntu clang version 15.0.7"}
+!6 = distinct !{!6, !7}
+!7 = !{!"llvm.loop.mustprogress"}
@@ -0,0 +1,22 @@
+extern void print(int);
+extern int read();
+
+int func(int p){
+	int a;
+	int b;
+	int c;
+	a = p + 0;
+	b = a * 1;
+	c = b * 8;
+	print(c);
+	c = a - a;
+	print(c);
+	c = p / 1;
+	print(c);
+	c = 100 / 7;
+	print(c);
+	c = 7 / 0;
+	print(c);
+	c = p * 0;
+	return c;
+}
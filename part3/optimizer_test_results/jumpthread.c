@@ -0,0 +1,27 @@
+extern void print(int);
+extern int read();
+
+int func(int n){
+	int i;
+	int x;
+	int s;
+	int low;
+
+	i = 0;
+	s = 0;
+	while (i < n){
+		x = read();
+		low = 0;
+		if (x < 10){
+			s = s + x;
+			low = 1;
+		}
+		print(s);
+		if (x < 10)
+			s = s + 100;
+		if (low == 1)
+			s = s - 1;
+		i = i + 1;
+	}
+	return s;
+}
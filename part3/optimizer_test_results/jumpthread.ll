@@ -0,0 +1,92 @@
+; ModuleID = 'jumpthread.c'
+source_filename = "jumpthread.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-pc-linux-gnu"
+
+; Function Attrs: noinline nounwind optnone uwtable
+define dso_local i32 @func(i32 noundef %0) #0 {
+  %2 = alloca i32, align 4
+  %3 = alloca i32, align 4
+  %4 = alloca i32, align 4
+  %5 = alloca i32, align 4
+  %6 = alloca i32, align 4
+  store i32 %0, ptr %2, align 4
+  store i32 0, ptr %3, align 4
+  store i32 0, ptr %5, align 4
+  br label %7
+
+7:                                                ; preds = %32, %1
+  %8 = load i32, ptr %3, align 4
+  %9 = load i32, ptr %2, align 4
+  %10 = icmp slt i32 %8, %9
+  br i1 %10, label %11, label %35
+
+11:                                               ; preds = %7
+  %12 = call i32 (...) @read()
+  store i32 %12, ptr %4, align 4
+  store i32 0, ptr %6, align 4
+  %13 = load i32, ptr %4, align 4
+  %14 = icmp slt i32 %13, 10
+  br i1 %14, label %15, label %19
+
+15:                                               ; preds = %11
+  %16 = load i32, ptr %5, align 4
+  %17 = load i32, ptr %4, align 4
+  %18 = add nsw i32 %16, %17
+  store i32 %18, ptr %5, align 4
+  store i32 1, ptr %6, align 4
+  br label %19
+
+19:                                               ; preds = %15, %11
+  %20 = load i32, ptr %5, align 4
+  call void @print(i32 noundef %20)
+  %21 = load i32, ptr %4, align 4
+  %22 = icmp slt i32 %21, 10
+  br i1 %22, label %23, label %26
+
+23:                                               ; preds = %19
+  %24 = load i32, ptr %5, align 4
+  %25 = add nsw i32 %24, 100
+  store i32 %25, ptr %5, align 4
+  br label %26
+
+26:                                               ; preds = %23, %19
+  %27 = load i32, ptr %6, align 4
+  %28 = icmp eq i32 %27, 1
+  br i1 %28, label %29, label %32
+
+29:                                               ; preds = %26
+  %30 = load i32, ptr %5, align 4
+  %31 = sub nsw i32 %30, 1
+  store i32 %31, ptr %5, align 4
+  br label %32
+
+32:                                               ; preds = %29, %26
+  %33 = load i32, ptr %3, align 4
+  %34 = add nsw i32 %33, 1
+  store i32 %34, ptr %3, align 4
+  br label %7, !llvm.loop !6
+
+35:                                               ; preds = %7
+  %36 = load i32, ptr %5, align 4
+  ret i32 %36
+}
+
+declare i32 @read(...) #1
+
+declare void @print(i32 noundef) #1
+
+attributes #0 = { noinline nounwind optnone uwtable "frame-pointer"="all" "min-legal-vector-width"="0" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+attributes #1 = { "frame-pointer"="all" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+
+!llvm.module.flags = !{!0, !1, !2, !3, !4}
+!llvm.ident = !{!5}
+
+!0 = !{i32 1, !"wchar_size", i32 4}
+!1 = !{i32 7, !"PIC Level", i32 2}
+!2 = !{i32 7, !"PIE Level", i32 2}
+!3 = !{i32 7, !"uwtable", i32 2}
+!4 = !{i32 7, !"frame-pointer", i32 2}
+!5 = !{!"Ubuntu clang version 15.0.7"}
+!6 = distinct !{!6, !7}
+!7 = !{!"llvm.loop.mustprogress"}
@@ -0,0 +1,58 @@
+; ModuleID = 'optimizer_test_results/jumpthread.ll'
+source_filename = "jumpthread.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-pc-linux-gnu"
+
+; Function Attrs: noinline nounwind optnone uwtable
+define dso_local i32 @func(i32 noundef %0) #0 {
+  br label %2
+
+2:                                                ; preds = %14, %1
+  %3 = phi i32 [ 0, %1 ], [ %15, %14 ]
+  %4 = phi i32 [ 0, %1 ], [ %16, %14 ]
+  %5 = icmp slt i32 %4, %0
+  br i1 %5, label %6, label %17
+
+6:                                                ; preds = %2
+  %7 = call i32 (...) @read()
+  %8 = icmp slt i32 %7, 10
+  br i1 %8, label %9, label %13
+
+9:                                                ; preds = %6
+  %10 = add nsw i32 %3, %7
+  call void @print(i32 noundef %10)
+  %11 = add nsw i32 %10, 100
+  %12 = sub nsw i32 %11, 1
+  br label %14
+
+13:                                               ; preds = %6
+  call void @print(i32 noundef %3)
+  br label %14
+
+14:                                               ; preds = %13, %9
+  %15 = phi i32 [ %12, %9 ], [ %3, %13 ]
+  %16 = add nsw i32 %4, 1
+  br label %2, !llvm.loop !6
+
+17:                                               ; preds = %2
+  ret i32 %3
+}
+
+declare i32 @read(...) #1
+
+declare void @print(i32 noundef) #1
+
+attributes #0 = { noinline nounwind optnone uwtable "frame-pointer"="all" "min-legal-vector-width"="0" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+attributes #1 = { "frame-pointer"="all" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+
+!llvm.module.flags = !{!0, !1, !2, !3, !4}
+!llvm.ident = !{!5}
+
+!0 = !{i32 1, !"wchar_size", i32 4}
+!1 = !{i32 7, !"PIC Level", i32 2}
+!2 = !{i32 7, !"PIE Level", i32 2}
+!3 = !{i32 7, !"uwtable", i32 2}
+!4 = !{i32 7, !"frame-pointer", i32 2}
+!5 = !{!"Ubuntu clang version 15.0.7"}
+!6 = distinct !{!6, !7}
+!7 = !{!"llvm.loop.mustprogress"}
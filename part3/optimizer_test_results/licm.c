@@ -0,0 +1,19 @@
+extern void print(int);
+extern int read();
+
+int func(int n){
+	int i;
+	int j;
+	int s;
+	i = 0;
+	s = 0;
+	while (i < n){
+		j = 0;
+		while (j < n){
+			s = s + n * 2;
+			j = j + 1;
+		}
+		i = i + 1;
+	}
+	return s;
+}
@@ -0,0 +1,25 @@
+extern void print(int);
+extern int read();
+
+int func(int n){
+	int x;
+	int i;
+	int s;
+	int d;
+	int q;
+	x = read();
+	i = 0;
+	s = 0;
+	while (i < n){
+		d = 1;
+		if (x > 0)
+			d = x;
+		q = 100 / d;
+		if (x > 0)
+			s = s + q;
+		else
+			s = s - q;
+		i = i + 1;
+	}
+	return s;
+}
@@ -0,0 +1,46 @@
+; ModuleID = 'nontrapping.c'
+source_filename = "nontrapping.c"
+
+declare void @print(i32)
+
+declare i32 @read()
+
+define i32 @func(i32 %0) {
+  %2 = call i32 @read()
+  br label %3
+
+3:                                                ; preds = %18, %1
+  %4 = phi i32 [ 0, %1 ], [ %19, %18 ]
+  %5 = phi i32 [ 0, %1 ], [ %20, %18 ]
+  %6 = icmp slt i32 %5, %0
+  br i1 %6, label %7, label %21
+
+7:                                                ; preds = %3
+  %8 = icmp sgt i32 %2, 0
+  br i1 %8, label %9, label %10
+
+9:                                                ; preds = %7
+  br label %10
+
+10:                                               ; preds = %9, %7
+  %11 = phi i32 [ 1, %7 ], [ %2, %9 ]
+  %12 = sdiv i32 100, %11
+  %13 = icmp sgt i32 %2, 0
+  br i1 %13, label %14, label %16
+
+14:                                               ; preds = %10
+  %15 = add nsw i32 %4, %12
+  br label %18
+
+16:                                               ; preds = %10
+  %17 = sub nsw i32 %4, %12
+  br label %18
+
+18:                                               ; preds = %14, %16
+  %19 = phi i32 [ %17, %16 ], [ %15, %14 ]
+  %20 = add nsw i32 %5, 1
+  br label %3
+
+21:                                               ; preds = %3
+  ret i32 %4
+}
@@ -0,0 +1,17 @@
+extern void print(int);
+extern int read();
+
+int func(int n){
+	int x;
+	int i;
+	int s;
+	x = read();
+	i = 0;
+	s = 0;
+	while (i < n){
+		if (x > 0)
+			s = s + 100 / (x + 0);
+		i = i + 1;
+	}
+	return s;
+}
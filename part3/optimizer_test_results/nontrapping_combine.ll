@@ -0,0 +1,35 @@
+; ModuleID = 'nontrapping_combine.c'
+source_filename = "nontrapping_combine.c"
+
+declare void @print(i32)
+
+declare i32 @read()
+
+define i32 @func(i32 %0) {
+  %2 = call i32 @read()
+  br label %3
+
+3:                                                ; preds = %13, %1
+  %4 = phi i32 [ 0, %1 ], [ %14, %13 ]
+  %5 = phi i32 [ 0, %1 ], [ %15, %13 ]
+  %6 = icmp slt i32 %5, %0
+  br i1 %6, label %7, label %16
+
+7:                                                ; preds = %3
+  %8 = icmp sgt i32 %2, 0
+  br i1 %8, label %9, label %13
+
+9:                                                ; preds = %7
+  %10 = add nsw i32 %2, 0
+  %11 = sdiv i32 100, %10
+  %12 = add nsw i32 %4, %11
+  br label %13
+
+13:                                               ; preds = %9, %7
+  %14 = phi i32 [ %4, %7 ], [ %12, %9 ]
+  %15 = add nsw i32 %5, 1
+  br label %3
+
+16:                                               ; preds = %3
+  ret i32 %4
+}
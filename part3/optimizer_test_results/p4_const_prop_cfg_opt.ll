@@ -0,0 +1,69 @@
+; ModuleID = 'optimizer_test_results/p4_const_prop.ll'
+source_filename = "p4_const_prop.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-pc-linux-gnu"
+
+; Function Attrs: noinline nounwind optnone uwtable
+define dso_local i32 @func(i32 noundef %0) #0 {
+  %2 = alloca i32, align 4
+  %3 = alloca i32, align 4
+  %4 = alloca i32, align 4
+  %5 = alloca i32, align 4
+  %6 = alloca i32, align 4
+  store i32 %0, ptr %2, align 4
+  store i32 10, ptr %3, align 4
+  store i32 20, ptr %4, align 4
+  %7 = load i32, ptr %3, align 4
+  %8 = add nsw i32 %7, 10
+  store i32 %8, ptr %5, align 4
+  store i32 5, ptr %3, align 4
+  br label %9
+
+9:                                                ; preds = %20, %19, %1
+  %10 = load i32, ptr %3, align 4
+  %11 = load i32, ptr %2, align 4
+  %12 = icmp slt i32 %10, %11
+  br i1 %12, label %13, label %21
+
+13:                                               ; preds = %9
+  %14 = load i32, ptr %3, align 4
+  %15 = add nsw i32 %14, 1
+  store i32 %15, ptr %3, align 4
+  %16 = load i32, ptr %3, align 4
+  %17 = load i32, ptr %4, align 4
+  %18 = icmp sgt i32 %16, %17
+  br i1 %18, label %19, label %20
+
+19:                                               ; preds = %13
+  store i32 25, ptr %5, align 4
+  br label %9
+
+20:                                               ; preds = %13
+  store i32 25, ptr %5, align 4
+  br label %9
+
+21:                                               ; preds = %9
+  %22 = load i32, ptr %3, align 4
+  call void @print(i32 noundef %22)
+  %23 = load i32, ptr %4, align 4
+  call void @print(i32 noundef %23)
+  %24 = load i32, ptr %5, align 4
+  call void @print(i32 noundef %24)
+  %25 = add nsw i32 %23, %24
+  ret i32 %25
+}
+
+declare void @print(i32 noundef) #1
+
+attributes #0 = { noinline nounwind optnone uwtable "frame-pointer"="all" "min-legal-vector-width"="0" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+attributes #1 = { "frame-pointer"="all" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+
+!llvm.module.flags = !{!0, !1, !2, !3, !4}
+!llvm.ident = !{!5}
+
+!0 = !{i32 1, !"wchar_size", i32 4}
+!1 = !{i32 7, !"PIC Level", i32 2}
+!2 = !{i32 7, !"PIE Level", i32 2}
+!3 = !{i32 7, !"uwtable", i32 2}
+!4 = !{i32 7, !"frame-pointer", i32 2}
+!5 = !{!"Ubuntu clang version 15.0.7"}
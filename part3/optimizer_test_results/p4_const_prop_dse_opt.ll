@@ -0,0 +1,66 @@
+; ModuleID = 'optimizer_test_results/p4_const_prop.ll'
+source_filename = "p4_const_prop.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-pc-linux-gnu"
+
+; Function Attrs: noinline nounwind optnone uwtable
+define dso_local i32 @func(i32 noundef %0) #0 {
+  %2 = alloca i32, align 4
+  %3 = alloca i32, align 4
+  %4 = alloca i32, align 4
+  store i32 %0, ptr %2, align 4
+  store i32 20, ptr %4, align 4
+  store i32 5, ptr %3, align 4
+  br label %5
+
+5:                                                ; preds = %16, %1
+  %6 = load i32, ptr %3, align 4
+  %7 = load i32, ptr %2, align 4
+  %8 = icmp slt i32 %6, %7
+  br i1 %8, label %9, label %17
+
+9:                                                ; preds = %5
+  %10 = load i32, ptr %3, align 4
+  %11 = add nsw i32 %10, 1
+  store i32 %11, ptr %3, align 4
+  %12 = load i32, ptr %3, align 4
+  %13 = icmp sgt i32 %12, 20
+  br i1 %13, label %14, label %15
+
+14:                                               ; preds = %9
+  store i32 25, ptr %4, align 4
+  br label %16
+
+15:                                               ; preds = %9
+  store i32 25, ptr %4, align 4
+  br label %16
+
+16:                                               ; preds = %15, %14
+  br label %5, !llvm.loop !6
+
+17:                                               ; preds = %5
+  %18 = load i32, ptr %3, align 4
+  call void @print(i32 noundef %18)
+  call void @print(i32 noundef 20)
+  %19 = load i32, ptr %4, align 4
+  call void @print(i32 noundef %19)
+  %20 = add nsw i32 20, %19
+  ret i32 %20
+}
+
+declare void @print(i32 noundef) #1
+
+attributes #0 = { noinline nounwind optnone uwtable "frame-pointer"="all" "min-legal-vector-width"="0" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+attributes #1 = { "frame-pointer"="all" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+
+!llvm.module.flags = !{!0, !1, !2, !3, !4}
+!llvm.ident = !{!5}
+
+!0 = !{i32 1, !"wchar_size", i32 4}
+!1 = !{i32 7, !"PIC Level", i32 2}
+!2 = !{i32 7, !"PIE Level", i32 2}
+!3 = !{i32 7, !"uwtable", i32 2}
+!4 = !{i32 7, !"frame-pointer", i32 2}
+!5 = !{!"Ubuntu clang version 15.0.7"}
+!6 = distinct !{!6, !7}
+!7 = !{!"llvm.loop.mustprogress"}
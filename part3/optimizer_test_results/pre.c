@@ -0,0 +1,28 @@
+extern void print(int);
+extern int read();
+
+int func(int x){
+	int a;
+	int b;
+	int c;
+	int d;
+	int i;
+	int s;
+
+	a = x * 3;
+	b = x + 7;
+	c = 0;
+	if (a > 10)
+		c = a + b;
+	d = a + b;
+	print(c);
+
+	i = 0;
+	s = 0;
+	while (i < x){
+		s = s + (a - b);
+		i = i + 1;
+	}
+	print(s + (a - b));
+	return d;
+}
@@ -0,0 +1,89 @@
+; ModuleID = 'pre.c'
+source_filename = "pre.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-pc-linux-gnu"
+
+; Function Attrs: noinline nounwind optnone uwtable
+define dso_local i32 @func(i32 noundef %0) #0 {
+  %2 = alloca i32, align 4
+  %3 = alloca i32, align 4
+  %4 = alloca i32, align 4
+  %5 = alloca i32, align 4
+  %6 = alloca i32, align 4
+  %7 = alloca i32, align 4
+  %8 = alloca i32, align 4
+  store i32 %0, ptr %2, align 4
+  %9 = load i32, ptr %2, align 4
+  %10 = mul nsw i32 %9, 3
+  store i32 %10, ptr %3, align 4
+  %11 = load i32, ptr %2, align 4
+  %12 = add nsw i32 %11, 7
+  store i32 %12, ptr %4, align 4
+  store i32 0, ptr %5, align 4
+  %13 = load i32, ptr %3, align 4
+  %14 = icmp sgt i32 %13, 10
+  br i1 %14, label %15, label %19
+
+15:                                               ; preds = %1
+  %16 = load i32, ptr %3, align 4
+  %17 = load i32, ptr %4, align 4
+  %18 = add nsw i32 %16, %17
+  store i32 %18, ptr %5, align 4
+  br label %19
+
+19:                                               ; preds = %15, %1
+  %20 = load i32, ptr %3, align 4
+  %21 = load i32, ptr %4, align 4
+  %22 = add nsw i32 %20, %21
+  store i32 %22, ptr %6, align 4
+  %23 = load i32, ptr %5, align 4
+  call void @print(i32 noundef %23)
+  store i32 0, ptr %7, align 4
+  store i32 0, ptr %8, align 4
+  br label %24
+
+24:                                               ; preds = %28, %19
+  %25 = load i32, ptr %7, align 4
+  %26 = load i32, ptr %2, align 4
+  %27 = icmp slt i32 %25, %26
+  br i1 %27, label %28, label %36
+
+28:                                               ; preds = %24
+  %29 = load i32, ptr %8, align 4
+  %30 = load i32, ptr %3, align 4
+  %31 = load i32, ptr %4, align 4
+  %32 = sub nsw i32 %30, %31
+  %33 = add nsw i32 %29, %32
+  store i32 %33, ptr %8, align 4
+  %34 = load i32, ptr %7, align 4
+  %35 = add nsw i32 %34, 1
+  store i32 %35, ptr %7, align 4
+  br label %24, !llvm.loop !6
+
+36:                                               ; preds = %24
+  %37 = load i32, ptr %8, align 4
+  %38 = load i32, ptr %3, align 4
+  %39 = load i32, ptr %4, align 4
+  %40 = sub nsw i32 %38, %39
+  %41 = add nsw i32 %37, %40
+  call void @print(i32 noundef %41)
+  %42 = load i32, ptr %6, align 4
+  ret i32 %42
+}
+
+declare void @print(i32 noundef) #1
+
+attributes #0 = { noinline nounwind optnone uwtable "frame-pointer"="all" "min-legal-vector-width"="0" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+attributes #1 = { "frame-pointer"="all" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+
+!llvm.module.flags = !{!0, !1, !2, !3, !4}
+!llvm.ident = !{!5}
+
+!0 = !{i32 1, !"wchar_size", i32 4}
+!1 = !{i32 7, !"PIC Level", i32 2}
+!2 = !{i32 7, !"PIE Level", i32 2}
+!3 = !{i32 7, !"uwtable", i32 2}
+!4 = !{i32 7, !"frame-pointer", i32 2}
+!5 = !{!"Ubuntu clang version 15.0.7"}
+!6 = distinct !{!6, !7}
+!7 = !{!"llvm.loop.mustprogress"}
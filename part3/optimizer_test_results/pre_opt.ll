@@ -0,0 +1,60 @@
+; ModuleID = 'optimizer_test_results/pre.ll'
+source_filename = "pre.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-pc-linux-gnu"
+
+; Function Attrs: noinline nounwind optnone uwtable
+define dso_local i32 @func(i32 noundef %0) #0 {
+  %2 = mul nsw i32 %0, 3
+  %3 = add nsw i32 %0, 7
+  %4 = icmp sgt i32 %2, 10
+  br i1 %4, label %5, label %7
+
+5:                                                ; preds = %1
+  %6 = add nsw i32 %2, %3
+  br label %9
+
+7:                                                ; preds = %1
+  %8 = add nsw i32 %2, %3
+  br label %9
+
+9:                                                ; preds = %7, %5
+  %10 = phi i32 [ %8, %7 ], [ %6, %5 ]
+  %11 = phi i32 [ 0, %7 ], [ %6, %5 ]
+  call void @print(i32 noundef %11)
+  %12 = sub nsw i32 %2, %3
+  br label %13
+
+13:                                               ; preds = %17, %9
+  %14 = phi i32 [ 0, %9 ], [ %18, %17 ]
+  %15 = phi i32 [ 0, %9 ], [ %19, %17 ]
+  %16 = icmp slt i32 %15, %0
+  br i1 %16, label %17, label %20
+
+17:                                               ; preds = %13
+  %18 = add nsw i32 %14, %12
+  %19 = add nsw i32 %15, 1
+  br label %13, !llvm.loop !6
+
+20:                                               ; preds = %13
+  %21 = add nsw i32 %14, %12
+  call void @print(i32 noundef %21)
+  ret i32 %10
+}
+
+declare void @print(i32 noundef) #1
+
+attributes #0 = { noinline nounwind optnone uwtable "frame-pointer"="all" "min-legal-vector-width"="0" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+attributes #1 = { "frame-pointer"="all" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+
+!llvm.module.flags = !{!0, !1, !2, !3, !4}
+!llvm.ident = !{!5}
+
+!0 = !{i32 1, !"wchar_size", i32 4}
+!1 = !{i32 7, !"PIC Level", i32 2}
+!2 = !{i32 7, !"PIE Level", i32 2}
+!3 = !{i32 7, !"uwtable", i32 2}
+!4 = !{i32 7, !"frame-pointer", i32 2}
+!5 = !{!"Ubuntu clang version 15.0.7"}
+!6 = distinct !{!6, !7}
+!7 = !{!"llvm.loop.mustprogress"}
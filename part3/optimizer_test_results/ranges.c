@@ -0,0 +1,22 @@
+extern void print(int);
+extern int read();
+
+int func(int n){
+	int i;
+	int x;
+	int s;
+
+	i = 0;
+	s = 0;
+	while (i < 100){
+		x = read();
+		if (x > 0)
+			s = s + x / (i + 1);
+		if (i > 150)
+			print(i);
+		i = i + 1;
+	}
+	if (i != 100)
+		print(s);
+	return s;
+}
@@ -0,0 +1,86 @@
+; ModuleID = 'ranges.c'
+source_filename = "ranges.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-pc-linux-gnu"
+
+; Function Attrs: noinline nounwind optnone uwtable
+define dso_local i32 @func(i32 noundef %0) #0 {
+  %2 = alloca i32, align 4
+  %3 = alloca i32, align 4
+  %4 = alloca i32, align 4
+  %5 = alloca i32, align 4
+  store i32 %0, ptr %2, align 4
+  store i32 0, ptr %3, align 4
+  store i32 0, ptr %5, align 4
+  br label %6
+
+6:                                                ; preds = %24, %1
+  %7 = load i32, ptr %3, align 4
+  %8 = icmp slt i32 %7, 100
+  br i1 %8, label %9, label %27
+
+9:                                                ; preds = %6
+  %10 = call i32 (...) @read()
+  store i32 %10, ptr %4, align 4
+  %11 = load i32, ptr %4, align 4
+  %12 = icmp sgt i32 %11, 0
+  br i1 %12, label %13, label %20
+
+13:                                               ; preds = %9
+  %14 = load i32, ptr %5, align 4
+  %15 = load i32, ptr %4, align 4
+  %16 = load i32, ptr %3, align 4
+  %17 = add nsw i32 %16, 1
+  %18 = sdiv i32 %15, %17
+  %19 = add nsw i32 %14, %18
+  store i32 %19, ptr %5, align 4
+  br label %20
+
+20:                                               ; preds = %13, %9
+  %21 = load i32, ptr %3, align 4
+  %22 = icmp sgt i32 %21, 150
+  br i1 %22, label %23, label %24
+
+23:                                               ; preds = %20
+  call void @print(i32 noundef %21)
+  br label %24
+
+24:                                               ; preds = %23, %20
+  %25 = load i32, ptr %3, align 4
+  %26 = add nsw i32 %25, 1
+  store i32 %26, ptr %3, align 4
+  br label %6, !llvm.loop !6
+
+27:                                               ; preds = %6
+  %28 = load i32, ptr %3, align 4
+  %29 = icmp ne i32 %28, 100
+  br i1 %29, label %30, label %32
+
+30:                                               ; preds = %27
+  %31 = load i32, ptr %5, align 4
+  call void @print(i32 noundef %31)
+  br label %32
+
+32:                                               ; preds = %30, %27
+  %33 = load i32, ptr %5, align 4
+  ret i32 %33
+}
+
+declare i32 @read(...) #1
+
+declare void @print(i32 noundef) #1
+
+attributes #0 = { noinline nounwind optnone uwtable "frame-pointer"="all" "min-legal-vector-width"="0" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+attributes #1 = { "frame-pointer"="all" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+
+!llvm.module.flags = !{!0, !1, !2, !3, !4}
+!llvm.ident = !{!5}
+
+!0 = !{i32 1, !"wchar_size", i32 4}
+!1 = !{i32 7, !"PIC Level", i32 2}
+!2 = !{i32 7, !"PIE Level", i32 2}
+!3 = !{i32 7, !"uwtable", i32 2}
+!4 = !{i32 7, !"frame-pointer", i32 2}
+!5 = !{!"Ubuntu clang version 15.0.7"}
+!6 = distinct !{!6, !7}
+!7 = !{!"llvm.loop.mustprogress"}
@@ -0,0 +1,20 @@
+extern void print(int);
+extern int read();
+
+int func(int p){
+	int a;
+	int b;
+	a = 10;
+	b = 0;
+	if (a > 5){
+		b = a + p;
+	}
+	else {
+		b = 99;
+	}
+	print(b);
+	while (a < 5){
+		a = a + 1;
+	}
+	return a;
+}
@@ -0,0 +1,65 @@
+; ModuleID = 'sccp_branch.c'
+source_filename = "sccp_branch.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-pc-linux-gnu"
+
+; Function Attrs: noinline nounwind optnone uwtable
+define dso_local i32 @func(i32 noundef %0) #0 {
+  %2 = alloca i32, align 4
+  %3 = alloca i32, align 4
+  %4 = alloca i32, align 4
+  store i32 %0, ptr %2, align 4
+  store i32 10, ptr %3, align 4
+  store i32 0, ptr %4, align 4
+  %5 = load i32, ptr %3, align 4
+  %6 = icmp sgt i32 %5, 5
+  br i1 %6, label %7, label %11
+
+7:                                                ; preds = %1
+  %8 = load i32, ptr %3, align 4
+  %9 = load i32, ptr %2, align 4
+  %10 = add nsw i32 %8, %9
+  store i32 %10, ptr %4, align 4
+  br label %12
+
+11:                                               ; preds = %1
+  store i32 99, ptr %4, align 4
+  br label %12
+
+12:                                               ; preds = %11, %7
+  %13 = load i32, ptr %4, align 4
+  call void @print(i32 noundef %13)
+  br label %14
+
+14:                                               ; preds = %17, %12
+  %15 = load i32, ptr %3, align 4
+  %16 = icmp slt i32 %15, 5
+  br i1 %16, label %17, label %20
+
+17:                                               ; preds = %14
+  %18 = load i32, ptr %3, align 4
+  %19 = add nsw i32 %18, 1
+  store i32 %19, ptr %3, align 4
+  br label %14, !llvm.loop !6
+
+20:                                               ; preds = %14
+  %21 = load i32, ptr %3, align 4
+  ret i32 %21
+}
+
+declare void @print(i32 noundef) #1
+
+attributes #0 = { noinline nounwind optnone uwtable "frame-pointer"="all" "min-legal-vector-width"="0" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+attributes #1 = { "frame-pointer"="all" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+
+!llvm.module.flags = !{!0, !1, !2, !3, !4}
+!llvm.ident = !{!5}
+
+!0 = !{i32 1, !"wchar_size", i32 4}
+!1 = !{i32 7, !"PIC Level", i32 2}
+!2 = !{i32 7, !"PIE Level", i32 2}
+!3 = !{i32 7, !"uwtable", i32 2}
+!4 = !{i32 7, !"frame-pointer", i32 2}
+!5 = !{!"Ubuntu clang version 15.0.7"}
+!6 = distinct !{!6, !7}
+!7 = !{!"llvm.loop.mustprogress"}
@@ -0,0 +1,33 @@
+extern void print(int);
+extern int read();
+
+int func(int n){
+	int i;
+	int j;
+	int s;
+	int k;
+	int m;
+	i = 0;
+	s = 0;
+	while (i < 4){
+		s = s + i * 10;
+		i = i + 1;
+	}
+	m = -3;
+	while (m <= 4){
+		s = s + 1;
+		m = m + 3;
+	}
+	j = 0;
+	while (j < n){
+		s = s + j;
+		j = j + 1;
+	}
+	k = 0;
+	while (k < n){
+		n = n - 1;
+		s = s + k;
+		k = k + 1;
+	}
+	return s;
+}
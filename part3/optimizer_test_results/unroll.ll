@@ -0,0 +1,116 @@
+; ModuleID = 'unroll.c'
+source_filename = "unroll.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-pc-linux-gnu"
+
+; Function Attrs: noinline nounwind optnone uwtable
+define dso_local i32 @func(i32 noundef %0) #0 {
+  %2 = alloca i32, align 4
+  %3 = alloca i32, align 4
+  %4 = alloca i32, align 4
+  %5 = alloca i32, align 4
+  %6 = alloca i32, align 4
+  %7 = alloca i32, align 4
+  store i32 %0, ptr %2, align 4
+  store i32 0, ptr %3, align 4
+  store i32 0, ptr %5, align 4
+  br label %8
+
+8:                                                ; preds = %11, %1
+  %9 = load i32, ptr %3, align 4
+  %10 = icmp slt i32 %9, 4
+  br i1 %10, label %11, label %18
+
+11:                                               ; preds = %8
+  %12 = load i32, ptr %5, align 4
+  %13 = load i32, ptr %3, align 4
+  %14 = mul nsw i32 %13, 10
+  %15 = add nsw i32 %12, %14
+  store i32 %15, ptr %5, align 4
+  %16 = load i32, ptr %3, align 4
+  %17 = add nsw i32 %16, 1
+  store i32 %17, ptr %3, align 4
+  br label %8, !llvm.loop !6
+
+18:                                               ; preds = %8
+  store i32 -3, ptr %7, align 4
+  br label %19
+
+19:                                               ; preds = %22, %18
+  %20 = load i32, ptr %7, align 4
+  %21 = icmp sle i32 %20, 4
+  br i1 %21, label %22, label %27
+
+22:                                               ; preds = %19
+  %23 = load i32, ptr %5, align 4
+  %24 = add nsw i32 %23, 1
+  store i32 %24, ptr %5, align 4
+  %25 = load i32, ptr %7, align 4
+  %26 = add nsw i32 %25, 3
+  store i32 %26, ptr %7, align 4
+  br label %19, !llvm.loop !8
+
+27:                                               ; preds = %19
+  store i32 0, ptr %4, align 4
+  br label %28
+
+28:                                               ; preds = %32, %27
+  %29 = load i32, ptr %4, align 4
+  %30 = load i32, ptr %2, align 4
+  %31 = icmp slt i32 %29, %30
+  br i1 %31, label %32, label %38
+
+32:                                               ; preds = %28
+  %33 = load i32, ptr %5, align 4
+  %34 = load i32, ptr %4, align 4
+  %35 = add nsw i32 %33, %34
+  store i32 %35, ptr %5, align 4
+  %36 = load i32, ptr %4, align 4
+  %37 = add nsw i32 %36, 1
+  store i32 %37, ptr %4, align 4
+  br label %28, !llvm.loop !9
+
+38:                                               ; preds = %28
+  store i32 0, ptr %6, align 4
+  br label %39
+
+39:                                               ; preds = %43, %38
+  %40 = load i32, ptr %6, align 4
+  %41 = load i32, ptr %2, align 4
+  %42 = icmp slt i32 %40, %41
+  br i1 %42, label %43, label %51
+
+43:                                               ; preds = %39
+  %44 = load i32, ptr %2, align 4
+  %45 = sub nsw i32 %44, 1
+  store i32 %45, ptr %2, align 4
+  %46 = load i32, ptr %5, align 4
+  %47 = load i32, ptr %6, align 4
+  %48 = add nsw i32 %46, %47
+  store i32 %48, ptr %5, align 4
+  %49 = load i32, ptr %6, align 4
+  %50 = add nsw i32 %49, 1
+  store i32 %50, ptr %6, align 4
+  br label %39, !llvm.loop !10
+
+51:                                               ; preds = %39
+  %52 = load i32, ptr %5, align 4
+  ret i32 %52
+}
+
+attributes #0 = { noinline nounwind optnone uwtable "frame-pointer"="all" "min-legal-vector-width"="0" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+
+!llvm.module.flags = !{!0, !1, !2, !3, !4}
+!llvm.ident = !{!5}
+
+!0 = !{i32 1, !"wchar_size", i32 4}
+!1 = !{i32 7, !"PIC Level", i32 2}
+!2 = !{i32 7, !"PIE Level", i32 2}
+!3 = !{i32 7, !"uwtable", i32 2}
+!4 = !{i32 7, !"frame-pointer", i32 2}
+!5 = !{!"Ubuntu clang version 15.0.7"}
+!6 = distinct !{!6, !7}
+!7 = !{!"llvm.loop.mustprogress"}
+!8 = distinct !{!8, !7}
+!9 = distinct !{!9, !7}
+!10 = distinct !{!10, !7}
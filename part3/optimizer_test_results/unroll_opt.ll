@@ -0,0 +1,127 @@
+; ModuleID = 'optimizer_test_results/unroll.ll'
+source_filename = "unroll.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-pc-linux-gnu"
+
+; Function Attrs: noinline nounwind optnone uwtable
+define dso_local i32 @func(i32 noundef %0) #0 {
+  %2 = alloca i32, align 4
+  %3 = alloca i32, align 4
+  %4 = alloca i32, align 4
+  %5 = alloca i32, align 4
+  %6 = alloca i32, align 4
+  %7 = alloca i32, align 4
+  store i32 %0, ptr %2, align 4
+  store i32 0, ptr %3, align 4
+  store i32 0, ptr %5, align 4
+  store i32 0, ptr %5, align 4
+  store i32 1, ptr %3, align 4
+  store i32 10, ptr %5, align 4
+  store i32 2, ptr %3, align 4
+  store i32 30, ptr %5, align 4
+  store i32 3, ptr %3, align 4
+  store i32 60, ptr %5, align 4
+  store i32 4, ptr %3, align 4
+  store i32 -3, ptr %7, align 4
+  store i32 61, ptr %5, align 4
+  store i32 0, ptr %7, align 4
+  store i32 62, ptr %5, align 4
+  store i32 3, ptr %7, align 4
+  store i32 63, ptr %5, align 4
+  store i32 6, ptr %7, align 4
+  store i32 0, ptr %4, align 4
+  br label %8
+
+8:                                                ; preds = %1, %15
+  %9 = load i32, ptr %4, align 4
+  %10 = load i32, ptr %2, align 4
+  %11 = sext i32 %9 to i64
+  %12 = sext i32 %10 to i64
+  %13 = add i64 %11, 3
+  %14 = icmp slt i64 %13, %12
+  br i1 %14, label %15, label %32, !minic.unrolled !6
+
+15:                                               ; preds = %8
+  %16 = load i32, ptr %5, align 4
+  %17 = load i32, ptr %4, align 4
+  %18 = add nsw i32 %16, %17
+  store i32 %18, ptr %5, align 4
+  %19 = add nsw i32 %17, 1
+  store i32 %19, ptr %4, align 4
+  %20 = load i32, ptr %5, align 4
+  %21 = load i32, ptr %4, align 4
+  %22 = add nsw i32 %20, %21
+  store i32 %22, ptr %5, align 4
+  %23 = add nsw i32 %21, 1
+  store i32 %23, ptr %4, align 4
+  %24 = load i32, ptr %5, align 4
+  %25 = load i32, ptr %4, align 4
+  %26 = add nsw i32 %24, %25
+  store i32 %26, ptr %5, align 4
+  %27 = add nsw i32 %25, 1
+  store i32 %27, ptr %4, align 4
+  %28 = load i32, ptr %5, align 4
+  %29 = load i32, ptr %4, align 4
+  %30 = add nsw i32 %28, %29
+  store i32 %30, ptr %5, align 4
+  %31 = add nsw i32 %29, 1
+  store i32 %31, ptr %4, align 4
+  br label %8, !llvm.loop !7
+
+32:                                               ; preds = %8, %36
+  %33 = load i32, ptr %4, align 4
+  %34 = load i32, ptr %2, align 4
+  %35 = icmp slt i32 %33, %34
+  br i1 %35, label %36, label %41, !minic.unrolled !6
+
+36:                                               ; preds = %32
+  %37 = load i32, ptr %5, align 4
+  %38 = load i32, ptr %4, align 4
+  %39 = add nsw i32 %37, %38
+  store i32 %39, ptr %5, align 4
+  %40 = add nsw i32 %38, 1
+  store i32 %40, ptr %4, align 4
+  br label %32, !llvm.loop !7
+
+41:                                               ; preds = %32
+  store i32 0, ptr %6, align 4
+  br label %42
+
+42:                                               ; preds = %46, %41
+  %43 = load i32, ptr %6, align 4
+  %44 = load i32, ptr %2, align 4
+  %45 = icmp slt i32 %43, %44
+  br i1 %45, label %46, label %53
+
+46:                                               ; preds = %42
+  %47 = load i32, ptr %2, align 4
+  %48 = sub nsw i32 %47, 1
+  store i32 %48, ptr %2, align 4
+  %49 = load i32, ptr %5, align 4
+  %50 = load i32, ptr %6, align 4
+  %51 = add nsw i32 %49, %50
+  store i32 %51, ptr %5, align 4
+  %52 = add nsw i32 %50, 1
+  store i32 %52, ptr %6, align 4
+  br label %42, !llvm.loop !9
+
+53:                                               ; preds = %42
+  %54 = load i32, ptr %5, align 4
+  ret i32 %54
+}
+
+attributes #0 = { noinline nounwind optnone uwtable "frame-pointer"="all" "min-legal-vector-width"="0" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="x86-64" "target-features"="+cx8,+fxsr,+mmx,+sse,+sse2,+x87" "tune-cpu"="generic" }
+
+!llvm.module.flags = !{!0, !1, !2, !3, !4}
+!llvm.ident = !{!5}
+
+!0 = !{i32 1, !"wchar_size", i32 4}
+!1 = !{i32 7, !"PIC Level", i32 2}
+!2 = !{i32 7, !"PIE Level", i32 2}
+!3 = !{i32 7, !"uwtable", i32 2}
+!4 = !{i32 7, !"frame-pointer", i32 2}
+!5 = !{!"Ubuntu clang version 15.0.7"}
+!6 = !{}
+!7 = distinct !{!7, !8}
+!8 = !{!"llvm.loop.mustprogress"}
+!9 = distinct !{!9, !8}
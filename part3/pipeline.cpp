@@ -0,0 +1,199 @@
+#include "optimizer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// PASS PIPELINE
+// ============================================================================
+// the default passes plus whichever optional ones the command line switched
+// on, run to a fixed point. shared by the optimizer, which reads a .ll file,
+// and by anything that builds its module in memory (part2)
+
+// optional passes
+// passes that are off by default and switched on from the command line
+// enabled passes run inside the fixed-point loop after the default ones,
+// in the order they appear in this table
+
+struct optional_pass {
+    const char *flag;                   // command line switch
+    const char *description;            // shown in the usage message
+    bool (*run)(LLVMModuleRef module);  // the pass itself
+    bool enabled;
+    bool needs_allocas;                 // only finds loop counters kept in allocas
+};
+
+static optional_pass optional_passes[] = {
+    { "--sccp", "sparse conditional constant propagation",
+      sparse_conditional_constant_propagation, false },
+    { "--ranges", "fold compares decided by value ranges, mark divisions that can't trap",
+      value_range_analysis, false },
+    { "--simplify-cfg", "fold constant branches, remove dead blocks, merge chains",
+      cfg_simplification, false },
+    { "--instcombine", "fold icmp/sdiv/zext on constants, identities, x*2^k -> shl",
+      instruction_combining, false },
+    { "--dse", "delete stores no load can observe, and write-only locals",
+      dead_store_elimination, false },
+    { "--forward", "forward stored values to later loads, phis at joins",
+      store_to_load_forwarding, false },
+    { "--pre", "partial redundancy elimination by lazy code motion",
+      partial_redundancy_elimination, false },
+    { "--hoist-sink", "move instructions common to both if/else arms out of them",
+      code_hoisting_sinking, false },
+    { "--if-convert", "turn small if/else arms into selects",
+      if_conversion, false },
+    { "--jump-threading", "send edges that decide the next branch straight to its target",
+      jump_threading, false },
+    { "--licm", "hoist loop-invariant code, sink stores out of loops",
+      loop_invariant_code_motion, false },
+    { "--indvars", "strength-reduce loop counter multiplies, closed-form counting loops",
+      induction_variable_optimization, false, true },
+    { "--unroll", "unroll small constant-trip loops fully, others partially",
+      loop_unrolling, false, true },
+    { "--div-by-const", "rewrite x / c and x % c as multiply-high and shifts",
+      division_by_constant, false },
+};
+
+static const int num_optional_passes = sizeof(optional_passes) / sizeof(optional_passes[0]);
+
+// --count <n>
+static bool count = false;
+static long long count_argument = 0;
+
+bool parse_pipeline_option(int argc, char **argv, int *i) {
+    const char *arg = argv[*i];
+    bool has_value = *i + 1 < argc;
+
+    if (strcmp(arg, "--count") == 0 && has_value) {
+        count = true;
+        count_argument = atoll(argv[++*i]);
+        return true;
+    }
+    if (strcmp(arg, "--unroll-factor") == 0 && has_value) {
+        unroll_cost.partial_factor = atoi(argv[++*i]);
+        return true;
+    }
+    if (strcmp(arg, "--unroll-size") == 0 && has_value) {
+        unroll_cost.full_max_size = atoi(argv[++*i]);
+        return true;
+    }
+    if (strcmp(arg, "--jump-thread-size") == 0 && has_value) {
+        jump_thread_cost.max_block_size = atoi(argv[++*i]);
+        return true;
+    }
+
+    for (int p = 0; p < num_optional_passes; p++) {
+        if (strcmp(arg, optional_passes[p].flag) == 0) {
+            optional_passes[p].enabled = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool pipeline_needs_allocas() {
+    for (int p = 0; p < num_optional_passes; p++) {
+        if (optional_passes[p].enabled && optional_passes[p].needs_allocas) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void print_pipeline_options() {
+    for (int i = 0; i < num_optional_passes; i++) {
+        fprintf(stderr, "  %-22s %s\n", optional_passes[i].flag, optional_passes[i].description);
+    }
+    fprintf(stderr, "  %-22s %s\n", "--count <n>",
+            "interpret func(n) before and after, report instruction and branch miss counts");
+    fprintf(stderr, "  %-22s %s (default %d)\n", "--unroll-factor <n>",
+            "bodies per test in partially unrolled loops", unroll_cost.partial_factor);
+    fprintf(stderr, "  %-22s %s (default %d)\n", "--unroll-size <n>",
+            "largest fully unrolled loop, in instructions", unroll_cost.full_max_size);
+    fprintf(stderr, "  %-22s %s (default %d)\n", "--jump-thread-size <n>",
+            "largest block copied by jump threading", jump_thread_cost.max_block_size);
+}
+
+// the function --count runs: the first one with a body
+static LLVMValueRef first_defined_function(LLVMModuleRef module) {
+    for (LLVMValueRef function = LLVMGetFirstFunction(module);
+         function != NULL;
+         function = LLVMGetNextFunction(function)) {
+        if (LLVMGetFirstBasicBlock(function) != NULL) {
+            return function;
+        }
+    }
+    return NULL;
+}
+
+bool optimize_module(LLVMModuleRef module) {
+    // with --count, run the unoptimized function once for reference
+    // (both runs see the same read() values)
+    interpreter_input input;
+    interpreter_result before;
+    if (count && !interpret_function(first_defined_function(module), count_argument,
+                                     &input, &before)) {
+        fprintf(stderr, "error: can't interpret the input\n");
+        return false;
+    }
+
+    // run optimizations in a loop until fixed point
+    bool changed = true;
+    int iteration = 0;
+    
+    while (changed) {
+        changed = false;
+        iteration++;
+        
+        // run dead code elimination
+        // removes instructions with no uses
+        bool dce_changed = dead_code_elimination(module);
+        changed |= dce_changed;
+        
+        // run constant folding
+        // pre-computes arithmetic on constants
+        bool cf_changed = constant_folding(module);
+        changed |= cf_changed;
+        
+        // run common subexpression elimination
+        // removes duplicate calculations
+        bool cse_changed = common_subexpression_elimination(module);
+        changed |= cse_changed;
+        
+        // run constant propagation (when implemented)
+        // tracks constants through store/load instructions
+        bool cp_changed = constant_propagation(module);
+        changed |= cp_changed;
+        
+        // run the optional passes switched on from the command line
+        for (int p = 0; p < num_optional_passes; p++) {
+            if (optional_passes[p].enabled) {
+                changed |= optional_passes[p].run(module);
+            }
+        }
+    }
+    
+    // with --count, run it again and compare (stderr, so stdout stays IR)
+    if (count) {
+        interpreter_result after;
+        if (!interpret_function(first_defined_function(module), count_argument,
+                                &input, &after)) {
+            fprintf(stderr, "error: can't interpret the optimized IR\n");
+            return false;
+        }
+        bool same = before.return_value == after.return_value && before.printed == after.printed;
+        fprintf(stderr, "dynamic instructions: %lld before, %lld after (%+.1f%%), "
+                "branch misses: %lld before, %lld after, results %s\n",
+                before.instructions, after.instructions,
+                before.instructions > 0
+                    ? 100.0 * (after.instructions - before.instructions) / before.instructions
+                    : 0.0,
+                before.mispredicted, after.mispredicted,
+                same ? "match" : "DIFFER");
+        if (!same) {
+            return false;
+        }
+    }
+
+    return true;
+}
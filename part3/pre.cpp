@@ -0,0 +1,568 @@
+#include "optimizer.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+// ============================================================================
+// PARTIAL REDUNDANCY ELIMINATION (LAZY CODE MOTION)
+// ============================================================================
+// an expression (a pure instruction: same opcode, same operands) that is
+// computed on some paths into a join and again after it is partially
+// redundant. lazy code motion moves computations to the latest points
+// where they are needed on every path, so no path computes an expression
+// more often than before, and most compute it less often.
+//
+// the four dataflow problems (Dragon book, 9.5), over sets of expressions:
+//   ANTICIPATED_IN[B] = USE[B] + (ANTICIPATED_OUT[B] - KILL[B])
+//   ANTICIPATED_OUT[B] = intersection of ANTICIPATED_IN[S]
+//   AVAILABLE_OUT[B] = (ANTICIPATED_IN[B] + AVAILABLE_IN[B]) - KILL[B]
+//   AVAILABLE_IN[B] = intersection of AVAILABLE_OUT[P]
+//   EARLIEST[B] = ANTICIPATED_IN[B] - AVAILABLE_IN[B]
+//   POSTPONABLE_OUT[B] = (EARLIEST[B] + POSTPONABLE_IN[B]) - USE[B]
+//   POSTPONABLE_IN[B] = intersection of POSTPONABLE_OUT[P]
+//   LATEST[B] = (EARLIEST[B] + POSTPONABLE_IN[B]) &
+//               (USE[B] + not(intersection of EARLIEST[S] + POSTPONABLE_IN[S]))
+//   USED_IN[B] = (USE[B] + USED_OUT[B]) - LATEST[B]
+//   USED_OUT[B] = union of USED_IN[S]
+// USE[B] are the expressions B computes from operands defined elsewhere,
+// KILL[B] the expressions with an operand defined in B (this is SSA, an
+// operand's definition is the only thing that changes an expression).
+//
+// every edge into a join gets its own block first, so a computation can be
+// placed on an edge. the expression's value travels through a temporary
+// alloca: `t = e` at the insertion points, `load t` where it is reused;
+// forward_slot_values then turns the temporary into phis. edge blocks that
+// stayed empty, or that follow a block with a single successor, are
+// removed again.
+//
+// only instructions that can't trap are moved, a division placed earlier
+// could fault before a print() that used to run first
+
+typedef vector<bool> expr_set;
+
+struct pre_state {
+    vector<LLVMValueRef> exprs;             // one instruction per expression
+    vector<LLVMBasicBlockRef> blocks;       // reachable blocks, function order
+    unordered_map<LLVMBasicBlockRef, vector<LLVMBasicBlockRef>> preds;
+    unordered_map<LLVMBasicBlockRef, vector<LLVMBasicBlockRef>> succs;
+
+    unordered_map<LLVMBasicBlockRef, expr_set> use, kill;
+    unordered_map<LLVMBasicBlockRef, expr_set> anticipated_in, available_in;
+    unordered_map<LLVMBasicBlockRef, expr_set> earliest, postponable_in;
+    unordered_map<LLVMBasicBlockRef, expr_set> latest, used_out;
+};
+
+// pure instructions that can never trap
+static bool is_pre_candidate(LLVMValueRef inst) {
+    switch (LLVMGetInstructionOpcode(inst)) {
+        case LLVMAdd: case LLVMSub: case LLVMMul:
+        case LLVMShl: case LLVMLShr: case LLVMAShr:
+        case LLVMAnd: case LLVMOr: case LLVMXor:
+        case LLVMICmp: case LLVMZExt: case LLVMSExt: case LLVMTrunc:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// set operations
+// ----------------------------------------------------------------------------
+
+static expr_set set_union(const expr_set &a, const expr_set &b) {
+    expr_set r(a.size());
+    for (size_t i = 0; i < a.size(); i++) r[i] = a[i] || b[i];
+    return r;
+}
+
+static expr_set set_intersect(const expr_set &a, const expr_set &b) {
+    expr_set r(a.size());
+    for (size_t i = 0; i < a.size(); i++) r[i] = a[i] && b[i];
+    return r;
+}
+
+static expr_set set_minus(const expr_set &a, const expr_set &b) {
+    expr_set r(a.size());
+    for (size_t i = 0; i < a.size(); i++) r[i] = a[i] && !b[i];
+    return r;
+}
+
+static expr_set set_complement(const expr_set &a) {
+    expr_set r(a.size());
+    for (size_t i = 0; i < a.size(); i++) r[i] = !a[i];
+    return r;
+}
+
+// ----------------------------------------------------------------------------
+// edge blocks
+// ----------------------------------------------------------------------------
+
+// number of edges from -> to
+static unsigned count_edges(LLVMBasicBlockRef from, LLVMBasicBlockRef to) {
+    LLVMValueRef term = LLVMGetBasicBlockTerminator(from);
+    unsigned num_succs = LLVMGetNumSuccessors(term);
+    unsigned count = 0;
+    for (unsigned i = 0; i < num_succs; i++) {
+        if (LLVMGetSuccessor(term, i) == to) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// put an empty block on every edge into a block with several predecessors
+static void split_join_edges(LLVMValueRef function, vector<LLVMBasicBlockRef> &edge_blocks) {
+    unordered_map<LLVMBasicBlockRef, vector<LLVMBasicBlockRef>> preds;
+    compute_predecessors(function, preds);
+
+    LLVMContextRef context = LLVMGetModuleContext(LLVMGetGlobalParent(function));
+    LLVMBuilderRef builder = LLVMCreateBuilderInContext(context);
+
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+
+        if (preds[bb].size() < 2) {
+            continue;
+        }
+
+        for (LLVMBasicBlockRef pred : preds[bb]) {
+            // a branch with both arms on bb would need two edge blocks, and
+            // its phi entries can't tell them apart
+            if (count_edges(pred, bb) != 1) {
+                continue;
+            }
+
+            LLVMBasicBlockRef edge = LLVMInsertBasicBlockInContext(context, bb, "");
+            LLVMPositionBuilderAtEnd(builder, edge);
+            LLVMBuildBr(builder, bb);
+            retarget_branch(pred, bb, edge);
+            replace_phi_incoming_block(bb, pred, edge);
+            edge_blocks.push_back(edge);
+        }
+    }
+
+    LLVMDisposeBuilder(builder);
+}
+
+// remove the edge blocks again: empty ones, and ones whose predecessor
+// has no other successor (their code moves up into the predecessor)
+static void remove_edge_blocks(const vector<LLVMBasicBlockRef> &edge_blocks) {
+    for (LLVMBasicBlockRef edge : edge_blocks) {
+        LLVMValueRef term = LLVMGetBasicBlockTerminator(edge);
+        LLVMBasicBlockRef target = LLVMGetSuccessor(term, 0);
+        LLVMBasicBlockRef pred = NULL;
+        LLVMValueRef function = LLVMGetBasicBlockParent(edge);
+        for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+             bb != NULL && pred == NULL;
+             bb = LLVMGetNextBasicBlock(bb)) {
+            if (LLVMGetBasicBlockTerminator(bb) != NULL && count_edges(bb, edge) > 0) {
+                pred = bb;
+            }
+        }
+
+        if (LLVMGetFirstInstruction(edge) != term) {
+            if (pred == NULL || LLVMGetNumSuccessors(LLVMGetBasicBlockTerminator(pred)) != 1) {
+                continue;
+            }
+            LLVMBuilderRef builder = LLVMCreateBuilder();
+            LLVMPositionBuilderBefore(builder, LLVMGetBasicBlockTerminator(pred));
+            while (LLVMGetFirstInstruction(edge) != term) {
+                LLVMValueRef inst = LLVMGetFirstInstruction(edge);
+                LLVMInstructionRemoveFromParent(inst);
+                LLVMInsertIntoBuilder(builder, inst);
+            }
+            LLVMDisposeBuilder(builder);
+        }
+
+        if (pred != NULL) {
+            retarget_branch(pred, edge, target);
+            replace_phi_incoming_block(target, edge, pred);
+        } else {
+            remove_phi_incoming(target, edge);
+        }
+        LLVMDeleteBasicBlock(edge);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// local sets
+// ----------------------------------------------------------------------------
+
+// index of inst's expression, or -1
+static int find_expression(pre_state &st, LLVMValueRef inst) {
+    for (size_t i = 0; i < st.exprs.size(); i++) {
+        if (instructions_equal(st.exprs[i], inst)) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+// true if no operand of inst is defined in its own block
+static bool is_upward_exposed(LLVMValueRef inst) {
+    LLVMBasicBlockRef bb = LLVMGetInstructionParent(inst);
+    int num_ops = LLVMGetNumOperands(inst);
+    for (int i = 0; i < num_ops; i++) {
+        LLVMValueRef op = LLVMGetOperand(inst, i);
+        if (LLVMIsAInstruction(op) && LLVMGetInstructionParent(op) == bb) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// collect expressions computed in more than one block, with USE and KILL
+static void compute_local_sets(LLVMValueRef function, pre_state &st) {
+    // the blocks reachable from the entry
+    unordered_set<LLVMBasicBlockRef> reachable;
+    vector<LLVMBasicBlockRef> worklist;
+    worklist.push_back(LLVMGetFirstBasicBlock(function));
+    reachable.insert(worklist.back());
+    while (!worklist.empty()) {
+        LLVMBasicBlockRef bb = worklist.back();
+        worklist.pop_back();
+        LLVMValueRef term = LLVMGetBasicBlockTerminator(bb);
+        unsigned num_succs = LLVMGetNumSuccessors(term);
+        for (unsigned i = 0; i < num_succs; i++) {
+            LLVMBasicBlockRef succ = LLVMGetSuccessor(term, i);
+            if (reachable.insert(succ).second) {
+                worklist.push_back(succ);
+            }
+        }
+    }
+
+    unordered_map<LLVMBasicBlockRef, vector<LLVMBasicBlockRef>> all_preds;
+    compute_predecessors(function, all_preds);
+
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+        if (!reachable.count(bb)) {
+            continue;
+        }
+        st.blocks.push_back(bb);
+        for (LLVMBasicBlockRef pred : all_preds[bb]) {
+            if (reachable.count(pred)) {
+                st.preds[bb].push_back(pred);
+                st.succs[pred].push_back(bb);
+            }
+        }
+    }
+
+    // expressions with an upward-exposed computation, and in how many
+    // blocks; one block alone has nothing to share
+    vector<LLVMValueRef> candidates;
+    vector<int> block_count;
+    for (LLVMBasicBlockRef bb : st.blocks) {
+        vector<int> seen;
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+             inst != NULL;
+             inst = LLVMGetNextInstruction(inst)) {
+            if (!is_pre_candidate(inst) || !is_upward_exposed(inst)) {
+                continue;
+            }
+            int id = -1;
+            for (size_t i = 0; i < candidates.size(); i++) {
+                if (instructions_equal(candidates[i], inst)) {
+                    id = (int)i;
+                    break;
+                }
+            }
+            if (id < 0) {
+                candidates.push_back(inst);
+                block_count.push_back(0);
+                id = (int)candidates.size() - 1;
+            }
+            bool counted = false;
+            for (int s : seen) {
+                counted |= s == id;
+            }
+            if (!counted) {
+                seen.push_back(id);
+                block_count[id]++;
+            }
+        }
+    }
+    for (size_t i = 0; i < candidates.size(); i++) {
+        if (block_count[i] > 1) {
+            st.exprs.push_back(candidates[i]);
+        }
+    }
+
+    size_t n = st.exprs.size();
+    for (LLVMBasicBlockRef bb : st.blocks) {
+        st.use[bb] = expr_set(n);
+        st.kill[bb] = expr_set(n);
+    }
+
+    for (LLVMBasicBlockRef bb : st.blocks) {
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+             inst != NULL;
+             inst = LLVMGetNextInstruction(inst)) {
+            if (is_pre_candidate(inst) && is_upward_exposed(inst)) {
+                int id = find_expression(st, inst);
+                if (id >= 0) {
+                    st.use[bb][id] = true;
+                }
+            }
+        }
+    }
+
+    // an expression is killed where one of its operands is defined
+    for (size_t e = 0; e < n; e++) {
+        int num_ops = LLVMGetNumOperands(st.exprs[e]);
+        for (int i = 0; i < num_ops; i++) {
+            LLVMValueRef op = LLVMGetOperand(st.exprs[e], i);
+            if (LLVMIsAInstruction(op)) {
+                LLVMBasicBlockRef def_bb = LLVMGetInstructionParent(op);
+                if (st.kill.count(def_bb)) {
+                    st.kill[def_bb][e] = true;
+                }
+            }
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// the dataflow problems
+// ----------------------------------------------------------------------------
+
+static void compute_placement(LLVMValueRef function, pre_state &st) {
+    size_t n = st.exprs.size();
+    expr_set all(n, true);
+    expr_set none(n, false);
+    LLVMBasicBlockRef entry = LLVMGetFirstBasicBlock(function);
+
+    // anticipated expressions (backwards, intersection)
+    for (LLVMBasicBlockRef bb : st.blocks) {
+        st.anticipated_in[bb] = all;
+    }
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto it = st.blocks.rbegin(); it != st.blocks.rend(); ++it) {
+            LLVMBasicBlockRef bb = *it;
+            expr_set out = st.succs[bb].empty() ? none : all;
+            for (LLVMBasicBlockRef succ : st.succs[bb]) {
+                out = set_intersect(out, st.anticipated_in[succ]);
+            }
+            expr_set in = set_union(st.use[bb], set_minus(out, st.kill[bb]));
+            if (in != st.anticipated_in[bb]) {
+                st.anticipated_in[bb] = in;
+                changed = true;
+            }
+        }
+    }
+
+    // available expressions (forwards, intersection)
+    unordered_map<LLVMBasicBlockRef, expr_set> available_out;
+    for (LLVMBasicBlockRef bb : st.blocks) {
+        available_out[bb] = all;
+    }
+    changed = true;
+    while (changed) {
+        changed = false;
+        for (LLVMBasicBlockRef bb : st.blocks) {
+            expr_set in = bb == entry ? none : all;
+            for (LLVMBasicBlockRef pred : st.preds[bb]) {
+                in = set_intersect(in, available_out[pred]);
+            }
+            st.available_in[bb] = in;
+            expr_set out = set_minus(set_union(st.anticipated_in[bb], in), st.kill[bb]);
+            if (out != available_out[bb]) {
+                available_out[bb] = out;
+                changed = true;
+            }
+        }
+    }
+
+    for (LLVMBasicBlockRef bb : st.blocks) {
+        st.earliest[bb] = set_minus(st.anticipated_in[bb], st.available_in[bb]);
+    }
+
+    // postponable expressions (forwards, intersection)
+    unordered_map<LLVMBasicBlockRef, expr_set> postponable_out;
+    for (LLVMBasicBlockRef bb : st.blocks) {
+        postponable_out[bb] = all;
+    }
+    changed = true;
+    while (changed) {
+        changed = false;
+        for (LLVMBasicBlockRef bb : st.blocks) {
+            expr_set in = bb == entry ? none : all;
+            for (LLVMBasicBlockRef pred : st.preds[bb]) {
+                in = set_intersect(in, postponable_out[pred]);
+            }
+            st.postponable_in[bb] = in;
+            expr_set out = set_minus(set_union(st.earliest[bb], in), st.use[bb]);
+            if (out != postponable_out[bb]) {
+                postponable_out[bb] = out;
+                changed = true;
+            }
+        }
+    }
+
+    for (LLVMBasicBlockRef bb : st.blocks) {
+        expr_set succ_ok = all;
+        for (LLVMBasicBlockRef succ : st.succs[bb]) {
+            succ_ok = set_intersect(succ_ok, set_union(st.earliest[succ], st.postponable_in[succ]));
+        }
+        st.latest[bb] = set_intersect(set_union(st.earliest[bb], st.postponable_in[bb]),
+                                      set_union(st.use[bb], set_complement(succ_ok)));
+    }
+
+    // used expressions (backwards, union)
+    unordered_map<LLVMBasicBlockRef, expr_set> used_in;
+    for (LLVMBasicBlockRef bb : st.blocks) {
+        used_in[bb] = none;
+        st.used_out[bb] = none;
+    }
+    changed = true;
+    while (changed) {
+        changed = false;
+        for (auto it = st.blocks.rbegin(); it != st.blocks.rend(); ++it) {
+            LLVMBasicBlockRef bb = *it;
+            expr_set out = none;
+            for (LLVMBasicBlockRef succ : st.succs[bb]) {
+                out = set_union(out, used_in[succ]);
+            }
+            st.used_out[bb] = out;
+            expr_set in = set_minus(set_union(st.use[bb], out), st.latest[bb]);
+            if (in != used_in[bb]) {
+                used_in[bb] = in;
+                changed = true;
+            }
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// the rewrite
+// ----------------------------------------------------------------------------
+
+// first instruction after the phis (and, in the entry block, the allocas)
+static LLVMValueRef insertion_point(LLVMBasicBlockRef bb) {
+    LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+    while (LLVMIsAPHINode(inst) || LLVMIsAAllocaInst(inst)) {
+        inst = LLVMGetNextInstruction(inst);
+    }
+    return inst;
+}
+
+// place the computations and reuse them, collecting the temporaries
+static bool rewrite(LLVMValueRef function, pre_state &st,
+                    unordered_set<LLVMValueRef> &temps) {
+    LLVMBasicBlockRef entry = LLVMGetFirstBasicBlock(function);
+    LLVMBuilderRef builder = LLVMCreateBuilder();
+    vector<LLVMValueRef> dead;
+    bool changed = false;
+
+    for (size_t e = 0; e < st.exprs.size(); e++) {
+        LLVMValueRef temp = NULL;
+
+        for (LLVMBasicBlockRef bb : st.blocks) {
+            bool insert = st.latest[bb][e] && st.used_out[bb][e];
+            bool keep = st.latest[bb][e] && !st.used_out[bb][e];
+            bool replace = st.use[bb][e] && !keep;
+            if (!insert && !replace) {
+                continue;
+            }
+
+            if (temp == NULL) {
+                LLVMPositionBuilderBefore(builder, LLVMGetFirstInstruction(entry));
+                temp = LLVMBuildAlloca(builder, LLVMTypeOf(st.exprs[e]), "");
+                temps.insert(temp);
+            }
+
+            // t = e at the top of the block
+            LLVMValueRef value = NULL;
+            if (insert) {
+                value = LLVMInstructionClone(st.exprs[e]);
+                LLVMPositionBuilderBefore(builder, insertion_point(bb));
+                LLVMInsertIntoBuilder(builder, value);
+                LLVMBuildStore(builder, value, temp);
+            }
+
+            if (!replace) {
+                continue;
+            }
+
+            // the block's own computations take the value from t
+            vector<LLVMValueRef> occurrences;
+            for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+                 inst != NULL;
+                 inst = LLVMGetNextInstruction(inst)) {
+                if (inst != value && is_pre_candidate(inst) && is_upward_exposed(inst) &&
+                    instructions_equal(inst, st.exprs[e])) {
+                    occurrences.push_back(inst);
+                }
+            }
+            if (value == NULL) {
+                LLVMPositionBuilderBefore(builder, occurrences[0]);
+                value = LLVMBuildLoad2(builder, LLVMTypeOf(st.exprs[e]), temp, "");
+            }
+            for (LLVMValueRef inst : occurrences) {
+                LLVMReplaceAllUsesWith(inst, value);
+                dead.push_back(inst);
+            }
+            changed = true;
+        }
+    }
+
+    // erased only now, the representatives are still cloned and compared
+    for (LLVMValueRef inst : dead) {
+        LLVMInstructionEraseFromParent(inst);
+    }
+
+    LLVMDisposeBuilder(builder);
+    return changed;
+}
+
+// delete the temporaries once forwarding has left only their stores
+static void remove_temps(const unordered_set<LLVMValueRef> &temps) {
+    for (LLVMValueRef temp : temps) {
+        while (LLVMGetFirstUse(temp) != NULL) {
+            LLVMInstructionEraseFromParent(LLVMGetUser(LLVMGetFirstUse(temp)));
+        }
+        LLVMInstructionEraseFromParent(temp);
+    }
+}
+
+// ============================================================================
+// MAIN PASS: partial_redundancy_elimination
+// ============================================================================
+bool partial_redundancy_elimination(LLVMModuleRef module) {
+    bool changed = false;
+
+    // iterate through all functions
+    for (LLVMValueRef function = LLVMGetFirstFunction(module);
+         function != NULL;
+         function = LLVMGetNextFunction(function)) {
+
+        if (LLVMGetFirstBasicBlock(function) == NULL) {
+            continue;
+        }
+
+        vector<LLVMBasicBlockRef> edge_blocks;
+        split_join_edges(function, edge_blocks);
+
+        pre_state st;
+        compute_local_sets(function, st);
+
+        unordered_set<LLVMValueRef> temps;
+        if (!st.exprs.empty()) {
+            compute_placement(function, st);
+            changed |= rewrite(function, st, temps);
+        }
+
+        if (!temps.empty()) {
+            forward_slot_values(function, temps);
+            remove_temps(temps);
+        }
+        remove_edge_blocks(edge_blocks);
+    }
+
+    return changed;
+}
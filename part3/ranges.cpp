@@ -0,0 +1,755 @@
+#include "optimizer.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <set>
+#include <utility>
+
+using namespace std;
+
+// ============================================================================
+// VALUE RANGE ANALYSIS
+// ============================================================================
+// every integer value gets a signed interval [lo, hi] of the values it can
+// take. like sccp, blocks only count once an edge into them is executable
+// and a branch whose condition is decided only marks the edge it takes,
+// but the lattice is much taller:
+//
+//     EMPTY (nothing seen yet)  ->  [lo, hi]  ->  FULL (any value)
+//
+// conditional branches also narrow their operands. in a block whose only
+// predecessor ends in `br (a < i)`, a is below the largest i on the true
+// side, and that holds in every block the edge dominates:
+//
+//   a = 5;                          header: a in [5, MAX]
+//   while (a < i)                   body:   a in [5, MAX - 1]
+//       a = a + 1;                          a + 1 in [6, MAX], no wrap
+//
+// a loop counter grows one step per round, so merge points inside loops
+// (header phis, and the loads of loop variables before --forward) are
+// widened once they have grown twice: a bound that still moves jumps to the
+// next constant the function compares against (or to the end of the type),
+// which keeps `i < 100` loops at [0, 100] instead of [0, MAX]
+//
+// the results:
+//   - an icmp whose ranges decide it becomes a constant, so its branch is
+//     left for --simplify-cfg to fold and its dead arm to remove
+//   - sdiv/srem whose divisor can be neither 0 nor -1 get the
+//     minic.nontrapping mark, which lets --licm and --if-convert run them
+//     speculatively. only the divisor's own range counts for the mark,
+//     never the narrowing at the division, since that narrowing is exactly
+//     what speculating it would throw away
+//
+// loads from promotable allocas are treated like phis over the stores that
+// reach them, so the pass works before and after --forward
+
+struct value_range {
+    bool empty;
+    long long lo, hi;
+};
+
+static value_range make_range(long long lo, long long hi) {
+    value_range r;
+    r.empty = lo > hi;
+    r.lo = lo;
+    r.hi = hi;
+    return r;
+}
+
+static value_range empty_range() {
+    return make_range(1, 0);
+}
+
+static long long min_of_width(unsigned width) {
+    return normalize_int(1ULL << (width - 1), width);
+}
+
+static long long max_of_width(unsigned width) {
+    return normalize_int((1ULL << (width - 1)) - 1, width);
+}
+
+static value_range full_range(unsigned width) {
+    return make_range(min_of_width(width), max_of_width(width));
+}
+
+// smallest interval holding both
+static value_range range_hull(value_range a, value_range b) {
+    if (a.empty) return b;
+    if (b.empty) return a;
+    return make_range(min(a.lo, b.lo), max(a.hi, b.hi));
+}
+
+// [lo, hi] computed without wrapping, or FULL if it doesn't fit the width
+static value_range checked_range(__int128 lo, __int128 hi, unsigned width) {
+    if (lo < min_of_width(width) || hi > max_of_width(width)) {
+        return full_range(width);
+    }
+    return make_range((long long)lo, (long long)hi);
+}
+
+static bool is_single(value_range r, long long c) {
+    return !r.empty && r.lo == c && r.hi == c;
+}
+
+static bool contains(value_range r, long long c) {
+    return !r.empty && r.lo <= c && c <= r.hi;
+}
+
+// solver state for one function
+struct range_state {
+    unordered_map<LLVMValueRef, value_range> ranges;
+    unordered_map<LLVMValueRef, int> growth;       // times a merge point grew
+    unordered_set<LLVMBasicBlockRef> executable_blocks;
+    set<pair<LLVMBasicBlockRef, LLVMBasicBlockRef>> executable_edges;
+
+    unordered_map<LLVMBasicBlockRef, vector<LLVMBasicBlockRef>> preds;
+    unordered_map<LLVMBasicBlockRef, unordered_set<LLVMBasicBlockRef>> dom;
+    unordered_map<LLVMValueRef, unordered_set<LLVMValueRef>> reaching;
+    unordered_set<LLVMBasicBlockRef> loop_blocks;
+    vector<long long> thresholds;                  // sorted widening stops
+
+    bool changed;
+};
+
+// the range recorded for a value, wherever it is used
+static value_range get_range(range_state &s, LLVMValueRef value) {
+    unsigned width = int_width(value);
+    if (LLVMIsAConstantInt(value)) {
+        long long c = LLVMConstIntGetSExtValue(value);
+        return make_range(c, c);
+    }
+    if (width == 0 || !LLVMIsAInstruction(value)) {
+        // undef, function arguments, globals, constant expressions
+        return full_range(width ? width : 64);
+    }
+    auto it = s.ranges.find(value);
+    if (it == s.ranges.end()) {
+        return empty_range();
+    }
+    return it->second;
+}
+
+// ----------------------------------------------------------------------------
+// narrowing by branch conditions
+// ----------------------------------------------------------------------------
+
+// a p b is b p' a
+static LLVMIntPredicate swap_predicate(LLVMIntPredicate p) {
+    switch (p) {
+        case LLVMIntSLT: return LLVMIntSGT;
+        case LLVMIntSGT: return LLVMIntSLT;
+        case LLVMIntSLE: return LLVMIntSGE;
+        case LLVMIntSGE: return LLVMIntSLE;
+        case LLVMIntULT: return LLVMIntUGT;
+        case LLVMIntUGT: return LLVMIntULT;
+        case LLVMIntULE: return LLVMIntUGE;
+        case LLVMIntUGE: return LLVMIntULE;
+        default:         return p;            // EQ, NE
+    }
+}
+
+// !(a p b) is a p' b
+static LLVMIntPredicate negate_predicate(LLVMIntPredicate p) {
+    switch (p) {
+        case LLVMIntEQ:  return LLVMIntNE;
+        case LLVMIntNE:  return LLVMIntEQ;
+        case LLVMIntSLT: return LLVMIntSGE;
+        case LLVMIntSGE: return LLVMIntSLT;
+        case LLVMIntSGT: return LLVMIntSLE;
+        case LLVMIntSLE: return LLVMIntSGT;
+        case LLVMIntULT: return LLVMIntUGE;
+        case LLVMIntUGE: return LLVMIntULT;
+        case LLVMIntUGT: return LLVMIntULE;
+        default:         return LLVMIntUGT;   // ULE
+    }
+}
+
+// narrow r, the range of value, by `cond is taken` (cond ends the block
+// the edge leaves)
+static value_range narrow_by_condition(range_state &s, value_range r, LLVMValueRef value,
+                                       LLVMValueRef cond, bool taken) {
+    if (r.empty || !LLVMIsAICmpInst(cond)) {
+        return r;
+    }
+
+    LLVMIntPredicate p = LLVMGetICmpPredicate(cond);
+    LLVMValueRef other;
+    if (LLVMGetOperand(cond, 0) == value) {
+        other = LLVMGetOperand(cond, 1);
+    } else if (LLVMGetOperand(cond, 1) == value) {
+        other = LLVMGetOperand(cond, 0);
+        p = swap_predicate(p);
+    } else {
+        return r;
+    }
+    if (!taken) {
+        p = negate_predicate(p);
+    }
+
+    value_range o = get_range(s, other);
+    if (o.empty) {
+        return r;
+    }
+
+    // value p other, for some other in [o.lo, o.hi]
+    long long lo = r.lo, hi = r.hi;
+    switch (p) {
+        case LLVMIntEQ:
+            lo = max(lo, o.lo);
+            hi = min(hi, o.hi);
+            break;
+        case LLVMIntNE:
+            if (o.lo == o.hi && lo == o.lo) lo++;
+            if (o.lo == o.hi && hi == o.hi) hi--;
+            break;
+        case LLVMIntSLT:
+            hi = min(hi, o.hi - 1);
+            break;
+        case LLVMIntSLE:
+            hi = min(hi, o.hi);
+            break;
+        case LLVMIntSGT:
+            lo = max(lo, o.lo + 1);
+            break;
+        case LLVMIntSGE:
+            lo = max(lo, o.lo);
+            break;
+        case LLVMIntULT: case LLVMIntULE:
+            // below a non-negative bound means non-negative too
+            if (o.lo >= 0) {
+                lo = max(lo, 0LL);
+                hi = min(hi, p == LLVMIntULT ? o.hi - 1 : o.hi);
+            }
+            break;
+        default:
+            break;
+    }
+    return make_range(lo, hi);
+}
+
+// narrow r by the branch that ends from, if the edge from -> to decides it
+static value_range narrow_by_edge(range_state &s, value_range r, LLVMValueRef value,
+                                  LLVMBasicBlockRef from, LLVMBasicBlockRef to) {
+    LLVMValueRef term = LLVMGetBasicBlockTerminator(from);
+    if (!LLVMIsABranchInst(term) || !LLVMIsConditional(term) ||
+        LLVMGetSuccessor(term, 0) == LLVMGetSuccessor(term, 1)) {
+        return r;
+    }
+    return narrow_by_condition(s, r, value, LLVMGetCondition(term),
+                               LLVMGetSuccessor(term, 0) == to);
+}
+
+// the range of value inside bb: every block D dominating bb that is only
+// entered from one predecessor P adds the condition of P -> D
+static value_range range_in_block(range_state &s, LLVMValueRef value, LLVMBasicBlockRef bb) {
+    value_range r = get_range(s, value);
+    if (r.empty || LLVMIsAConstantInt(value)) {
+        return r;
+    }
+    for (LLVMBasicBlockRef d : s.dom[bb]) {
+        if (s.preds[d].size() == 1) {
+            r = narrow_by_edge(s, r, value, s.preds[d][0], d);
+        }
+    }
+    return r;
+}
+
+// the range of value as it leaves from for to
+static value_range range_on_edge(range_state &s, LLVMValueRef value,
+                                 LLVMBasicBlockRef from, LLVMBasicBlockRef to) {
+    return narrow_by_edge(s, range_in_block(s, value, from), value, from, to);
+}
+
+// ----------------------------------------------------------------------------
+// transfer functions
+// ----------------------------------------------------------------------------
+
+// i1 results: true is -1, like every constant here
+static value_range compare_ranges(LLVMIntPredicate p, value_range a, value_range b) {
+    // unsigned compares of non-negative ranges are signed ones
+    if (a.lo >= 0 && b.lo >= 0) {
+        switch (p) {
+            case LLVMIntULT: p = LLVMIntSLT; break;
+            case LLVMIntULE: p = LLVMIntSLE; break;
+            case LLVMIntUGT: p = LLVMIntSGT; break;
+            case LLVMIntUGE: p = LLVMIntSGE; break;
+            default: break;
+        }
+    }
+
+    int result = -1;    // unknown
+    switch (p) {
+        case LLVMIntEQ:
+            if (a.lo == a.hi && b.lo == b.hi && a.lo == b.lo) result = 1;
+            else if (a.hi < b.lo || b.hi < a.lo) result = 0;
+            break;
+        case LLVMIntNE:
+            if (a.lo == a.hi && b.lo == b.hi && a.lo == b.lo) result = 0;
+            else if (a.hi < b.lo || b.hi < a.lo) result = 1;
+            break;
+        case LLVMIntSLT:
+            if (a.hi < b.lo) result = 1;
+            else if (a.lo >= b.hi) result = 0;
+            break;
+        case LLVMIntSLE:
+            if (a.hi <= b.lo) result = 1;
+            else if (a.lo > b.hi) result = 0;
+            break;
+        case LLVMIntSGT:
+            if (a.lo > b.hi) result = 1;
+            else if (a.hi <= b.lo) result = 0;
+            break;
+        case LLVMIntSGE:
+            if (a.lo >= b.hi) result = 1;
+            else if (a.hi < b.lo) result = 0;
+            break;
+        default:
+            break;
+    }
+
+    if (result == 1) return make_range(-1, -1);
+    if (result == 0) return make_range(0, 0);
+    return make_range(-1, 0);
+}
+
+// sdiv of two ranges, the divisor entirely on one side of 0
+static value_range divide_ranges(value_range a, value_range b, unsigned width) {
+    if (contains(b, 0)) {
+        return full_range(width);
+    }
+    // x / d is monotone in x and in d on each side of 0, so the corners
+    // hold the extremes
+    __int128 corners[4] = {
+        (__int128)a.lo / b.lo, (__int128)a.lo / b.hi,
+        (__int128)a.hi / b.lo, (__int128)a.hi / b.hi,
+    };
+    __int128 lo = corners[0], hi = corners[0];
+    for (int i = 1; i < 4; i++) {
+        lo = min(lo, corners[i]);
+        hi = max(hi, corners[i]);
+    }
+    return checked_range(lo, hi, width);
+}
+
+// srem: smaller than the divisor in magnitude, with the dividend's sign
+static value_range remainder_ranges(value_range a, value_range b, unsigned width) {
+    if (contains(b, 0)) {
+        return full_range(width);
+    }
+    __int128 bound = max(b.hi < 0 ? -(__int128)b.lo : (__int128)b.hi,
+                         b.lo < 0 ? -(__int128)b.lo : (__int128)b.lo) - 1;
+    __int128 lo = a.lo >= 0 ? 0 : max((__int128)a.lo, -bound);
+    __int128 hi = a.hi <= 0 ? 0 : min((__int128)a.hi, bound);
+    return checked_range(lo, hi, width);
+}
+
+// range of a non-phi, non-load integer instruction in bb
+static value_range evaluate_range(range_state &s, LLVMValueRef inst, LLVMBasicBlockRef bb) {
+    LLVMOpcode opcode = LLVMGetInstructionOpcode(inst);
+    unsigned width = int_width(inst);
+
+    switch (opcode) {
+        case LLVMAdd: case LLVMSub: case LLVMMul:
+        case LLVMSDiv: case LLVMSRem:
+        case LLVMShl: case LLVMAShr: case LLVMAnd: {
+            value_range a = range_in_block(s, LLVMGetOperand(inst, 0), bb);
+            value_range b = range_in_block(s, LLVMGetOperand(inst, 1), bb);
+            if (a.empty || b.empty) {
+                return empty_range();
+            }
+
+            switch (opcode) {
+                case LLVMAdd:
+                    return checked_range((__int128)a.lo + b.lo, (__int128)a.hi + b.hi, width);
+                case LLVMSub:
+                    return checked_range((__int128)a.lo - b.hi, (__int128)a.hi - b.lo, width);
+                case LLVMMul: {
+                    __int128 corners[4] = {
+                        (__int128)a.lo * b.lo, (__int128)a.lo * b.hi,
+                        (__int128)a.hi * b.lo, (__int128)a.hi * b.hi,
+                    };
+                    __int128 lo = corners[0], hi = corners[0];
+                    for (int i = 1; i < 4; i++) {
+                        lo = min(lo, corners[i]);
+                        hi = max(hi, corners[i]);
+                    }
+                    return checked_range(lo, hi, width);
+                }
+                case LLVMSDiv:
+                    return divide_ranges(a, b, width);
+                case LLVMSRem:
+                    return remainder_ranges(a, b, width);
+                case LLVMShl:
+                    // by a constant: a multiply by 2^k
+                    if (b.lo != b.hi || b.lo < 0 || b.lo >= (long long)width) {
+                        return full_range(width);
+                    }
+                    return checked_range((__int128)a.lo << b.lo, (__int128)a.hi << b.lo, width);
+                case LLVMAShr:
+                    if (b.lo != b.hi || b.lo < 0 || b.lo >= (long long)width) {
+                        return full_range(width);
+                    }
+                    return make_range(a.lo >> b.lo, a.hi >> b.lo);
+                default:
+                    // and with a non-negative value is at most that value
+                    if (a.lo >= 0 && b.lo >= 0) return make_range(0, min(a.hi, b.hi));
+                    if (a.lo >= 0) return make_range(0, a.hi);
+                    if (b.lo >= 0) return make_range(0, b.hi);
+                    return full_range(width);
+            }
+        }
+
+        case LLVMICmp: {
+            value_range a = range_in_block(s, LLVMGetOperand(inst, 0), bb);
+            value_range b = range_in_block(s, LLVMGetOperand(inst, 1), bb);
+            if (a.empty || b.empty) {
+                return empty_range();
+            }
+            return compare_ranges(LLVMGetICmpPredicate(inst), a, b);
+        }
+
+        case LLVMZExt: case LLVMSExt: case LLVMTrunc: {
+            LLVMValueRef op = LLVMGetOperand(inst, 0);
+            value_range in = range_in_block(s, op, bb);
+            if (in.empty) {
+                return empty_range();
+            }
+            if (opcode == LLVMZExt && in.lo < 0) {
+                // i1 true (-1) is 1, anything else negative is big
+                if (int_width(op) == 1) {
+                    return make_range(in.hi < 0 ? 1 : 0, 1);
+                }
+                return make_range(0, (long long)((1ULL << int_width(op)) - 1));
+            }
+            if (opcode == LLVMTrunc &&
+                (in.lo < min_of_width(width) || in.hi > max_of_width(width))) {
+                return full_range(width);
+            }
+            return in;
+        }
+
+        case LLVMSelect: {
+            value_range cond = range_in_block(s, LLVMGetOperand(inst, 0), bb);
+            value_range t = range_in_block(s, LLVMGetOperand(inst, 1), bb);
+            value_range f = range_in_block(s, LLVMGetOperand(inst, 2), bb);
+            if (cond.empty) return empty_range();
+            if (is_single(cond, -1)) return t;
+            if (is_single(cond, 0)) return f;
+            return range_hull(t, f);
+        }
+
+        default:
+            // calls (read), and anything we don't model
+            return full_range(width);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// solver
+// ----------------------------------------------------------------------------
+
+// move a bound that keeps growing to the next widening stop
+static value_range widen(range_state &s, value_range old, value_range grown, unsigned width) {
+    long long lo = grown.lo, hi = grown.hi;
+    if (grown.lo < old.lo) {
+        lo = min_of_width(width);
+        for (long long t : s.thresholds) {
+            if (t <= grown.lo && t >= min_of_width(width)) lo = t;
+        }
+    }
+    if (grown.hi > old.hi) {
+        hi = max_of_width(width);
+        for (auto it = s.thresholds.rbegin(); it != s.thresholds.rend(); ++it) {
+            if (*it >= grown.hi && *it <= max_of_width(width)) hi = *it;
+        }
+    }
+    return make_range(lo, hi);
+}
+
+// grow inst's range to include value
+static void update_range(range_state &s, LLVMValueRef inst, value_range value) {
+    value_range old = get_range(s, inst);
+    value_range grown = range_hull(old, value);
+    if (grown.empty || (!old.empty && grown.lo == old.lo && grown.hi == old.hi)) {
+        return;
+    }
+
+    bool merge = LLVMIsAPHINode(inst) || LLVMIsALoadInst(inst);
+    if (merge && !old.empty && s.loop_blocks.count(LLVMGetInstructionParent(inst)) &&
+        ++s.growth[inst] > 2) {
+        grown = widen(s, old, grown, int_width(inst));
+    }
+
+    s.ranges[inst] = grown;
+    s.changed = true;
+}
+
+static void mark_edge(range_state &s, LLVMBasicBlockRef from, LLVMBasicBlockRef to) {
+    if (s.executable_edges.insert(make_pair(from, to)).second) {
+        s.executable_blocks.insert(to);
+        s.changed = true;
+    }
+}
+
+// visit one instruction in an executable block
+static void visit_instruction(range_state &s, LLVMValueRef inst) {
+    LLVMBasicBlockRef bb = LLVMGetInstructionParent(inst);
+
+    // terminators decide which edges become executable
+    if (LLVMIsATerminatorInst(inst)) {
+        if (LLVMIsABranchInst(inst) && LLVMIsConditional(inst)) {
+            value_range cond = range_in_block(s, LLVMGetCondition(inst), bb);
+            if (cond.empty) {
+                return;
+            }
+            // successor 0 is the true target, successor 1 the false target
+            if (contains(cond, -1)) mark_edge(s, bb, LLVMGetSuccessor(inst, 0));
+            if (contains(cond, 0)) mark_edge(s, bb, LLVMGetSuccessor(inst, 1));
+            return;
+        }
+
+        unsigned num_succs = LLVMGetNumSuccessors(inst);
+        for (unsigned i = 0; i < num_succs; i++) {
+            mark_edge(s, bb, LLVMGetSuccessor(inst, i));
+        }
+        return;
+    }
+
+    if (int_width(inst) == 0) {
+        return;
+    }
+
+    // phi: everything arriving along executable edges, narrowed by them
+    if (LLVMIsAPHINode(inst)) {
+        value_range result = empty_range();
+        unsigned count = LLVMCountIncoming(inst);
+        for (unsigned i = 0; i < count; i++) {
+            LLVMBasicBlockRef from = LLVMGetIncomingBlock(inst, i);
+            if (s.executable_edges.count(make_pair(from, bb))) {
+                result = range_hull(result,
+                                    range_on_edge(s, LLVMGetIncomingValue(inst, i), from, bb));
+            }
+        }
+        update_range(s, inst, result);
+        return;
+    }
+
+    // load: every value stored by a reaching store in an executable block
+    if (LLVMIsALoadInst(inst)) {
+        auto it = s.reaching.find(inst);
+        if (it == s.reaching.end() || it->second.empty()) {
+            update_range(s, inst, full_range(int_width(inst)));
+            return;
+        }
+        value_range result = empty_range();
+        for (LLVMValueRef store : it->second) {
+            LLVMBasicBlockRef from = LLVMGetInstructionParent(store);
+            if (s.executable_blocks.count(from)) {
+                result = range_hull(result, range_in_block(s, LLVMGetOperand(store, 0), from));
+            }
+        }
+        update_range(s, inst, result);
+        return;
+    }
+
+    update_range(s, inst, evaluate_range(s, inst, bb));
+}
+
+// a branch still on EMPTY depends only on values no executable path
+// defines; let it go either way so no live code is missed
+static bool resolve_empty_branches(range_state &s, LLVMValueRef function) {
+    bool resolved = false;
+
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+
+        if (!s.executable_blocks.count(bb)) {
+            continue;
+        }
+        LLVMValueRef term = LLVMGetBasicBlockTerminator(bb);
+        if (term == NULL || !LLVMIsABranchInst(term) || !LLVMIsConditional(term)) {
+            continue;
+        }
+        if (range_in_block(s, LLVMGetCondition(term), bb).empty) {
+            size_t before = s.executable_edges.size();
+            mark_edge(s, bb, LLVMGetSuccessor(term, 0));
+            mark_edge(s, bb, LLVMGetSuccessor(term, 1));
+            if (s.executable_edges.size() != before) {
+                resolved = true;
+            }
+        }
+    }
+
+    return resolved;
+}
+
+// sweep the executable blocks until no range or edge changes
+static void solve(range_state &s, LLVMValueRef function) {
+    do {
+        s.changed = false;
+        for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+             bb != NULL;
+             bb = LLVMGetNextBasicBlock(bb)) {
+
+            if (!s.executable_blocks.count(bb)) {
+                continue;
+            }
+            for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+                 inst != NULL;
+                 inst = LLVMGetNextInstruction(inst)) {
+                visit_instruction(s, inst);
+            }
+        }
+    } while (s.changed);
+}
+
+// every constant the function compares against, and its neighbours,
+// as places for widening to stop
+static void collect_thresholds(range_state &s, LLVMValueRef function) {
+    set<long long> stops;
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+             inst != NULL;
+             inst = LLVMGetNextInstruction(inst)) {
+            if (!LLVMIsAICmpInst(inst)) {
+                continue;
+            }
+            for (int i = 0; i < 2; i++) {
+                LLVMValueRef op = LLVMGetOperand(inst, i);
+                if (LLVMIsAConstantInt(op)) {
+                    long long c = LLVMConstIntGetSExtValue(op);
+                    stops.insert(c);
+                    if (c > min_of_width(64)) stops.insert(c - 1);
+                    if (c < max_of_width(64)) stops.insert(c + 1);
+                }
+            }
+        }
+    }
+    s.thresholds.assign(stops.begin(), stops.end());
+}
+
+// the ranges of every value in function, from its entry block
+static void compute_ranges(range_state &s, LLVMValueRef function) {
+    // step 1: the cfg facts narrowing and widening need
+    compute_predecessors(function, s.preds);
+    compute_dominators(function, s.dom);
+    compute_reaching_stores(function, s.reaching);
+    collect_thresholds(s, function);
+
+    vector<loop_info *> loops;
+    find_loops(function, loops);
+    for (loop_info *loop : loops) {
+        s.loop_blocks.insert(loop->blocks.begin(), loop->blocks.end());
+    }
+    free_loops(loops);
+
+    // step 2: grow the ranges from the entry block
+    s.executable_blocks.insert(LLVMGetFirstBasicBlock(function));
+    do {
+        solve(s, function);
+    } while (resolve_empty_branches(s, function));
+}
+
+// an sdiv/srem in a reachable block whose divisor can be neither 0 nor -1
+static bool divisor_is_safe(range_state &s, LLVMValueRef inst) {
+    if (!s.executable_blocks.count(LLVMGetInstructionParent(inst))) {
+        return false;
+    }
+    value_range d = get_range(s, LLVMGetOperand(inst, 1));
+    return !d.empty && !contains(d, 0) && !contains(d, -1);
+}
+
+// fold decided compares, mark divisions that can't trap
+static bool apply_ranges(range_state &s, LLVMValueRef function) {
+    bool changed = false;
+
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+
+        bool executable = s.executable_blocks.count(bb) != 0;
+
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+             inst != NULL;
+             inst = LLVMGetNextInstruction(inst)) {
+
+            LLVMOpcode opcode = LLVMGetInstructionOpcode(inst);
+
+            if (opcode == LLVMICmp && executable && LLVMGetFirstUse(inst) != NULL) {
+                value_range r = get_range(s, inst);
+                if (!r.empty && r.lo == r.hi) {
+                    LLVMReplaceAllUsesWith(inst, LLVMConstInt(LLVMTypeOf(inst),
+                                                              (unsigned long long)r.lo, 1));
+                    changed = true;
+                }
+                continue;
+            }
+
+            // the mark is redone on every run, so it never outlives the
+            // ranges it came from
+            if (opcode == LLVMSDiv || opcode == LLVMSRem) {
+                changed |= set_non_trapping_mark(inst, divisor_is_safe(s, inst));
+            }
+        }
+    }
+
+    return changed;
+}
+
+// ============================================================================
+// MAIN PASS: value_range_analysis
+// ============================================================================
+bool value_range_analysis(LLVMModuleRef module) {
+    bool changed = false;
+
+    // iterate through all functions
+    for (LLVMValueRef function = LLVMGetFirstFunction(module);
+         function != NULL;
+         function = LLVMGetNextFunction(function)) {
+
+        LLVMBasicBlockRef entry = LLVMGetFirstBasicBlock(function);
+        if (entry == NULL) {
+            continue; // declaration (print, read)
+        }
+
+        range_state s;
+        compute_ranges(s, function);
+        changed |= apply_ranges(s, function);
+    }
+
+    return changed;
+}
+
+// the marks are only as good as the divisor they were computed for, and
+// --instcombine (x + 0 -> x), --forward and block merging can swap it for
+// a value with a wider range before --ranges runs again
+void recheck_non_trapping_marks(LLVMValueRef function) {
+    vector<LLVMValueRef> marked;
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+             inst != NULL;
+             inst = LLVMGetNextInstruction(inst)) {
+            if ((LLVMGetInstructionOpcode(inst) == LLVMSDiv ||
+                 LLVMGetInstructionOpcode(inst) == LLVMSRem) && has_non_trapping_mark(inst)) {
+                marked.push_back(inst);
+            }
+        }
+    }
+    if (marked.empty()) {
+        return;
+    }
+
+    range_state s;
+    compute_ranges(s, function);
+    for (LLVMValueRef inst : marked) {
+        if (!divisor_is_safe(s, inst)) {
+            set_non_trapping_mark(inst, false);
+        }
+    }
+}
@@ -0,0 +1,442 @@
+#include "optimizer.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <deque>
+#include <set>
+#include <utility>
+
+using namespace std;
+
+// ============================================================================
+// SPARSE CONDITIONAL CONSTANT PROPAGATION
+// ============================================================================
+// Wegman-Zadeck SCCP: every integer value sits on a three level lattice
+//
+//     TOP (no information yet)  ->  CONSTANT c  ->  BOTTOM (overdefined)
+//
+// values only ever move down. two worklists drive the solver:
+//   - CFG worklist: edges that just became executable
+//   - SSA worklist: instructions whose operands just changed
+// a block is only looked at once some edge into it is executable, and a
+// conditional branch only marks the edge its (constant) condition selects,
+// so constants and unreachable code are discovered together
+//
+// the frontend keeps every variable in an alloca, so loads from promotable
+// allocas are treated like phis over the stores that reach them (only stores
+// in executable blocks count)
+
+enum lattice_state {
+    LATTICE_TOP,
+    LATTICE_CONSTANT,
+    LATTICE_BOTTOM
+};
+
+struct lattice_value {
+    lattice_state state;
+    long long constant;
+};
+
+static lattice_value make_lattice(lattice_state state, long long constant = 0) {
+    lattice_value v;
+    v.state = state;
+    v.constant = constant;
+    return v;
+}
+
+// meet operator: TOP ^ x = x, BOTTOM ^ x = BOTTOM, c ^ c = c, c1 ^ c2 = BOTTOM
+static lattice_value lattice_meet(lattice_value a, lattice_value b) {
+    if (a.state == LATTICE_TOP) return b;
+    if (b.state == LATTICE_TOP) return a;
+    if (a.state == LATTICE_BOTTOM || b.state == LATTICE_BOTTOM) {
+        return make_lattice(LATTICE_BOTTOM);
+    }
+    if (a.constant == b.constant) return a;
+    return make_lattice(LATTICE_BOTTOM);
+}
+
+// solver state for one function
+struct sccp_state {
+    unordered_map<LLVMValueRef, lattice_value> values;
+    unordered_set<LLVMBasicBlockRef> executable_blocks;
+    set<pair<LLVMBasicBlockRef, LLVMBasicBlockRef>> executable_edges;
+
+    deque<pair<LLVMBasicBlockRef, LLVMBasicBlockRef>> cfg_worklist;
+    deque<LLVMValueRef> ssa_worklist;
+
+    // load -> stores that may reach it, and the reverse map
+    unordered_map<LLVMValueRef, unordered_set<LLVMValueRef>> reaching;
+    unordered_map<LLVMValueRef, vector<LLVMValueRef>> reached_loads;
+};
+
+// current lattice value of any operand
+static lattice_value get_lattice(sccp_state &s, LLVMValueRef value) {
+    unsigned width = int_width(value);
+    if (width == 0 || LLVMIsUndef(value)) {
+        return make_lattice(LATTICE_BOTTOM);
+    }
+    if (LLVMIsAConstantInt(value)) {
+        return make_lattice(LATTICE_CONSTANT, LLVMConstIntGetSExtValue(value));
+    }
+    if (LLVMIsAInstruction(value)) {
+        auto it = s.values.find(value);
+        if (it == s.values.end()) {
+            return make_lattice(LATTICE_TOP);
+        }
+        return it->second;
+    }
+    // function arguments, globals, constant expressions
+    return make_lattice(LATTICE_BOTTOM);
+}
+
+// queue every instruction that consumes value
+static void push_users(sccp_state &s, LLVMValueRef value) {
+    for (LLVMUseRef use = LLVMGetFirstUse(value);
+         use != NULL;
+         use = LLVMGetNextUse(use)) {
+        s.ssa_worklist.push_back(LLVMGetUser(use));
+    }
+}
+
+// lower inst to (old ^ value), queueing users if it moved
+static void update_value(sccp_state &s, LLVMValueRef inst, lattice_value value) {
+    lattice_value old = get_lattice(s, inst);
+    lattice_value lowered = lattice_meet(old, value);
+
+    if (lowered.state == old.state && lowered.constant == old.constant) {
+        return;
+    }
+
+    s.values[inst] = lowered;
+    push_users(s, inst);
+}
+
+static void mark_edge(sccp_state &s, LLVMBasicBlockRef from, LLVMBasicBlockRef to) {
+    pair<LLVMBasicBlockRef, LLVMBasicBlockRef> edge(from, to);
+    if (s.executable_edges.insert(edge).second) {
+        s.cfg_worklist.push_back(edge);
+    }
+}
+
+// lattice value computed for a non-phi, non-load integer instruction
+static lattice_value evaluate_instruction(sccp_state &s, LLVMValueRef inst) {
+    LLVMOpcode opcode = LLVMGetInstructionOpcode(inst);
+    unsigned width = int_width(inst);
+
+    switch (opcode) {
+        case LLVMAdd: case LLVMSub: case LLVMMul:
+        case LLVMSDiv: case LLVMUDiv: case LLVMSRem: case LLVMURem:
+        case LLVMShl: case LLVMLShr: case LLVMAShr:
+        case LLVMAnd: case LLVMOr: case LLVMXor: {
+            lattice_value lhs = get_lattice(s, LLVMGetOperand(inst, 0));
+            lattice_value rhs = get_lattice(s, LLVMGetOperand(inst, 1));
+            if (lhs.state == LATTICE_BOTTOM || rhs.state == LATTICE_BOTTOM) {
+                return make_lattice(LATTICE_BOTTOM);
+            }
+            if (lhs.state == LATTICE_TOP || rhs.state == LATTICE_TOP) {
+                return make_lattice(LATTICE_TOP);
+            }
+            long long result;
+            if (!evaluate_int_binary(opcode, lhs.constant, rhs.constant, width, &result)) {
+                return make_lattice(LATTICE_BOTTOM);
+            }
+            return make_lattice(LATTICE_CONSTANT, result);
+        }
+
+        case LLVMICmp: {
+            LLVMValueRef op1 = LLVMGetOperand(inst, 0);
+            lattice_value lhs = get_lattice(s, op1);
+            lattice_value rhs = get_lattice(s, LLVMGetOperand(inst, 1));
+            if (lhs.state == LATTICE_BOTTOM || rhs.state == LATTICE_BOTTOM) {
+                return make_lattice(LATTICE_BOTTOM);
+            }
+            if (lhs.state == LATTICE_TOP || rhs.state == LATTICE_TOP) {
+                return make_lattice(LATTICE_TOP);
+            }
+            bool result = evaluate_int_compare(LLVMGetICmpPredicate(inst),
+                                               lhs.constant, rhs.constant, int_width(op1));
+            return make_lattice(LATTICE_CONSTANT, result ? -1 : 0);
+        }
+
+        case LLVMZExt: case LLVMSExt: case LLVMTrunc: {
+            LLVMValueRef op = LLVMGetOperand(inst, 0);
+            lattice_value in = get_lattice(s, op);
+            if (in.state != LATTICE_CONSTANT) {
+                return in;
+            }
+            long long value = in.constant;
+            if (opcode == LLVMZExt) {
+                unsigned from = int_width(op);
+                if (from < 64) {
+                    value = (long long)((unsigned long long)value & ((1ULL << from) - 1));
+                }
+            }
+            return make_lattice(LATTICE_CONSTANT, normalize_int(value, width));
+        }
+
+        case LLVMSelect: {
+            lattice_value cond = get_lattice(s, LLVMGetOperand(inst, 0));
+            lattice_value t = get_lattice(s, LLVMGetOperand(inst, 1));
+            lattice_value f = get_lattice(s, LLVMGetOperand(inst, 2));
+            if (cond.state == LATTICE_CONSTANT) {
+                return cond.constant != 0 ? t : f;
+            }
+            if (cond.state == LATTICE_TOP) {
+                return make_lattice(LATTICE_TOP);
+            }
+            return lattice_meet(t, f);
+        }
+
+        default:
+            // calls (read), and anything we don't model
+            return make_lattice(LATTICE_BOTTOM);
+    }
+}
+
+// visit one instruction in an executable block
+static void visit_instruction(sccp_state &s, LLVMValueRef inst) {
+    LLVMBasicBlockRef bb = LLVMGetInstructionParent(inst);
+
+    // terminators decide which edges become executable
+    if (LLVMIsATerminatorInst(inst)) {
+        unsigned num_succs = LLVMGetNumSuccessors(inst);
+
+        if (LLVMIsABranchInst(inst) && LLVMIsConditional(inst)) {
+            lattice_value cond = get_lattice(s, LLVMGetCondition(inst));
+            if (cond.state == LATTICE_CONSTANT) {
+                // successor 0 is the true target, successor 1 the false target
+                mark_edge(s, bb, LLVMGetSuccessor(inst, cond.constant != 0 ? 0 : 1));
+            } else if (cond.state == LATTICE_BOTTOM) {
+                mark_edge(s, bb, LLVMGetSuccessor(inst, 0));
+                mark_edge(s, bb, LLVMGetSuccessor(inst, 1));
+            }
+            return;
+        }
+
+        for (unsigned i = 0; i < num_succs; i++) {
+            mark_edge(s, bb, LLVMGetSuccessor(inst, i));
+        }
+        return;
+    }
+
+    // a store changes what the loads it reaches can see
+    if (LLVMIsAStoreInst(inst)) {
+        auto it = s.reached_loads.find(inst);
+        if (it != s.reached_loads.end()) {
+            for (LLVMValueRef load : it->second) {
+                s.ssa_worklist.push_back(load);
+            }
+        }
+        return;
+    }
+
+    if (int_width(inst) == 0) {
+        return;
+    }
+
+    // phi: meet of the incoming values along executable edges
+    if (LLVMIsAPHINode(inst)) {
+        lattice_value result = make_lattice(LATTICE_TOP);
+        unsigned count = LLVMCountIncoming(inst);
+        for (unsigned i = 0; i < count; i++) {
+            pair<LLVMBasicBlockRef, LLVMBasicBlockRef> edge(LLVMGetIncomingBlock(inst, i), bb);
+            if (s.executable_edges.count(edge)) {
+                result = lattice_meet(result, get_lattice(s, LLVMGetIncomingValue(inst, i)));
+            }
+        }
+        update_value(s, inst, result);
+        return;
+    }
+
+    // load: meet of the values written by reaching stores in executable blocks
+    if (LLVMIsALoadInst(inst)) {
+        auto it = s.reaching.find(inst);
+        if (it == s.reaching.end()) {
+            update_value(s, inst, make_lattice(LATTICE_BOTTOM));
+            return;
+        }
+        lattice_value result = make_lattice(LATTICE_TOP);
+        for (LLVMValueRef store : it->second) {
+            if (s.executable_blocks.count(LLVMGetInstructionParent(store))) {
+                result = lattice_meet(result, get_lattice(s, LLVMGetOperand(store, 0)));
+            }
+        }
+        update_value(s, inst, result);
+        return;
+    }
+
+    update_value(s, inst, evaluate_instruction(s, inst));
+}
+
+// run both worklists dry
+static void solve(sccp_state &s) {
+    while (!s.cfg_worklist.empty() || !s.ssa_worklist.empty()) {
+
+        while (!s.cfg_worklist.empty()) {
+            pair<LLVMBasicBlockRef, LLVMBasicBlockRef> edge = s.cfg_worklist.front();
+            s.cfg_worklist.pop_front();
+            LLVMBasicBlockRef bb = edge.second;
+
+            if (s.executable_blocks.insert(bb).second) {
+                // first time reachable: visit everything in it
+                for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+                     inst != NULL;
+                     inst = LLVMGetNextInstruction(inst)) {
+                    visit_instruction(s, inst);
+                }
+            } else {
+                // already reachable: only the phis can see the new edge
+                for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+                     inst != NULL && LLVMIsAPHINode(inst);
+                     inst = LLVMGetNextInstruction(inst)) {
+                    visit_instruction(s, inst);
+                }
+            }
+        }
+
+        while (!s.ssa_worklist.empty()) {
+            LLVMValueRef inst = s.ssa_worklist.front();
+            s.ssa_worklist.pop_front();
+
+            if (!LLVMIsAInstruction(inst)) {
+                continue;
+            }
+            if (s.executable_blocks.count(LLVMGetInstructionParent(inst))) {
+                visit_instruction(s, inst);
+            }
+        }
+    }
+}
+
+// a branch still on TOP after solving depends only on undefined values;
+// treat it as able to go either way so no live code is dropped
+static bool resolve_undefined_branches(sccp_state &s, LLVMValueRef function) {
+    bool resolved = false;
+
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+
+        if (!s.executable_blocks.count(bb)) {
+            continue;
+        }
+        LLVMValueRef term = LLVMGetBasicBlockTerminator(bb);
+        if (term == NULL || !LLVMIsABranchInst(term) || !LLVMIsConditional(term)) {
+            continue;
+        }
+        if (get_lattice(s, LLVMGetCondition(term)).state == LATTICE_TOP) {
+            size_t before = s.executable_edges.size();
+            mark_edge(s, bb, LLVMGetSuccessor(term, 0));
+            mark_edge(s, bb, LLVMGetSuccessor(term, 1));
+            if (s.executable_edges.size() != before) {
+                resolved = true;
+            }
+        }
+    }
+
+    return resolved;
+}
+
+// rewrite the function using the solved lattice
+static bool apply_results(sccp_state &s, LLVMValueRef function) {
+    bool changed = false;
+
+    // step 1: replace values proven constant
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+
+        if (!s.executable_blocks.count(bb)) {
+            continue;
+        }
+
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+             inst != NULL;
+             inst = LLVMGetNextInstruction(inst)) {
+
+            if (int_width(inst) == 0 || LLVMGetFirstUse(inst) == NULL) {
+                continue;
+            }
+            lattice_value value = get_lattice(s, inst);
+            if (value.state != LATTICE_CONSTANT) {
+                continue;
+            }
+
+            LLVMValueRef constant = LLVMConstInt(LLVMTypeOf(inst),
+                                                 (unsigned long long)value.constant, 1);
+            LLVMReplaceAllUsesWith(inst, constant);
+            changed = true;
+        }
+    }
+
+    // step 2: branches on constant conditions become unconditional
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+
+        if (!s.executable_blocks.count(bb)) {
+            continue;
+        }
+        LLVMValueRef term = LLVMGetBasicBlockTerminator(bb);
+        if (term == NULL || !LLVMIsABranchInst(term) || !LLVMIsConditional(term)) {
+            continue;
+        }
+        lattice_value cond = get_lattice(s, LLVMGetCondition(term));
+        if (cond.state != LATTICE_CONSTANT) {
+            continue;
+        }
+
+        make_branch_unconditional(term, LLVMGetSuccessor(term, cond.constant != 0 ? 0 : 1));
+        changed = true;
+    }
+
+    // step 3: blocks no executable edge reaches are deleted
+    if (delete_dead_blocks(function, s.executable_blocks)) {
+        changed = true;
+    }
+
+    return changed;
+}
+
+bool sparse_conditional_constant_propagation(LLVMModuleRef module) {
+    bool changed = false;
+
+    // iterate through all functions
+    for (LLVMValueRef function = LLVMGetFirstFunction(module);
+         function != NULL;
+         function = LLVMGetNextFunction(function)) {
+
+        LLVMBasicBlockRef entry = LLVMGetFirstBasicBlock(function);
+        if (entry == NULL) {
+            continue; // declaration (print, read)
+        }
+
+        sccp_state s;
+
+        // step 1: which stores can each load observe
+        compute_reaching_stores(function, s.reaching);
+        for (auto &pair : s.reaching) {
+            for (LLVMValueRef store : pair.second) {
+                s.reached_loads[store].push_back(pair.first);
+            }
+        }
+
+        // step 2: the entry block is always executable
+        s.executable_blocks.insert(entry);
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(entry);
+             inst != NULL;
+             inst = LLVMGetNextInstruction(inst)) {
+            visit_instruction(s, inst);
+        }
+
+        // step 3: propagate until both worklists are empty
+        do {
+            solve(s);
+        } while (resolve_undefined_branches(s, function));
+
+        // step 4: fold constants, fold branches, drop unreachable blocks
+        changed |= apply_results(s, function);
+    }
+
+    return changed;
+}
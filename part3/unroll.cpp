@@ -0,0 +1,453 @@
+#include "optimizer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std;
+
+// ============================================================================
+// LOOP UNROLLING
+// ============================================================================
+// handles innermost miniC `while` loops: the header only loads and compares
+// (`i < n`), the body is every other block of the loop and comes back to
+// the header through a single latch.
+//
+//   - full unroll: if the counter starts at a constant and is compared with
+//     a constant, the trip count T is found by running the compare. the
+//     preheader then goes through T copies of the body in a row and lands
+//     on the header, whose test is known to fail, so it jumps to the exit.
+//     constant propagation usually folds what is left into constants
+//
+//   - partial unroll: otherwise, a new header runs `factor` copies of the
+//     body back to back as long as the last of them would still pass the
+//     test (checked in 64 bits so it can't overflow). the original loop
+//     stays behind as the remainder loop for the last few iterations
+//
+// both are limited by the size model in unroll_cost. the loops a partial
+// unroll produces are tagged with !minic.unrolled so they are left alone
+// on the next round of the driver's fixed-point loop
+
+unroll_options unroll_cost = {
+    16,     // full_max_trips
+    256,    // full_max_size
+    4,      // partial_factor
+    128,    // partial_max_size
+};
+
+static const char *UNROLLED_KIND = "minic.unrolled";
+
+static unsigned unrolled_kind_id() {
+    return LLVMGetMDKindID(UNROLLED_KIND, (unsigned)strlen(UNROLLED_KIND));
+}
+
+// a loop in the shape this pass handles
+struct unroll_candidate {
+    loop_info *loop;
+    LLVMBasicBlockRef preheader;
+    LLVMBasicBlockRef body_entry;               // header's in-loop successor
+    LLVMBasicBlockRef exit;                     // header's other successor
+    vector<LLVMBasicBlockRef> body;             // loop blocks but the header, in order
+    LLVMValueRef compare;                       // icmp pred (load i), bound
+    const induction_variable *counter;
+    int body_size;                              // instructions in the body
+};
+
+// the bound the counter is compared against can't change while the loop
+// runs: a constant, an argument, or a load of memory that no store or call
+// in the loop may write. a partially unrolled header tests it once for
+// several bodies
+static bool invariant_bound(const unroll_candidate &c) {
+    LLVMValueRef bound = LLVMGetOperand(c.compare, 1);
+    if (LLVMIsAConstantInt(bound) || LLVMIsAArgument(bound)) {
+        return true;
+    }
+    if (!LLVMIsALoadInst(bound)) {
+        return false;
+    }
+    LLVMValueRef addr = get_load_address(bound);
+    for (LLVMBasicBlockRef bb : c.loop->blocks) {
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+             inst != NULL;
+             inst = LLVMGetNextInstruction(inst)) {
+            if ((LLVMIsAStoreInst(inst) || LLVMIsACallInst(inst)) &&
+                (get_mod_ref(inst, addr) & MR_MOD)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// check the loop shape and fill in c (false if it doesn't fit)
+static bool analyze_loop(loop_info *loop, const vector<induction_variable> &ivs,
+                         unroll_candidate *c) {
+    LLVMBasicBlockRef header = loop->header;
+    LLVMValueRef function = LLVMGetBasicBlockParent(header);
+
+    if (!loop->children.empty() || loop->latches.size() != 1 ||
+        loop->latches[0] == header) {
+        return false;
+    }
+
+    // the header: br (icmp pred (load i), bound), body, exit and not yet unrolled
+    LLVMValueRef term = LLVMGetBasicBlockTerminator(header);
+    if (!LLVMIsABranchInst(term) || !LLVMIsConditional(term) ||
+        LLVMGetMetadata(term, unrolled_kind_id()) != NULL) {
+        return false;
+    }
+    c->loop = loop;
+    c->body_entry = LLVMGetSuccessor(term, 0);
+    c->exit = LLVMGetSuccessor(term, 1);
+    if (!loop->blocks.count(c->body_entry) || loop->blocks.count(c->exit)) {
+        return false;
+    }
+
+    c->compare = LLVMGetCondition(term);
+    if (!LLVMIsAICmpInst(c->compare) || LLVMGetInstructionParent(c->compare) != header) {
+        return false;
+    }
+    LLVMValueRef lhs = LLVMGetOperand(c->compare, 0);
+    c->counter = NULL;
+    for (const induction_variable &iv : ivs) {
+        if (LLVMIsALoadInst(lhs) && get_load_address(lhs) == iv.slot &&
+            LLVMGetInstructionParent(lhs) == header) {
+            c->counter = &iv;
+        }
+    }
+    if (c->counter == NULL || int_width(lhs) == 0) {
+        return false;
+    }
+
+    // the header only computes the test, so skipping it between copies is safe
+    for (LLVMValueRef inst = LLVMGetFirstInstruction(header);
+         inst != NULL;
+         inst = LLVMGetNextInstruction(inst)) {
+        LLVMOpcode opcode = LLVMGetInstructionOpcode(inst);
+        if (opcode != LLVMLoad && opcode != LLVMICmp && opcode != LLVMBr &&
+            !(LLVMIsABinaryOperator(inst) && opcode != LLVMSDiv && opcode != LLVMSRem &&
+              opcode != LLVMUDiv && opcode != LLVMURem)) {
+            return false;
+        }
+        for (LLVMUseRef use = LLVMGetFirstUse(inst); use != NULL; use = LLVMGetNextUse(use)) {
+            if (LLVMGetInstructionParent(LLVMGetUser(use)) != header) {
+                return false;
+            }
+        }
+    }
+
+    // the body: no phis (they can't be cloned with the C API), no other
+    // way out of the loop, no values used after it
+    c->body.clear();
+    c->body_size = 0;
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function);
+         bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+
+        if (bb == header || !loop->blocks.count(bb)) {
+            continue;
+        }
+        c->body.push_back(bb);
+
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+             inst != NULL;
+             inst = LLVMGetNextInstruction(inst)) {
+            if (LLVMIsAPHINode(inst)) {
+                return false;
+            }
+            for (LLVMUseRef use = LLVMGetFirstUse(inst); use != NULL; use = LLVMGetNextUse(use)) {
+                LLVMValueRef user = LLVMGetUser(use);
+                if (!loop->blocks.count(LLVMGetInstructionParent(user))) {
+                    return false;
+                }
+            }
+            c->body_size++;
+        }
+
+        LLVMValueRef bb_term = LLVMGetBasicBlockTerminator(bb);
+        unsigned num_succs = LLVMGetNumSuccessors(bb_term);
+        for (unsigned i = 0; i < num_succs; i++) {
+            if (!loop->blocks.count(LLVMGetSuccessor(bb_term, i))) {
+                return false;
+            }
+        }
+    }
+
+    // the header gets new predecessors, its phis would need new entries
+    LLVMValueRef first = LLVMGetFirstInstruction(header);
+    return !LLVMIsAPHINode(first) && invariant_bound(*c);
+}
+
+// ============================================================================
+// HELPER FUNCTION: clone_body
+// ============================================================================
+// copies the body blocks in front of the header. inside the copy, operands
+// and branch targets point at the copied values and blocks, and the latch
+// still branches to the header. returns the copy of the body's entry block
+// and sets *latch to the copy of the latch
+static LLVMBasicBlockRef clone_body(unroll_candidate &c, LLVMBasicBlockRef *latch) {
+    LLVMValueRef function = LLVMGetBasicBlockParent(c.loop->header);
+    LLVMContextRef context = LLVMGetModuleContext(LLVMGetGlobalParent(function));
+
+    unordered_map<LLVMBasicBlockRef, LLVMBasicBlockRef> block_map;
+    unordered_map<LLVMValueRef, LLVMValueRef> value_map;
+    vector<LLVMValueRef> clones;
+
+    for (LLVMBasicBlockRef bb : c.body) {
+        block_map[bb] = LLVMInsertBasicBlockInContext(context, c.loop->header, "");
+    }
+
+    LLVMBuilderRef builder = LLVMCreateBuilder();
+    for (LLVMBasicBlockRef bb : c.body) {
+        LLVMPositionBuilderAtEnd(builder, block_map[bb]);
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(bb);
+             inst != NULL;
+             inst = LLVMGetNextInstruction(inst)) {
+            LLVMValueRef clone = LLVMInstructionClone(inst);
+            set_non_trapping_mark(clone, false);    // until --ranges sees the copy
+            LLVMInsertIntoBuilder(builder, clone);
+            value_map[inst] = clone;
+            clones.push_back(clone);
+        }
+    }
+    LLVMDisposeBuilder(builder);
+
+    for (LLVMValueRef clone : clones) {
+        if (LLVMIsABranchInst(clone)) {
+            unsigned num_succs = LLVMGetNumSuccessors(clone);
+            for (unsigned i = 0; i < num_succs; i++) {
+                LLVMBasicBlockRef succ = LLVMGetSuccessor(clone, i);
+                if (succ != c.loop->header) {
+                    LLVMSetSuccessor(clone, i, block_map[succ]);
+                }
+            }
+            if (LLVMIsConditional(clone)) {
+                LLVMValueRef cond = LLVMGetCondition(clone);
+                if (value_map.count(cond)) {
+                    LLVMSetCondition(clone, value_map[cond]);
+                }
+            }
+            continue;
+        }
+
+        int num_ops = LLVMGetNumOperands(clone);
+        for (int i = 0; i < num_ops; i++) {
+            auto it = value_map.find(LLVMGetOperand(clone, i));
+            if (it != value_map.end()) {
+                LLVMSetOperand(clone, i, it->second);
+            }
+        }
+    }
+
+    *latch = block_map[c.loop->latches[0]];
+    return block_map[c.body_entry];
+}
+
+// `count` copies of the body one after the other in front of the header:
+// each copy's latch falls into the next copy and the last one branches to
+// last_target. the copied latch branches are no longer back edges, so they
+// lose their !llvm.loop, except the last one if last_loops_back.
+// returns the entry of the first copy
+static LLVMBasicBlockRef clone_body_chain(unroll_candidate &c, long long count,
+                                          LLVMBasicBlockRef last_target, bool last_loops_back) {
+    unsigned loop_kind = LLVMGetMDKindID("llvm.loop", 9);
+    LLVMBasicBlockRef first = NULL;
+    LLVMBasicBlockRef prev_latch = NULL;
+
+    for (long long k = 0; k < count; k++) {
+        LLVMBasicBlockRef latch;
+        LLVMBasicBlockRef entry = clone_body(c, &latch);
+        if (prev_latch != NULL) {
+            retarget_branch(prev_latch, c.loop->header, entry);
+            LLVMSetMetadata(LLVMGetBasicBlockTerminator(prev_latch), loop_kind, NULL);
+        } else {
+            first = entry;
+        }
+        prev_latch = latch;
+    }
+
+    if (prev_latch != NULL) {
+        retarget_branch(prev_latch, c.loop->header, last_target);
+        if (!last_loops_back) {
+            LLVMSetMetadata(LLVMGetBasicBlockTerminator(prev_latch), loop_kind, NULL);
+        }
+    }
+    return first;
+}
+
+// ============================================================================
+// FULL UNROLL
+// ============================================================================
+
+// value the counter has when the loop is entered, if it is a constant:
+// every store reaching the header's load from outside the loop stores it
+static bool constant_start(unroll_candidate &c, long long *start) {
+    LLVMValueRef function = LLVMGetBasicBlockParent(c.loop->header);
+    unordered_map<LLVMValueRef, unordered_set<LLVMValueRef>> reaching;
+    compute_reaching_stores(function, reaching);
+
+    bool found = false;
+    for (LLVMValueRef store : reaching[LLVMGetOperand(c.compare, 0)]) {
+        if (c.loop->blocks.count(LLVMGetInstructionParent(store))) {
+            continue; // the counter update
+        }
+        if (!is_constant_store(store)) {
+            return false;
+        }
+        long long value = LLVMConstIntGetSExtValue(LLVMGetOperand(store, 0));
+        if (found && value != *start) {
+            return false;
+        }
+        *start = value;
+        found = true;
+    }
+    return found;
+}
+
+// number of times the body runs, or -1 if it isn't a small constant
+static long long constant_trip_count(unroll_candidate &c) {
+    LLVMValueRef bound = LLVMGetOperand(c.compare, 1);
+    long long i;
+    if (!LLVMIsAConstantInt(bound) || !constant_start(c, &i)) {
+        return -1;
+    }
+
+    unsigned width = int_width(bound);
+    long long n = LLVMConstIntGetSExtValue(bound);
+    LLVMIntPredicate pred = LLVMGetICmpPredicate(c.compare);
+
+    long long trips = 0;
+    while (evaluate_int_compare(pred, i, n, width)) {
+        if (++trips > unroll_cost.full_max_trips) {
+            return -1;
+        }
+        i = normalize_int(i + c.counter->step, width);
+    }
+    return trips;
+}
+
+static bool fully_unroll(unroll_candidate &c, long long trips) {
+    LLVMBasicBlockRef header = c.loop->header;
+    LLVMValueRef function = LLVMGetBasicBlockParent(header);
+
+    // preheader -> copy 1 -> ... -> copy T -> header
+    if (trips > 0) {
+        retarget_branch(c.preheader, header, clone_body_chain(c, trips, header, false));
+    }
+
+    // the header's test fails now, always
+    make_branch_unconditional(LLVMGetBasicBlockTerminator(header), c.exit);
+    remove_unreachable_blocks(function);
+    return true;
+}
+
+// ============================================================================
+// PARTIAL UNROLL
+// ============================================================================
+
+// a header that runs `factor` bodies per test, ahead of the original loop
+static bool partially_unroll(unroll_candidate &c) {
+    LLVMBasicBlockRef header = c.loop->header;
+    LLVMValueRef function = LLVMGetBasicBlockParent(header);
+    LLVMContextRef context = LLVMGetModuleContext(LLVMGetGlobalParent(function));
+
+    // only tests that stay true while the counter moves toward the bound
+    LLVMIntPredicate pred = LLVMGetICmpPredicate(c.compare);
+    long long step = c.counter->step;
+    bool counting_up = (pred == LLVMIntSLT || pred == LLVMIntSLE) && step > 0;
+    bool counting_down = (pred == LLVMIntSGT || pred == LLVMIntSGE) && step < 0;
+    unsigned width = int_width(LLVMGetOperand(c.compare, 0));
+    if ((!counting_up && !counting_down) || width >= 64) {
+        return false;
+    }
+
+    // step 1: the new header is a copy of the old one whose test asks for
+    // the counter `factor - 1` steps ahead
+    LLVMBasicBlockRef main_header = LLVMInsertBasicBlockInContext(context, header, "");
+    LLVMBuilderRef builder = LLVMCreateBuilder();
+    LLVMPositionBuilderAtEnd(builder, main_header);
+
+    unordered_map<LLVMValueRef, LLVMValueRef> value_map;
+    for (LLVMValueRef inst = LLVMGetFirstInstruction(header);
+         inst != LLVMGetBasicBlockTerminator(header);
+         inst = LLVMGetNextInstruction(inst)) {
+        LLVMValueRef clone = LLVMInstructionClone(inst);
+        LLVMInsertIntoBuilder(builder, clone);
+        int num_ops = LLVMGetNumOperands(clone);
+        for (int i = 0; i < num_ops; i++) {
+            auto it = value_map.find(LLVMGetOperand(clone, i));
+            if (it != value_map.end()) {
+                LLVMSetOperand(clone, i, it->second);
+            }
+        }
+        value_map[inst] = clone;
+    }
+
+    LLVMTypeRef wide = LLVMInt64TypeInContext(context);
+    LLVMValueRef i = LLVMBuildSExt(builder, value_map[LLVMGetOperand(c.compare, 0)], wide, "");
+    LLVMValueRef bound = LLVMGetOperand(c.compare, 1);
+    if (value_map.count(bound)) {
+        bound = value_map[bound];
+    }
+    LLVMValueRef n = LLVMBuildSExt(builder, bound, wide, "");
+    long long ahead = (long long)(unroll_cost.partial_factor - 1) * step;
+    LLVMValueRef last = LLVMBuildAdd(builder, i, LLVMConstInt(wide, (unsigned long long)ahead, 1), "");
+    LLVMValueRef test = LLVMBuildICmp(builder, pred, last, n, "");
+
+    // step 2: factor copies of the body, the last one loops back to the
+    // new header
+    LLVMBasicBlockRef first = clone_body_chain(c, unroll_cost.partial_factor, main_header, true);
+    LLVMValueRef branch = LLVMBuildCondBr(builder, test, first, header);
+    LLVMDisposeBuilder(builder);
+
+    // step 3: the loop is entered through the new header; the old loop is
+    // the remainder. tag both so they aren't unrolled again
+    retarget_branch(c.preheader, header, main_header);
+
+    LLVMValueRef tag = LLVMMDNodeInContext(context, NULL, 0);
+    LLVMSetMetadata(branch, unrolled_kind_id(), tag);
+    LLVMSetMetadata(LLVMGetBasicBlockTerminator(header), unrolled_kind_id(), tag);
+    return true;
+}
+
+bool loop_unrolling(LLVMModuleRef module) {
+    bool changed = false;
+
+    // iterate through all functions
+    for (LLVMValueRef function = LLVMGetFirstFunction(module);
+         function != NULL;
+         function = LLVMGetNextFunction(function)) {
+
+        vector<loop_info *> loops;
+        find_loops(function, loops);
+
+        for (loop_info *loop : loops) {
+            vector<induction_variable> ivs;
+            find_induction_variables(loop, ivs);
+
+            unroll_candidate c;
+            if (!analyze_loop(loop, ivs, &c)) {
+                continue;
+            }
+
+            long long trips = constant_trip_count(c);
+            bool full = trips >= 0 && trips * c.body_size <= unroll_cost.full_max_size;
+            bool partial = !full && unroll_cost.partial_factor > 1 &&
+                           unroll_cost.partial_factor * c.body_size <= unroll_cost.partial_max_size;
+            if (!full && !partial) {
+                continue;
+            }
+
+            c.preheader = ensure_preheader(loop);
+            if (full ? fully_unroll(c, trips) : partially_unroll(c)) {
+                // the cfg changed under the other loops; they are found
+                // again on the next round of the fixed-point loop
+                changed = true;
+                break;
+            }
+        }
+
+        free_loops(loops);
+    }
+
+    return changed;
+}
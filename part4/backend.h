@@ -0,0 +1,206 @@
+#ifndef BACKEND_H
+#define BACKEND_H
+
+#include <llvm-c/Core.h>
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+// ============================================================================
+// MACHINE CODE
+// ============================================================================
+// x86-64 instructions for one function, two-address like the hardware:
+// `dst op= src`. operands start out as virtual registers (one per IR value)
+// and get a physical register or a frame slot from the register allocator
+
+// hardware numbering, so the low 3 bits are the ModRM/REX encoding
+enum machine_register {
+    REG_RAX, REG_RCX, REG_RDX, REG_RBX, REG_RSP, REG_RBP, REG_RSI, REG_RDI,
+    REG_R8, REG_R9, REG_R10, REG_R11, REG_R12, REG_R13, REG_R14, REG_R15,
+};
+
+// condition codes, numbered like the low nibble of the jcc/setcc/cmov opcodes
+enum machine_condition {
+    CC_B = 2, CC_AE = 3, CC_E = 4, CC_NE = 5, CC_BE = 6, CC_A = 7,
+    CC_L = 12, CC_GE = 13, CC_LE = 14, CC_G = 15,
+};
+
+enum machine_opcode {
+    MI_MOV,      // dst = src
+    MI_MOVABS,   // dst (register) = src, a 64-bit immediate
+    MI_MOVSX,    // dst (register, 64 bit) = src sign-extended from 32 bits
+    MI_MOVZB,    // dst (register, 32 bit) = low byte of src, zero-extended
+    MI_MOVZL,    // dst (64 bit) = src zero-extended from 32 bits: a movl the
+                 // register allocator marks, not a copy
+    MI_LEA,      // dst (register) = src + index * scale + disp, src and index optional
+    MI_ADD,      // dst += src
+    MI_SUB,      // dst -= src
+    MI_IMUL,     // dst (register) *= src
+    MI_AND,      // dst &= src
+    MI_OR,       // dst |= src
+    MI_XOR,      // dst ^= src
+    MI_SHL,      // dst <<= src (an immediate, or %cl)
+    MI_SAR,      // dst >>= src, arithmetic
+    MI_SHR,      // dst >>= src, logical
+    MI_NEG,      // dst = -dst
+    MI_CMP,      // flags of dst - src
+    MI_TEST,     // flags of dst & src
+    MI_SETCC,    // low byte of dst = cond
+    MI_CMOV,     // dst (register) = src if cond
+    MI_CDQ,      // %edx = sign of %eax (%rdx of %rax at width 64)
+    MI_IDIV,     // %eax = %edx:%eax / src, %edx = remainder
+    MI_JCC,      // to block target if cond
+    MI_JMP,      // to block target
+    MI_CALL,     // symbol, arguments already in registers
+    MI_RET,      // epilogue and return, the result already in %eax
+    MI_UD2,      // unreachable
+};
+
+enum operand_kind {
+    OPND_NONE,
+    OPND_VREG,   // virtual register, value is its number
+    OPND_REG,    // physical register, value is a machine_register
+    OPND_IMM,    // immediate, value (32-bit signed except for MI_MOVABS)
+    OPND_SLOT,   // 8-byte frame slot, value is its number
+};
+
+struct machine_operand {
+    operand_kind kind;
+    long long value;
+};
+
+struct machine_instr {
+    machine_opcode op;
+    int width;                // 8, 32 or 64 bits
+    machine_operand dst;
+    machine_operand src;
+    machine_operand index;    // MI_LEA: the scaled register, with scale and disp
+    int scale;
+    long long disp;
+    int cond;                 // MI_SETCC, MI_CMOV, MI_JCC: machine_condition
+    int target;               // MI_JCC, MI_JMP: label of the block
+    std::string symbol;       // MI_CALL
+};
+
+struct machine_block {
+    int label;
+    std::vector<machine_instr> instrs;
+};
+
+struct machine_function {
+    std::string name;
+    std::vector<machine_block> blocks;   // in layout order
+    int vreg_count;
+    std::vector<int> vreg_width;         // 32 or 64 bits
+    std::vector<bool> keep_across_calls; // vreg may only get a callee-saved register
+    int slot_count;                      // allocas, then spills
+
+    // filled in by the register allocator
+    std::vector<int> saved_registers;    // callee-saved registers the body uses
+    int frame_size;                      // bytes below the saved registers
+};
+
+// the operand constructors isel and the allocator share
+machine_operand vreg_operand(int vreg);
+machine_operand reg_operand(machine_register reg);
+machine_operand imm_operand(long long value);
+machine_operand slot_operand(int slot);
+
+// a frame slot's offset from %rbp, once the frame is laid out (emit.cpp)
+int slot_offset(const machine_function &mf, long long slot);
+
+// ============================================================================
+// INSTRUCTION SELECTION (isel.cpp)
+// ============================================================================
+
+// lower one function of the optimized module to machine code on virtual
+// registers: expression trees covered by the patterns of isel.burs, phis
+// turned into copies on their edges. false (and a message) for IR miniC
+// can't produce
+bool select_instructions(LLVMValueRef function, machine_function *mf);
+
+// ============================================================================
+// REGISTER ALLOCATION (regalloc.cpp)
+// ============================================================================
+
+// linear scan over live intervals: every virtual register becomes a
+// physical register or a frame slot, and the frame is laid out, slots
+// that are never live at the same time sharing one
+void allocate_registers(machine_function *mf);
+
+// ============================================================================
+// PEEPHOLE (peephole.cpp)
+// ============================================================================
+
+enum peephole_pattern {
+    PEEP_REDUNDANT_MOVE,    // mov %r, %r, or a move straight back
+    PEEP_RELOAD,            // a slot load (or store) of what a register already holds
+    PEEP_LEA_CHAIN,         // lea of an lea's result folded into it
+    PEEP_FUSED_BRANCH,      // setcc, movzb, test, jne: the jcc reads the compare
+    PEEP_BRANCH_OVER_JUMP,  // jcc over a jmp: the inverse jcc
+    PEEP_TEST_ZERO,         // cmp $0, %r -> test %r, %r
+    PEEP_SHORT_IMMEDIATE,   // movq/movabs of a value movl can make
+    PEEP_ZERO_IDIOM,        // mov $0, %r -> xor %r, %r where the flags are dead
+    PEEPHOLE_PATTERNS,
+};
+
+// how often each pattern fired, over every function so far
+extern long long peephole_hits[PEEPHOLE_PATTERNS];
+
+// rewrite the allocated machine code through a small window, one pass
+// over each block: what the register allocator leaves behind for emit and
+// encode to read
+void peephole(machine_function *mf);
+
+// the hit counters, one line each
+void print_peephole_stats(FILE *out);
+
+// ============================================================================
+// ASSEMBLY OUTPUT (emit.cpp)
+// ============================================================================
+
+// AT&T syntax for `as`, prologue and epilogue included
+void print_function(const machine_function &mf, int index, FILE *out);
+
+// the whole backend: every function with a body, written to path as
+// assembly. false (and a message) on IR it can't lower or an unwritable file
+bool write_assembly(LLVMModuleRef module, const char *path);
+
+// ============================================================================
+// MACHINE CODE (encode.cpp)
+// ============================================================================
+
+// a call's rel32, for the linker to fill in (R_X86_64_PLT32)
+struct code_relocation {
+    size_t offset;
+    std::string symbol;
+};
+
+struct code_symbol {
+    std::string name;
+    size_t offset;
+    size_t size;
+};
+
+// the .text of an object file being put together
+struct machine_code {
+    std::vector<unsigned char> text;
+    std::vector<code_symbol> functions;
+    std::vector<code_relocation> calls;
+};
+
+// the bytes `as` makes of print_function's output, appended to code at
+// the next 16-byte boundary
+void encode_function(const machine_function &mf, machine_code *code);
+
+// ============================================================================
+// OBJECT FILES (elf.cpp)
+// ============================================================================
+
+// the whole backend without an assembler: every function with a body,
+// written to path as an ELF64 relocatable object. false (and a message) on
+// IR it can't lower or an unwritable file
+bool write_object(LLVMModuleRef module, const char *path);
+
+#endif
@@ -0,0 +1,1404 @@
+extern void print(int);
+extern int read();
+
+int func(int n){
+	int a;
+	int b;
+	a = n;
+	b = 1;
+	{
+	int z;
+	z = 0;
+	while (z < 0) {
+		int a;
+		int e;
+		a = read();
+		e = (13 + ((10 - 11) >= (20 - 3)));
+		if (11) {
+			int e;
+			e = (((n - a) / 10) >= ((0 < 17) < (read() != a)));
+			e = n;
+		}
+		z = z + 1;
+	}
+	}
+	if ((((n <= n) != 6) - n)) {
+		if (n) {
+			int d;
+			int c;
+			d = (((9 * read()) > (11 - n)) * (19 / 1));
+			c = (n <= ((1 - 14) / 2));
+			{
+			int zz;
+			zz = 0;
+			while (zz < 1) {
+				c = (((d <= d) / 16) <= ((d + d) / -8));
+				zz = zz + 1;
+			}
+			}
+		} else {
+			int b;
+			b = (-(10 < 5) + ((n - read()) / 1));
+			if (n) {
+				return (((12 / 7) < (n + 20)) * ((n != n) * 3));
+			}
+			if (b) {
+				int a;
+				int d;
+				a = read();
+				d = 14;
+				print(((b > a) + ((n / 7) / 1)));
+			} else {
+				print((n / 16));
+				b = read();
+				n = read();
+			}
+		}
+		n = ((n + (n >= read())) <= ((n != 0) >= (read() == 7)));
+		n = n;
+		return n;
+	}
+	n = (((n - n) != (n - n)) == 7);
+	n = n;
+	{
+	int zzz;
+	zzz = 0;
+	while (zzz < 3) {
+		print(((15 + (3 > n)) == 11));
+		n = (((15 * n) <= 17) + ((n > read()) > 0));
+		zzz = zzz + 1;
+	}
+	}
+	if (((n < (read() * n)) + ((2 - 1) < (n > n)))) {
+		n = ((read() > (n - read())) / 3);
+		if ((((7 > 1) - (20 < 0)) / 2)) {
+			int e;
+			e = n;
+			e = (((n <= read()) <= 12) + e);
+			if ((((e / 10) - (11 >= read())) + 5)) {
+				int b;
+				int a;
+				b = (((15 - n) <= (read() >= 5)) != (7 - (8 >= 12)));
+				a = (e != read());
+				n = (((e / 10) < (20 == 6)) != (16 < (n / 2)));
+				return 6;
+			}
+		}
+		if (((n + n) * read())) {
+			int d;
+			d = (19 <= ((14 != n) < n));
+			print((((n >= d) > (d / 1)) > -(read() > d)));
+			{
+			int zzzz;
+			zzzz = 0;
+			while (zzzz < 1) {
+				int a;
+				int c;
+				a = (((d / 7) != (n + read())) < n);
+				c = (d < n);
+				print(((-13 >= (d <= n)) != c));
+				return --19;
+				zzzz = zzzz + 1;
+			}
+			}
+			d = d;
+		} else {
+			int d;
+			int b;
+			d = ((read() + (n > 19)) - ((8 != n) == (n + n)));
+			b = (8 * 6);
+			{
+			int zzzzz;
+			zzzzz = 0;
+			while (zzzzz < 4) {
+				int c;
+				c = (((b != read()) <= (9 + n)) == b);
+				return (c >= ((d == b) > -n));
+				zzzzz = zzzzz + 1;
+			}
+			}
+			d = (((n - 12) >= (read() * d)) > d);
+		}
+	}
+	print(((n * (n + 1)) - (n == (n != n))));
+	n = 6;
+	if (((n == n) >= (7 <= (n - n)))) {
+		n = n;
+	} else {
+		int b;
+		int a;
+		b = n;
+		a = 20;
+		if ((b - ((19 - 5) == -b))) {
+			int b;
+			int c;
+			b = n;
+			c = ((a >= (a / 10)) != 15);
+			n = b;
+			b = 9;
+		}
+		a = ((-8 - (a >= b)) < read());
+		a = (((a * a) > b) > ((12 - a) > (5 / 10)));
+	}
+	if ((((10 >= n) / -8) + (read() < (n <= n)))) {
+		int a;
+		a = 18;
+		return n;
+	} else {
+		print(n);
+	}
+	{
+	int zzzzzz;
+	zzzzzz = 0;
+	while (zzzzzz < 0) {
+		if (4) {
+			return (((n < read()) + (n + 16)) - ((n <= n) * (n != n)));
+		}
+		if ((n <= ((n == 4) > (read() - n)))) {
+			{
+			int zzzzzzz;
+			zzzzzzz = 0;
+			while (zzzzzzz < 3) {
+				return ((n > n) / 7);
+				zzzzzzz = zzzzzzz + 1;
+			}
+			}
+			n = 12;
+		} else {
+			int b;
+			int a;
+			b = (((n * 16) < 13) < n);
+			a = (((n != n) > (n != 18)) <= n);
+			if (b) {
+				return read();
+			}
+		}
+		zzzzzz = zzzzzz + 1;
+	}
+	}
+	if ((read() + -(7 + n))) {
+		int e;
+		int b;
+		e = 19;
+		b = n;
+		if ((((read() < e) / 16) == (15 + (17 * b)))) {
+			int e;
+			int b;
+			e = (((16 + n) >= (n < 9)) * (11 - n));
+			b = (12 >= 11);
+			return ((n != 17) < 1);
+		} else {
+			int b;
+			int e;
+			b = (((n != 9) < (10 <= n)) - (n != (9 + 8)));
+			e = ((19 >= n) > ((n == n) == (16 * n)));
+			print(n);
+			{
+			int zzzzzzzz;
+			zzzzzzzz = 0;
+			while (zzzzzzzz < 2) {
+				int c;
+				c = read();
+				b = 2;
+				return (8 != 12);
+				zzzzzzzz = zzzzzzzz + 1;
+			}
+			}
+		}
+		n = (((read() > n) == b) == 4);
+		print((((7 + n) + read()) + n));
+	} else {
+		int c;
+		c = (6 != (n < (n * n)));
+		{
+		int zzzzzzzzz;
+		zzzzzzzzz = 0;
+		while (zzzzzzzzz < 3) {
+			c = n;
+			zzzzzzzzz = zzzzzzzzz + 1;
+		}
+		}
+		if ((((c * n) == c) * ((n == 18) + (9 != c)))) {
+			if (((n <= c) >= n)) {
+				return (n < -(18 * 6));
+			}
+			print((12 / -3));
+			{
+			int zzzzzzzzzz;
+			zzzzzzzzzz = 0;
+			while (zzzzzzzzzz < 2) {
+				int c;
+				c = ((4 == n) - ((n != n) >= 2));
+				n = ((4 != (0 + n)) < (12 != 11));
+				zzzzzzzzzz = zzzzzzzzzz + 1;
+			}
+			}
+			{
+			int zzzzzzzzzzz;
+			zzzzzzzzzzz = 0;
+			while (zzzzzzzzzzz < 3) {
+				return (6 / -3);
+				zzzzzzzzzzz = zzzzzzzzzzz + 1;
+			}
+			}
+		}
+		c = (c == read());
+	}
+	n = 6;
+	{
+	int zzzzzzzzzzzz;
+	zzzzzzzzzzzz = 0;
+	while (zzzzzzzzzzzz < 0) {
+		return n;
+		zzzzzzzzzzzz = zzzzzzzzzzzz + 1;
+	}
+	}
+	if ((((2 < 0) == 16) + (n != (12 > n)))) {
+		int a;
+		int c;
+		a = 0;
+		c = (read() * n);
+		print((13 >= -(19 <= a)));
+	} else {
+		int d;
+		d = (n < n);
+		d = d;
+		{
+		int zzzzzzzzzzzzz;
+		zzzzzzzzzzzzz = 0;
+		while (zzzzzzzzzzzzz < 1) {
+			if ((read() / 7)) {
+				int a;
+				a = (((4 * read()) <= (10 - n)) > (3 * (n < 16)));
+				print((((11 - read()) == (14 + a)) > ((15 + 18) >= (n - d))));
+			} else {
+				int a;
+				int c;
+				a = 13;
+				c = 8;
+				return n;
+			}
+			n = (((17 <= d) == (20 + read())) <= ((n == n) != (read() / 10)));
+			{
+			int zzzzzzzzzzzzzz;
+			zzzzzzzzzzzzzz = 0;
+			while (zzzzzzzzzzzzzz < 4) {
+				int e;
+				e = (((read() != d) != (17 * d)) * ((read() - read()) == (11 - d)));
+				return 9;
+				zzzzzzzzzzzzzz = zzzzzzzzzzzzzz + 1;
+			}
+			}
+			print((20 * (10 != d)));
+			zzzzzzzzzzzzz = zzzzzzzzzzzzz + 1;
+		}
+		}
+		return ((d <= (n >= n)) > ((n * n) > (read() >= read())));
+	}
+	n = ((19 - (n > n)) < n);
+	{
+	int zzzzzzzzzzzzzzz;
+	zzzzzzzzzzzzzzz = 0;
+	while (zzzzzzzzzzzzzzz < 1) {
+		return 8;
+		zzzzzzzzzzzzzzz = zzzzzzzzzzzzzzz + 1;
+	}
+	}
+	if (((13 - (n == 14)) >= ((n == n) != n))) {
+		print(n);
+	} else {
+		int e;
+		e = (((2 / 1) - (n - n)) + (n >= (read() != n)));
+		e = (15 - (read() - n));
+		return 12;
+	}
+	if (n) {
+		int d;
+		int a;
+		d = -n;
+		a = (((18 < n) != (n / -3)) > read());
+		print((3 + (17 != (a == 5))));
+	} else {
+		if ((((n / 16) - (15 <= 9)) >= 14)) {
+			if (-n) {
+				int c;
+				c = (((3 < n) * (n + n)) + ((n - n) < (7 > n)));
+				return n;
+			}
+			if (((read() / 3) >= ((n - read()) > (n - n)))) {
+				n = n;
+			}
+		}
+		print((((n <= 15) == (n >= n)) <= n));
+	}
+	print(n);
+	if (0) {
+		print((((7 > 7) <= n) <= -(n * 12)));
+	} else {
+		n = read();
+		{
+		int zzzzzzzzzzzzzzzz;
+		zzzzzzzzzzzzzzzz = 0;
+		while (zzzzzzzzzzzzzzzz < 1) {
+			print((((2 + 10) > (n == 4)) / 3));
+			zzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzz + 1;
+		}
+		}
+		{
+		int zzzzzzzzzzzzzzzzz;
+		zzzzzzzzzzzzzzzzz = 0;
+		while (zzzzzzzzzzzzzzzzz < 4) {
+			{
+			int zzzzzzzzzzzzzzzzzz;
+			zzzzzzzzzzzzzzzzzz = 0;
+			while (zzzzzzzzzzzzzzzzzz < 0) {
+				return (((n + n) >= -read()) <= (18 > n));
+				zzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzz + 1;
+			}
+			}
+			{
+			int zzzzzzzzzzzzzzzzzzz;
+			zzzzzzzzzzzzzzzzzzz = 0;
+			while (zzzzzzzzzzzzzzzzzzz < 4) {
+				return (((n != 17) + (n / 16)) >= (19 / -8));
+				zzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzz + 1;
+			}
+			}
+			return (((n + read()) / 3) * n);
+			zzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzz + 1;
+		}
+		}
+	}
+	n = 10;
+	n = 16;
+	{
+	int zzzzzzzzzzzzzzzzzzzz;
+	zzzzzzzzzzzzzzzzzzzz = 0;
+	while (zzzzzzzzzzzzzzzzzzzz < 2) {
+		print((14 <= ((19 < 4) <= 10)));
+		zzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzz + 1;
+	}
+	}
+	if ((6 * ((3 >= 2) != n))) {
+		if ((((16 + 20) / 7) >= (-15 != 6))) {
+			int e;
+			int b;
+			e = ((7 - n) / 16);
+			b = n;
+			return read();
+		}
+		{
+		int zzzzzzzzzzzzzzzzzzzzz;
+		zzzzzzzzzzzzzzzzzzzzz = 0;
+		while (zzzzzzzzzzzzzzzzzzzzz < 1) {
+			int d;
+			int c;
+			d = 8;
+			c = n;
+			{
+			int zzzzzzzzzzzzzzzzzzzzzz;
+			zzzzzzzzzzzzzzzzzzzzzz = 0;
+			while (zzzzzzzzzzzzzzzzzzzzzz < 2) {
+				int b;
+				int d;
+				b = (c + ((0 / 3) >= c));
+				d = (6 + ((14 == n) >= (c - n)));
+				d = (d >= ((read() * read()) * (read() - 4)));
+				return (((d / 2) >= -5) + (d - (13 / 3)));
+				zzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzz + 1;
+			}
+			}
+			print((d != (20 <= -n)));
+			zzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzz + 1;
+		}
+		}
+		n = (n / 3);
+	} else {
+		int c;
+		int b;
+		c = 19;
+		b = n;
+		{
+		int zzzzzzzzzzzzzzzzzzzzzzz;
+		zzzzzzzzzzzzzzzzzzzzzzz = 0;
+		while (zzzzzzzzzzzzzzzzzzzzzzz < 0) {
+			print((-(b + b) / 7));
+			zzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzz + 1;
+		}
+		}
+		n = (n / 1);
+		{
+		int zzzzzzzzzzzzzzzzzzzzzzzz;
+		zzzzzzzzzzzzzzzzzzzzzzzz = 0;
+		while (zzzzzzzzzzzzzzzzzzzzzzzz < 3) {
+			int e;
+			e = ((11 != (12 - 10)) >= ((read() == 15) > 14));
+			print(c);
+			zzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzz + 1;
+		}
+		}
+	}
+	if (n) {
+		int c;
+		c = ((20 <= (0 == n)) - ((n / 7) / 10));
+		{
+		int zzzzzzzzzzzzzzzzzzzzzzzzz;
+		zzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+		while (zzzzzzzzzzzzzzzzzzzzzzzzz < 4) {
+			n = (((read() < read()) <= -c) > ((c != n) + n));
+			return (((5 != c) >= (2 == n)) * (c != n));
+			zzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+		}
+		}
+	} else {
+		int e;
+		e = ((n / 10) > ((n == n) <= (n < 20)));
+		if (((12 != (3 < 0)) - ((e < e) > 10))) {
+			n = (((e == n) < (4 != e)) < ((e <= 1) >= -14));
+			e = e;
+			if (((e + (3 <= e)) <= (-n == (3 * n)))) {
+				int d;
+				int a;
+				d = (read() >= ((14 == 9) == (5 / 2)));
+				a = e;
+				e = 15;
+			}
+		}
+		e = n;
+	}
+	{
+	int zzzzzzzzzzzzzzzzzzzzzzzzzz;
+	zzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+	while (zzzzzzzzzzzzzzzzzzzzzzzzzz < 1) {
+		n = (((n < read()) < -13) * ((18 >= 4) <= (8 + read())));
+		n = (((n == n) <= (6 / 2)) - ((read() != 5) < (4 > n)));
+		return (((n != 20) * (n - n)) > 3);
+		zzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+	}
+	}
+	if ((((n >= n) + (n + n)) / 10)) {
+		int b;
+		b = (6 <= 14);
+		n = (((11 / -8) < (b != n)) + ((16 / 3) / 2));
+		b = (14 * ((10 * 11) == 2));
+		n = 16;
+		print((((19 - n) != read()) <= ((b > n) <= (14 <= read()))));
+	} else {
+		{
+		int zzzzzzzzzzzzzzzzzzzzzzzzzzz;
+		zzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+		while (zzzzzzzzzzzzzzzzzzzzzzzzzzz < 2) {
+			if (((read() != 6) == n)) {
+				int e;
+				int c;
+				e = 14;
+				c = ((n < (n + 4)) >= ((10 == n) + (n / -8)));
+				n = 12;
+				c = (0 >= ((c == c) * (13 < 12)));
+				return ((n + (14 / 7)) * ((n <= n) - (15 * c)));
+			}
+			zzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+		}
+		}
+		return -((18 / 1) / 2);
+	}
+	n = (n > n);
+	{
+	int zzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+	zzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+	while (zzzzzzzzzzzzzzzzzzzzzzzzzzzz < 4) {
+		if (((n * n) / 10)) {
+			int a;
+			int e;
+			a = n;
+			e = n;
+			e = 3;
+			{
+			int zzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+			while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 0) {
+				print(n);
+				e = (((n / 3) / 10) / 16);
+				print(2);
+				zzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+			}
+			}
+		} else {
+			int e;
+			int c;
+			e = 20;
+			c = 12;
+			c = (((2 > 19) + e) * ((e == n) / 16));
+		}
+		{
+		int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+		while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 1) {
+			int a;
+			int e;
+			a = (((20 > n) <= (n / 2)) / 7);
+			e = (((read() - n) == (n / -8)) >= (read() >= n));
+			{
+			int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+			while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 3) {
+				int a;
+				int c;
+				a = n;
+				c = (2 > ((n - n) == e));
+				n = 5;
+				zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+			}
+			}
+			{
+			int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+			while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 0) {
+				int a;
+				a = (((read() > 9) <= (n == read())) / 2);
+				e = n;
+				n = a;
+				n = (((read() / 1) < (7 * read())) != ((e >= 9) <= (a == e)));
+				return 10;
+				zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+			}
+			}
+			a = -(a == a);
+			if (-(16 > read())) {
+				int b;
+				b = (((10 * 19) < (read() > 2)) > ((0 <= 2) - (a <= 17)));
+				n = (((a / -8) != (a < 9)) - ((a - b) * -b));
+				print((((a != a) <= (read() != 2)) != b));
+				return ((4 != (a < 0)) + ((e + 11) != e));
+			} else {
+				int d;
+				d = (((n > e) <= 10) != ((n + e) / 2));
+				n = (((15 / 3) / 2) + 15);
+				return (((d * d) == d) * d);
+			}
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+		}
+		}
+		if (13) {
+			int c;
+			int a;
+			c = n;
+			a = ((n / -3) / 16);
+			return (4 * ((10 <= a) <= -c));
+		}
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+	}
+	}
+	n = n;
+	if (8) {
+		int a;
+		int c;
+		a = n;
+		c = 14;
+		{
+		int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+		while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 3) {
+			int a;
+			a = n;
+			c = (((18 <= a) > (14 >= 7)) + ((n * 0) - (13 / 7)));
+			a = (((a < 4) / 1) != read());
+			if (c) {
+				int c;
+				int a;
+				c = ((15 >= (0 >= 6)) > (18 * (19 * 0)));
+				a = (n + ((4 - 14) >= (read() + n)));
+				return (((5 - a) != (0 != c)) != ((8 * read()) != (n < a)));
+			}
+			c = (((a <= 9) + (12 != c)) > ((18 / -3) * (16 != 1)));
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+		}
+		}
+		{
+		int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+		while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 2) {
+			int e;
+			e = ((a < (n + a)) >= ((c < 2) + 10));
+			if (e) {
+				int d;
+				int b;
+				d = e;
+				b = ((3 == n) / 2);
+				return 11;
+			} else {
+				return 16;
+			}
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+		}
+		}
+		{
+		int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+		while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 1) {
+			int c;
+			c = (((a / 3) != (n < a)) != 12);
+			c = 18;
+			c = (((5 < 10) >= (c <= a)) < (a == (c - n)));
+			if (((9 > (12 * 13)) - (-c <= a))) {
+				int c;
+				int b;
+				c = (((a <= 19) - (a < a)) * ((a + read()) < (0 == n)));
+				b = (((20 * 9) * (n < a)) < (1 != (18 <= 15)));
+				c = (((n / 7) / 2) + b);
+				print(((-c > 7) <= ((14 <= n) >= (c / 10))));
+			} else {
+				int a;
+				a = ((4 * (n > n)) != ((n / -3) == read()));
+				return (((c - a) * (10 + 15)) <= ((0 - 9) != 18));
+			}
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+		}
+		}
+	}
+	if (((n <= n) + 12)) {
+		if ((((read() != n) == (17 < 7)) * ((1 != 20) / 1))) {
+			if (((n * (read() != n)) * (n >= (n + n)))) {
+				return n;
+			} else {
+				return ((n + (4 >= 0)) * 12);
+			}
+			print((((14 < 1) < (9 + read())) > n));
+			if ((9 + 17)) {
+				int c;
+				int d;
+				c = (((4 - 9) <= 1) * n);
+				d = (((n >= n) > read()) - (-n > (5 != n)));
+				return (((c + d) <= (d + 11)) / 16);
+			} else {
+				int a;
+				int c;
+				a = (((10 + n) < (1 >= 1)) * (14 / 7));
+				c = (((n >= n) > (n / -3)) - ((2 / 3) <= (n != 10)));
+				return (((18 >= n) >= (12 - 2)) <= (n < (2 != n)));
+			}
+		}
+	} else {
+		if ((n < (n != n))) {
+			return (((7 - n) * (read() > 19)) <= (read() <= 11));
+		}
+		n = (((16 * n) * 3) / -8);
+		{
+		int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+		while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 2) {
+			int b;
+			int e;
+			b = n;
+			e = n;
+			n = ((-16 > 6) != b);
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+		}
+		}
+	}
+	n = 11;
+	{
+	int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+	zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+	while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 2) {
+		n = (((8 >= 8) + (12 > n)) >= n);
+		print(((n / 7) / 10));
+		if ((2 < ((18 * n) != (14 + n)))) {
+			if ((((4 * n) / -8) >= ((3 > 19) > (n == 17)))) {
+				int c;
+				c = 11;
+				n = (c + ((n > c) != read()));
+				return c;
+			}
+		}
+		n = (((15 / 2) * n) * ((n <= 9) * (n + 20)));
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+	}
+	}
+	n = ((n == (6 - 19)) <= ((9 / -8) != read()));
+	{
+	int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+	zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+	while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 2) {
+		int c;
+		c = -((n + n) / 1);
+		if ((((13 + c) - (c <= n)) / 10)) {
+			if ((n > ((c < read()) / 2))) {
+				int a;
+				int b;
+				a = -19;
+				b = (((c > n) == (c - c)) > ((n >= 8) < (0 + n)));
+				return (((n > a) <= (c + 14)) / -8);
+			}
+		}
+		if (n) {
+			if ((((n / -3) <= (n >= 10)) + read())) {
+				int e;
+				e = n;
+				print(((-e == (c <= 15)) >= ((read() >= 8) - (11 + c))));
+				print(c);
+				print(17);
+			} else {
+				return 5;
+			}
+		}
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+	}
+	}
+	if ((((n <= n) * -0) - ((n > 19) - n))) {
+		print(3);
+		n = n;
+		{
+		int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+		while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 2) {
+			if (n) {
+				int e;
+				int b;
+				e = (((18 - n) < (n - 6)) != 19);
+				b = (n >= (read() / 3));
+				e = (((b != b) != (e - n)) * (-b < (20 != e)));
+				print(e);
+				return (6 >= ((9 == e) <= (b / 2)));
+			} else {
+				int c;
+				int e;
+				c = (12 < (15 - (19 + n)));
+				e = ((read() < (n + n)) - ((n <= 8) != (n - n)));
+				return n;
+			}
+			if ((-(6 >= 6) >= 16)) {
+				return (((10 - n) < n) * ((3 / -3) > n));
+			}
+			if (((11 >= (n > 18)) - n)) {
+				return 5;
+			} else {
+				return (((n / 7) - (n < n)) != 12);
+			}
+			n = (n * 5);
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+		}
+		}
+	}
+	{
+	int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+	zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+	while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 2) {
+		n = 18;
+		print(((n <= (16 <= n)) <= ((18 + n) >= (11 + n))));
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+	}
+	}
+	if (-n) {
+		int d;
+		d = (((7 < n) == (6 <= 5)) >= 11);
+		{
+		int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+		while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 2) {
+			int c;
+			c = (((d - d) > (20 == d)) > ((n / -3) + d));
+			if (((12 > (d <= c)) >= ((d > 9) <= (19 == d)))) {
+				d = (((2 * 14) + (20 - d)) >= c);
+			} else {
+				int d;
+				d = (((read() >= read()) - (7 > n)) == ((n <= n) >= (read() < n)));
+				return d;
+			}
+			print((((c != read()) <= n) != 9));
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+		}
+		}
+		{
+		int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+		while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 1) {
+			int c;
+			int d;
+			c = n;
+			d = ((20 / 10) == ((n < n) / 7));
+			c = (((2 <= d) < (d / 7)) > ((d > c) > (7 <= d)));
+			print((((c <= 7) + (17 / -3)) < ((1 / 3) > (d != read()))));
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+		}
+		}
+		{
+		int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+		while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 0) {
+			int c;
+			int a;
+			c = -((16 >= d) / 7);
+			a = ((d == (11 > 10)) * 4);
+			{
+			int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+			while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 1) {
+				int e;
+				int b;
+				e = (c / -3);
+				b = (read() > (read() >= (c == read())));
+				return d;
+				zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+			}
+			}
+			if ((((read() * a) - (18 * read())) < -(20 + a))) {
+				int e;
+				e = (((read() * read()) + (a >= d)) > (3 / 1));
+				return ((c <= (4 == read())) > read());
+			}
+			if ((((1 < c) >= (9 > c)) <= n)) {
+				int c;
+				c = read();
+				n = (((read() == read()) - n) > ((d / 1) - (c / 2)));
+				c = (((read() - a) * n) < (c >= (c < 10)));
+				c = d;
+			} else {
+				int b;
+				b = (c - ((13 < d) > (d - read())));
+				return (((0 - 12) != (11 * n)) <= ((19 != 13) + read()));
+			}
+			c = (d - a);
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+		}
+		}
+	}
+	if (((-n + -n) / 3)) {
+		int d;
+		d = -15;
+		d = (n <= (d > (d != 19)));
+	} else {
+		int a;
+		int e;
+		a = ((1 - (n > 19)) - ((n >= 19) == (n == read())));
+		e = (((1 + n) > (10 >= read())) - (n != 19));
+		if ((e >= ((16 / -3) > e))) {
+			int a;
+			int c;
+			a = e;
+			c = (e > ((3 < e) - (read() < 18)));
+			if (e) {
+				int b;
+				int d;
+				b = 1;
+				d = a;
+				a = (((n > d) / -3) - read());
+			}
+			if (n) {
+				return ((9 <= (n >= e)) <= 10);
+			} else {
+				int e;
+				int a;
+				e = (((c / -3) / 2) - c);
+				a = ((read() == (c <= n)) < ((n > 7) + (16 * read())));
+				a = (((n * e) / 10) - a);
+				return ((a < (a > e)) + 9);
+			}
+		}
+		e = n;
+		{
+		int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+		while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 4) {
+			{
+			int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+			while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 4) {
+				return n;
+				zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+			}
+			}
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+		}
+		}
+	}
+	{
+	int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+	zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+	while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 4) {
+		if (n) {
+			print((((n > n) >= (5 != n)) / 10));
+		} else {
+			int d;
+			d = (((n * read()) > (read() / -8)) / 16);
+			{
+			int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+			while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 3) {
+				int d;
+				d = n;
+				return (((20 - 15) / 3) != ((d >= read()) <= (19 / 1)));
+				zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+			}
+			}
+		}
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+	}
+	}
+	{
+	int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+	zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+	while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 0) {
+		int a;
+		a = (n + ((n * n) > (14 * n)));
+		n = (n / 1);
+		if (a) {
+			if ((3 >= a)) {
+				int e;
+				e = (((n <= 8) <= (read() - 4)) / -3);
+				e = (e == 20);
+				print(((-17 * 13) > (13 <= a)));
+			}
+			n = a;
+			{
+			int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+			while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 2) {
+				n = (((n + 17) != (13 + a)) + ((15 >= read()) == 3));
+				print((((a >= n) * n) >= 7));
+				print((n - ((read() / 16) < (1 != 8))));
+				zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+			}
+			}
+			if ((((read() > n) * read()) - (n / 7))) {
+				int c;
+				int a;
+				c = (((n / 2) - n) >= (14 == (10 <= read())));
+				a = n;
+				return (((n == c) != a) / 16);
+			} else {
+				return n;
+			}
+		} else {
+			return (n <= read());
+		}
+		print(((15 + (11 > 14)) != 6));
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+	}
+	}
+	{
+	int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+	zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+	while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 4) {
+		if ((16 / 16)) {
+			n = -(read() > (n >= n));
+		} else {
+			{
+			int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+			while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 3) {
+				int b;
+				b = (7 >= ((8 - 4) == n));
+				return (((5 / -3) != (read() == b)) + ((read() / 10) / 3));
+				zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+			}
+			}
+			if ((12 == ((18 >= 8) + (n / -8)))) {
+				int a;
+				a = (((n != read()) / 2) != ((6 >= 11) == n));
+				return (1 != (a / -3));
+			}
+			print(n);
+			{
+			int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+			while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 4) {
+				int e;
+				int b;
+				e = (((n + n) / 1) - (n >= (13 < 9)));
+				b = 20;
+				return b;
+				zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+			}
+			}
+		}
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+	}
+	}
+	{
+	int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+	zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+	while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 1) {
+		int b;
+		b = ((6 / 1) < (n < (4 * 14)));
+		n = (((11 == 8) * read()) >= (b == (n * b)));
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+	}
+	}
+	n = (n * 9);
+	{
+	int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+	zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+	while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 2) {
+		int d;
+		d = ((3 == (read() != read())) + (n - (n == 2)));
+		n = (((n >= n) + (4 + 1)) - ((d - d) < read()));
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+	}
+	}
+	if (7) {
+		int b;
+		int e;
+		b = n;
+		e = n;
+		print((((read() < 2) > 13) * e));
+		print(-((e / 2) * (read() <= 4)));
+	}
+	n = (((12 / 3) == (13 == 3)) <= (5 < (16 <= n)));
+	if ((((13 == 9) * (n < 8)) == ((n > 6) / -8))) {
+		int b;
+		int d;
+		b = (((n <= 3) < -n) - ((6 != n) / 3));
+		d = n;
+		{
+		int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+		while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 3) {
+			if ((1 < ((10 / 10) < (d != 17)))) {
+				b = (3 < (read() != d));
+			}
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+		}
+		}
+		return 9;
+	}
+	n = n;
+	print(9);
+	if ((((n - n) / 7) >= ((n != 1) / 16))) {
+		n = (((n * n) > (4 * 20)) >= ((n <= 2) / 7));
+		{
+		int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+		while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 0) {
+			int a;
+			int c;
+			a = 9;
+			c = 16;
+			print(c);
+			print((6 / -8));
+			return -((5 < 16) / 1);
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+		}
+		}
+	} else {
+		int d;
+		d = read();
+		d = d;
+		n = (n <= (d * (d * 20)));
+		print(15);
+		d = (((d != d) < n) != -(read() * 5));
+	}
+	if ((read() < (n > (n < n)))) {
+		n = (((5 / 2) <= 14) - n);
+		n = (((n < n) + n) >= ((read() / 2) - (n - n)));
+		n = (7 * (n <= n));
+	}
+	{
+	int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+	zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+	while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 3) {
+		if ((15 > ((n == n) * (17 > n)))) {
+			int e;
+			int c;
+			e = (((n / 7) - (9 >= 3)) * 0);
+			c = (((19 > n) >= (n == n)) + ((7 - n) > (8 != 4)));
+			print((((6 / 7) < read()) * c));
+			{
+			int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+			while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 3) {
+				print(19);
+				n = (1 * (read() * 4));
+				return (c / 10);
+				zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+			}
+			}
+			e = (n == read());
+			c = (((18 >= c) - (16 == read())) / 16);
+		}
+		if (((9 - 18) != ((8 <= 7) + (n / 2)))) {
+			n = ((0 == (n / 3)) * 15);
+			{
+			int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+			while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 2) {
+				print((((18 <= 12) != (n * n)) / -3));
+				return (((14 <= 19) >= (2 <= n)) >= n);
+				zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+			}
+			}
+			if ((((13 < n) != 2) - ((n == n) / 1))) {
+				print((((n >= 5) > (n + 0)) > read()));
+			} else {
+				int b;
+				b = -(-7 * (n == 14));
+				print((n < ((8 * b) != (n == read()))));
+				return (((n * n) < (17 >= 18)) != 4);
+			}
+		} else {
+			{
+			int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+			while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 0) {
+				n = ((n >= (n == 12)) - ((n < 13) != (18 != n)));
+				return n;
+				zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+			}
+			}
+			if ((n + ((11 / 16) - (n != n)))) {
+				int b;
+				int e;
+				b = 17;
+				e = n;
+				b = (((e != b) > 9) >= ((e != 12) + (b <= 19)));
+			}
+		}
+		return n;
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+	}
+	}
+	print((((11 != read()) > (n == n)) / 10));
+	if ((((n * n) * (n >= n)) == (n / 16))) {
+		if ((n - -(n - n))) {
+			int b;
+			b = (((n + n) > (n * read())) / 2);
+			b = (n * ((b / 7) == (n - n)));
+			if ((read() <= ((b <= n) / -3))) {
+				int b;
+				b = (((n != 18) == (n == 16)) == (n + -n));
+				b = b;
+			}
+		} else {
+			int d;
+			d = 5;
+			{
+			int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+			while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 1) {
+				int b;
+				b = 11;
+				return ((-d > (16 / -3)) * ((11 == n) * (n * b)));
+				zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+			}
+			}
+			if ((3 >= ((7 > d) - (20 == d)))) {
+				return -((d > read()) <= 14);
+			}
+			print((n >= n));
+			print(n);
+		}
+		{
+		int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+		while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 2) {
+			n = ((19 + (n != read())) * ((n / -8) != (7 <= n)));
+			n = n;
+			if ((((n >= 13) + (14 == 18)) + read())) {
+				int e;
+				int d;
+				e = (((n * n) > (n != n)) == ((n * 12) >= (n == read())));
+				d = (((19 - n) - (10 + 10)) / 3);
+				d = (((e * e) + (18 != 1)) == (20 * (e <= 7)));
+				e = e;
+			} else {
+				int b;
+				int d;
+				b = ((15 <= (13 * n)) / 3);
+				d = (n / 1);
+				n = (b != (b < (d * n)));
+			}
+			n = (n == n);
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+		}
+		}
+	} else {
+		int b;
+		int a;
+		b = (3 != ((n / 1) / -3));
+		a = 19;
+		{
+		int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+		while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 3) {
+			int a;
+			int d;
+			a = (((n / 7) > (13 * 14)) + 7);
+			d = (((16 >= n) < (b >= n)) - (9 == 12));
+			n = (20 + n);
+			if ((((d - 0) <= a) <= a)) {
+				int a;
+				int d;
+				a = n;
+				d = (19 / -3);
+				print((((n == 12) * (a <= a)) < b));
+			}
+			return (((d / -8) * (a * 8)) / -8);
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+		}
+		}
+		{
+		int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+		while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 4) {
+			int c;
+			c = (18 * a);
+			return read();
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+		}
+		}
+		a = ((n > (8 - 17)) != read());
+	}
+	if ((12 > ((n / 10) / 10))) {
+		return n;
+	} else {
+		print((((n - 20) < (2 * 9)) / 7));
+		if ((((19 >= 8) > (n < read())) * ((n > n) == -n))) {
+			n = (((n < 20) == n) / -8);
+		} else {
+			{
+			int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+			while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 1) {
+				int c;
+				c = (((9 < n) != (16 == 11)) + (n != (n + 7)));
+				return 4;
+				zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+			}
+			}
+			n = (n < ((n <= 4) != (n / 16)));
+			if (n) {
+				int d;
+				int c;
+				d = ((n > (n * 17)) == ((n - n) < (n >= n)));
+				c = (((15 - n) / 16) > ((n != 18) / 2));
+				c = (((8 * read()) > (15 - 20)) <= 10);
+				return 3;
+			}
+		}
+		n = ((n >= (17 - n)) == (read() / 16));
+	}
+	n = (((20 / 10) != (n <= 10)) != (17 - (n >= read())));
+	{
+	int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+	zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+	while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 4) {
+		n = (((n / 16) - read()) <= -n);
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+	}
+	}
+	{
+	int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+	zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+	while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 0) {
+		return ((3 < (n < n)) / 16);
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+	}
+	}
+	{
+	int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+	zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+	while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 2) {
+		int e;
+		e = n;
+		print((e > ((read() + n) != (e >= read()))));
+		{
+		int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+		while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 3) {
+			{
+			int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+			while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 0) {
+				int a;
+				int c;
+				a = (((5 / 7) > e) + ((e != n) + (6 / 16)));
+				c = (((n >= e) < (9 / 16)) < 2);
+				e = 4;
+				n = (((n >= 17) - (e == e)) - 8);
+				zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+			}
+			}
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+		}
+		}
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+	}
+	}
+	if ((((n > read()) != (n / 16)) < ((n - n) / 2))) {
+		if (n) {
+			n = (5 < 4);
+			if (2) {
+				int c;
+				c = (((7 < n) >= n) + ((4 + n) == (read() != n)));
+				return ((c < 13) <= ((c >= 5) < (20 > 16)));
+			} else {
+				int c;
+				c = ((17 < (n + 3)) == 2);
+				return n;
+			}
+			if ((18 >= ((n / -8) - (11 * 13)))) {
+				n = (((20 == n) != (10 > n)) >= n);
+				return 14;
+			}
+		} else {
+			int b;
+			b = n;
+			n = ((b - (b - n)) > ((b >= b) < (b / -8)));
+			if (8) {
+				int a;
+				int e;
+				a = read();
+				e = (12 < 7);
+				n = ((20 * (11 <= n)) - (read() / 1));
+			}
+		}
+	}
+	n = (((n + n) == (n + 0)) + n);
+	{
+	int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+	zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+	while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 0) {
+		int e;
+		e = (((n / -8) >= n) / 16);
+		print(e);
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+	}
+	}
+	{
+	int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+	zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+	while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 1) {
+		int d;
+		int e;
+		d = read();
+		e = (((n - 4) > (19 == n)) + (n > 4));
+		{
+		int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+		while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 3) {
+			print((((e != d) > (10 / 1)) / 16));
+			{
+			int zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz;
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = 0;
+			while (zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz < 0) {
+				return ((e <= (e / 3)) == ((n + d) / 3));
+				zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+			}
+			}
+			if ((e == (18 >= (read() == n)))) {
+				return (((e == d) >= d) < d);
+			} else {
+				e = (e != ((13 <= 0) != (n + e)));
+			}
+			zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+		}
+		}
+		zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz = zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz + 1;
+	}
+	}
+	print((read() != 14));
+	n = (((n - 12) <= read()) + ((n / 2) >= 17));
+	print(3);
+	n = (((n / 1) != -n) < -(n > n));
+	return a + b;
+}
@@ -0,0 +1,22 @@
+extern void print(int);
+extern int read();
+
+int func(int n){
+	int i;
+	int x;
+	int steps;
+	i = 1;
+	steps = 0;
+	while (i < n){
+		x = i;
+		while (x > 1){
+			if (x - x / 2 * 2 == 1)
+				x = 3 * x + 1;
+			else
+				x = x / 2;
+			steps = steps + 1;
+		}
+		i = i + 1;
+	}
+	return steps;
+}
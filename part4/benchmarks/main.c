@@ -0,0 +1,28 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+extern int func(int);
+
+void print(int n){
+	printf("%d\n", n);
+}
+
+int read(){
+	int n;
+	if (scanf("%d", &n) != 1)
+		n = 0;
+	return n;
+}
+
+// ./bench <n>: times one call of func(n)
+int main(int argc, char **argv){
+	int n = argc > 1 ? atoi(argv[1]) : 1000;
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	int result = func(n);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	double ms = (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+	printf("func(%d) = %d in %.3f ms\n", n, result, ms);
+	return 0;
+}
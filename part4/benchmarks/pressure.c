@@ -0,0 +1,47 @@
+extern void print(int);
+extern int read();
+
+int func(int n){
+	int i;
+	int a;
+	int b;
+	int c;
+	int d;
+	int e;
+	int f;
+	int g;
+	int h;
+	int j;
+	int k;
+	int l;
+	int m;
+	i = 0;
+	a = 1;
+	b = 2;
+	c = 3;
+	d = 4;
+	e = 5;
+	f = 6;
+	g = 7;
+	h = 8;
+	j = 9;
+	k = 10;
+	l = 11;
+	m = 12;
+	while (i < n * 20){
+		a = (a + b) / 2;
+		b = (b + c) / 2 + 1;
+		c = (c + d) / 2;
+		d = (d + e) / 2 + 1;
+		e = (e + f) / 2;
+		f = (f + g) / 2 + 1;
+		g = (g + h) / 2;
+		h = (h + j) / 2 + 1;
+		j = (j + k) / 2;
+		k = (k + l) / 2 + 1;
+		l = (l + m) / 2;
+		m = (m + a) / 2 + (i - i / 8 * 8);
+		i = i + 1;
+	}
+	return a + b + c + d + e + f + g + h + j + k + l + m;
+}
@@ -0,0 +1,530 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// ============================================================================
+// BURS GENERATOR
+// ============================================================================
+// turns a tree grammar (isel.burs) into the C++ code of a bottom-up
+// rewrite-system instruction selector, in the spirit of iburg (Fraser,
+// Hanson and Proebsting, "Engineering a Simple, Efficient Code Generator
+// Generator"). run by the makefile like yacc, so the selector is compiled
+// code: a switch per operator, no table walked at run time.
+//
+//   burg isel.burs isel_burs.h isel_burs.cpp
+//
+// the grammar file:
+//
+//   %{ ... %}                 copied to the top of the .cpp
+//   %term ADD SUB ...         the operators of the trees (OP_ADD, ...)
+//   %%
+//   reg: ADD(reg, rmi)  2  { ... }
+//   %%
+//   ...                       copied to the end of the .cpp
+//
+// a rule is a nonterminal, a pattern over operators and nonterminals, a
+// cost (an integer, or a C++ expression in parentheses, apart from the
+// pattern by a space) and an action. in
+// costs and actions, `a` is the node the pattern is rooted at and @N the
+// node at its Nth leaf, counted from 1 left to right. in actions, $N is
+// what that leaf's nonterminal reduced to, $$ the rule's own result, and
+// st the isel state. a rule whose pattern is a single nonterminal is a
+// chain rule (rm: reg), applied on top of whatever else matched the node
+//
+// the generated code:
+//   burs_label(node)            cheapest cost and rule for every
+//                               nonterminal, bottom up
+//   burs_reduce(st, node, nt)   reduces the leaves of the chosen rule and
+//                               runs its action
+
+struct pattern {
+    string name;
+    bool terminal;
+    vector<pattern> kids;
+};
+
+struct rule {
+    int number;
+    string lhs;
+    pattern tree;
+    string cost;         // C++ expression
+    string action;
+    int line;
+};
+
+struct leaf {
+    string path;         // access from the root: "a->kids[1]->kids[0]"
+    string nonterminal;  // empty for a terminal leaf
+};
+
+struct grammar {
+    string prologue, epilogue;
+    vector<string> terms;
+    map<string, int> arity;
+    vector<string> nonterminals;
+    vector<rule> rules;
+};
+
+static const char *input_name;
+static int line_number = 1;
+
+static void fail(const char *message, const string &detail = "") {
+    fprintf(stderr, "%s:%d: %s%s\n", input_name, line_number, message, detail.c_str());
+    exit(1);
+}
+
+// ============================================================================
+// PARSING
+// ============================================================================
+
+struct reader {
+    string text;
+    size_t pos;
+
+    int peek() { return pos < text.size() ? text[pos] : EOF; }
+    int next() {
+        int c = peek();
+        if (c == '\n') {
+            line_number++;
+        }
+        pos++;
+        return c;
+    }
+    bool starts(const char *s) { return text.compare(pos, strlen(s), s) == 0; }
+
+    // spaces, newlines and # comments
+    void skip() {
+        while (peek() != EOF) {
+            if (isspace(peek())) {
+                next();
+            } else if (peek() == '#') {
+                while (peek() != EOF && peek() != '\n') {
+                    next();
+                }
+            } else {
+                break;
+            }
+        }
+    }
+
+    string word() {
+        skip();
+        string w;
+        while (peek() != EOF && (isalnum(peek()) || peek() == '_')) {
+            w += (char)next();
+        }
+        if (w.empty()) {
+            fail("expected a name");
+        }
+        return w;
+    }
+
+    void expect(char c) {
+        skip();
+        if (next() != c) {
+            fail("expected ", string(1, c));
+        }
+    }
+
+    // everything up to the matching close bracket, which is consumed
+    string balanced(char open, char close) {
+        string body;
+        int depth = 1;
+        while (true) {
+            int c = next();
+            if (c == EOF) {
+                fail("unterminated ", string(1, open));
+            }
+            if (c == open) {
+                depth++;
+            } else if (c == close && --depth == 0) {
+                return body;
+            }
+            body += (char)c;
+        }
+    }
+};
+
+static pattern parse_pattern(reader &in, grammar &g) {
+    pattern p;
+    p.name = in.word();
+    p.terminal = false;
+    for (const string &t : g.terms) {
+        if (t == p.name) {
+            p.terminal = true;
+        }
+    }
+    // operands follow the name right away, a cost in parentheses after a space
+    if (in.peek() == '(') {
+        if (!p.terminal) {
+            fail("only operators take operands: ", p.name);
+        }
+        in.next();
+        while (true) {
+            p.kids.push_back(parse_pattern(in, g));
+            in.skip();
+            int c = in.next();
+            if (c == ')') {
+                break;
+            }
+            if (c != ',') {
+                fail("expected , or ) in a pattern");
+            }
+        }
+    }
+    if (p.terminal) {
+        auto known = g.arity.find(p.name);
+        if (known != g.arity.end() && known->second != (int)p.kids.size()) {
+            fail("operator used with different numbers of operands: ", p.name);
+        }
+        g.arity[p.name] = p.kids.size();
+    }
+    return p;
+}
+
+static void parse(const string &text, grammar &g) {
+    reader in = { text, 0 };
+
+    in.skip();
+    if (in.starts("%{")) {
+        in.pos += 2;
+        size_t end = in.text.find("%}", in.pos);
+        if (end == string::npos) {
+            fail("unterminated %{");
+        }
+        g.prologue = in.text.substr(in.pos, end - in.pos);
+        for (size_t i = in.pos; i < end; i++) {
+            line_number += in.text[i] == '\n';
+        }
+        in.pos = end + 2;
+    }
+
+    in.skip();
+    if (!in.starts("%term")) {
+        fail("expected %term");
+    }
+    in.pos += 5;
+    while (true) {
+        in.skip();
+        if (in.starts("%%")) {
+            in.pos += 2;
+            break;
+        }
+        g.terms.push_back(in.word());
+    }
+
+    while (true) {
+        in.skip();
+        if (in.peek() == EOF) {
+            break;
+        }
+        if (in.starts("%%")) {
+            g.epilogue = in.text.substr(in.pos + 2);
+            break;
+        }
+        rule r;
+        r.number = g.rules.size() + 1;
+        r.line = line_number;
+        r.lhs = in.word();
+        in.expect(':');
+        r.tree = parse_pattern(in, g);
+
+        in.skip();
+        if (in.peek() == '(') {
+            in.next();
+            r.cost = "(" + in.balanced('(', ')') + ")";
+        } else {
+            string digits;
+            while (isdigit(in.peek())) {
+                digits += (char)in.next();
+            }
+            if (digits.empty()) {
+                fail("expected a cost");
+            }
+            r.cost = digits;
+        }
+        in.expect('{');
+        r.action = in.balanced('{', '}');
+        g.rules.push_back(r);
+
+        bool known = false;
+        for (const string &nt : g.nonterminals) {
+            known |= nt == r.lhs;
+        }
+        if (!known) {
+            g.nonterminals.push_back(r.lhs);
+        }
+    }
+
+    // every nonterminal a pattern uses has rules of its own
+    for (const rule &r : g.rules) {
+        vector<const pattern*> stack(1, &r.tree);
+        while (!stack.empty()) {
+            const pattern *p = stack.back();
+            stack.pop_back();
+            if (!p->terminal) {
+                bool defined = false;
+                for (const string &nt : g.nonterminals) {
+                    defined |= nt == p->name;
+                }
+                if (!defined) {
+                    line_number = r.line;
+                    fail("no rules for ", p->name);
+                }
+            }
+            for (const pattern &k : p->kids) {
+                stack.push_back(&k);
+            }
+        }
+    }
+}
+
+// ============================================================================
+// CODE GENERATION
+// ============================================================================
+
+// the leaves below the root (or the root itself, for a chain rule), and
+// the operator tests for the operators in between
+static void collect(const pattern &p, const string &path, bool root,
+                    vector<leaf> &leaves, vector<string> &tests) {
+    if (!p.terminal) {
+        leaves.push_back({ path, p.name });
+        return;
+    }
+    if (!root) {
+        tests.push_back(path + "->op == OP_" + p.name);
+        if (p.kids.empty()) {
+            leaves.push_back({ path, "" });
+        }
+    }
+    for (size_t i = 0; i < p.kids.size(); i++) {
+        collect(p.kids[i], path + "->kids[" + to_string(i) + "]", false, leaves, tests);
+    }
+}
+
+// $$, $N and @N in a cost or an action
+static string substitute(const string &code, const rule &r, size_t leaf_count) {
+    string out;
+    for (size_t i = 0; i < code.size(); i++) {
+        char c = code[i];
+        if ((c == '$' || c == '@') && i + 1 < code.size()) {
+            if (c == '$' && code[i + 1] == '$') {
+                out += "result";
+                i++;
+                continue;
+            }
+            size_t j = i + 1;
+            while (j < code.size() && isdigit(code[j])) {
+                j++;
+            }
+            if (j > i + 1) {
+                size_t n = atoi(code.substr(i + 1, j - i - 1).c_str());
+                if (n < 1 || n > leaf_count) {
+                    line_number = r.line;
+                    fail("no such leaf: ", code.substr(i, j - i));
+                }
+                out += (c == '$' ? "v[" : "n[") + to_string(n) + "]";
+                i = j - 1;
+                continue;
+            }
+        }
+        out += c;
+    }
+    return out;
+}
+
+static string node_array(const vector<leaf> &leaves) {
+    string s = "burs_node *n[] = { a";
+    for (const leaf &l : leaves) {
+        s += ", " + l.path;
+    }
+    return s + " };";
+}
+
+static string pattern_text(const pattern &p) {
+    string s = p.name;
+    if (!p.kids.empty()) {
+        s += "(";
+        for (size_t i = 0; i < p.kids.size(); i++) {
+            s += (i ? ", " : "") + pattern_text(p.kids[i]);
+        }
+        s += ")";
+    }
+    return s;
+}
+
+static void write_header(const grammar &g, FILE *out) {
+    fprintf(out, "// generated by burg from the tree grammar, do not edit\n");
+    fprintf(out, "#ifndef ISEL_BURS_H\n#define ISEL_BURS_H\n\n");
+    fprintf(out, "enum burs_op {\n");
+    for (const string &t : g.terms) {
+        fprintf(out, "    OP_%s,\n", t.c_str());
+    }
+    fprintf(out, "};\n\n");
+    fprintf(out, "enum burs_nonterminal {\n");
+    for (size_t i = 0; i < g.nonterminals.size(); i++) {
+        fprintf(out, "    NT_%s = %zu,\n", g.nonterminals[i].c_str(), i + 1);
+    }
+    fprintf(out, "    BURS_NT_COUNT = %zu,\n", g.nonterminals.size() + 1);
+    fprintf(out, "};\n\n");
+    int max_kids = 1;
+    for (auto &arity : g.arity) {
+        max_kids = arity.second > max_kids ? arity.second : max_kids;
+    }
+    fprintf(out, "static const int BURS_MAX_KIDS = %d;\n", max_kids);
+    fprintf(out, "static const int BURS_INFINITY = 1 << 20;\n\n");
+    fprintf(out, "#endif\n");
+}
+
+static void write_code(const grammar &g, FILE *out) {
+    fprintf(out, "// generated by burg from the tree grammar, do not edit\n");
+    fprintf(out, "%s\n", g.prologue.c_str());
+
+    fprintf(out, "static const int burs_arity[] = {");
+    for (const string &t : g.terms) {
+        auto arity = g.arity.find(t);
+        fprintf(out, " %d,", arity == g.arity.end() ? 0 : arity->second);
+    }
+    fprintf(out, " };\n\n");
+
+    // record a cost, then everything the chain rules derive from it
+    fprintf(out, "static void burs_record(burs_node *a, int nt, int cost, int rule) {\n");
+    fprintf(out, "    if (cost >= a->cost[nt]) {\n        return;\n    }\n");
+    fprintf(out, "    a->cost[nt] = cost;\n    a->rule[nt] = rule;\n");
+    fprintf(out, "    switch (nt) {\n");
+    for (const string &nt : g.nonterminals) {
+        bool any = false;
+        for (const rule &r : g.rules) {
+            if (r.tree.terminal || r.tree.name != nt) {
+                continue;
+            }
+            if (!any) {
+                fprintf(out, "    case NT_%s:\n", nt.c_str());
+                any = true;
+            }
+            fprintf(out, "        burs_record(a, NT_%s, cost + %s, %d);   // %s: %s\n",
+                    r.lhs.c_str(), substitute(r.cost, r, 0).c_str(), r.number,
+                    r.lhs.c_str(), nt.c_str());
+        }
+        if (any) {
+            fprintf(out, "        break;\n");
+        }
+    }
+    fprintf(out, "    }\n}\n\n");
+
+    fprintf(out, "void burs_label(burs_node *a) {\n");
+    fprintf(out, "    for (int i = 0; i < burs_arity[a->op]; i++) {\n");
+    fprintf(out, "        burs_label(a->kids[i]);\n    }\n");
+    fprintf(out, "    for (int nt = 0; nt < BURS_NT_COUNT; nt++) {\n");
+    fprintf(out, "        a->cost[nt] = BURS_INFINITY;\n        a->rule[nt] = 0;\n    }\n");
+    fprintf(out, "    switch (a->op) {\n");
+    for (const string &t : g.terms) {
+        bool any = false;
+        for (const rule &r : g.rules) {
+            if (!r.tree.terminal || r.tree.name != t) {
+                continue;
+            }
+            if (!any) {
+                fprintf(out, "    case OP_%s:\n", t.c_str());
+                any = true;
+            }
+            vector<leaf> leaves;
+            vector<string> tests;
+            collect(r.tree, "a", true, leaves, tests);
+            for (const leaf &l : leaves) {
+                if (!l.nonterminal.empty()) {
+                    tests.push_back(l.path + "->cost[NT_" + l.nonterminal + "] < BURS_INFINITY");
+                }
+            }
+            fprintf(out, "        // %s: %s\n", r.lhs.c_str(), pattern_text(r.tree).c_str());
+            string condition;
+            for (size_t i = 0; i < tests.size(); i++) {
+                condition += (i ? " &&\n            " : "") + tests[i];
+            }
+            fprintf(out, "        if (%s) {\n", condition.empty() ? "true" : condition.c_str());
+            fprintf(out, "            %s\n", node_array(leaves).c_str());
+            fprintf(out, "            (void)n;\n");
+            fprintf(out, "            int cost = %s;\n", substitute(r.cost, r, leaves.size()).c_str());
+            for (const leaf &l : leaves) {
+                if (!l.nonterminal.empty()) {
+                    fprintf(out, "            cost += %s->cost[NT_%s];\n", l.path.c_str(),
+                            l.nonterminal.c_str());
+                }
+            }
+            fprintf(out, "            if (cost < BURS_INFINITY) {\n");
+            fprintf(out, "                burs_record(a, NT_%s, cost, %d);\n", r.lhs.c_str(), r.number);
+            fprintf(out, "            }\n        }\n");
+        }
+        if (any) {
+            fprintf(out, "        break;\n");
+        }
+    }
+    fprintf(out, "    default:\n        break;\n    }\n}\n\n");
+
+    fprintf(out, "burs_value burs_reduce(isel_state &st, burs_node *a, int nt) {\n");
+    fprintf(out, "    burs_value result = burs_value();\n");
+    fprintf(out, "    switch (a->rule[nt]) {\n");
+    for (const rule &r : g.rules) {
+        vector<leaf> leaves;
+        vector<string> tests;
+        collect(r.tree, "a", true, leaves, tests);
+        fprintf(out, "    case %d: {   // %s: %s\n", r.number, r.lhs.c_str(), pattern_text(r.tree).c_str());
+        fprintf(out, "        %s\n", node_array(leaves).c_str());
+        fprintf(out, "        burs_value v[%zu];\n", leaves.size() + 1);
+        fprintf(out, "        (void)n;\n        (void)v;\n");
+        for (size_t i = 0; i < leaves.size(); i++) {
+            if (!leaves[i].nonterminal.empty()) {
+                fprintf(out, "        v[%zu] = burs_reduce(st, n[%zu], NT_%s);\n", i + 1, i + 1,
+                        leaves[i].nonterminal.c_str());
+            }
+        }
+        fprintf(out, "        {%s}\n", substitute(r.action, r, leaves.size()).c_str());
+        fprintf(out, "        break;\n    }\n");
+    }
+    fprintf(out, "    default:\n        burs_no_cover(st, a, nt);\n        break;\n");
+    fprintf(out, "    }\n    return result;\n}\n");
+
+    fprintf(out, "%s", g.epilogue.c_str());
+}
+
+int main(int argc, char **argv) {
+    if (argc != 4) {
+        fprintf(stderr, "usage: %s <grammar.burs> <out.h> <out.cpp>\n", argv[0]);
+        return 1;
+    }
+    input_name = argv[1];
+    FILE *in = fopen(argv[1], "r");
+    if (!in) {
+        fprintf(stderr, "cannot open file: %s\n", argv[1]);
+        return 1;
+    }
+    string text;
+    char buffer[4096];
+    size_t got;
+    while ((got = fread(buffer, 1, sizeof(buffer), in)) > 0) {
+        text.append(buffer, got);
+    }
+    fclose(in);
+
+    grammar g;
+    parse(text, g);
+
+    FILE *header = fopen(argv[2], "w");
+    FILE *code = fopen(argv[3], "w");
+    if (!header || !code) {
+        fprintf(stderr, "cannot write the generated files\n");
+        return 1;
+    }
+    write_header(g, header);
+    write_code(g, code);
+    fclose(header);
+    fclose(code);
+    return 0;
+}
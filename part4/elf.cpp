@@ -0,0 +1,201 @@
+#include "backend.h"
+
+#include <elf.h>
+#include <string.h>
+
+#include <unordered_map>
+
+using namespace std;
+
+// ============================================================================
+// OBJECT FILES
+// ============================================================================
+// an ELF64 relocatable object, the one `as` would write for the assembly
+// minus what nothing reads:
+//
+//   .text             the functions, each 16-byte aligned
+//   .rela.text        R_X86_64_PLT32 for every call (print, read)
+//   .note.GNU-stack   empty: the stack need not be executable
+//   .symtab           the file, then the functions (global, sized) and
+//                     the functions they call that the module only declares
+//   .strtab, .shstrtab
+//
+// the system linker (gcc x.o main.c) resolves the calls
+
+// names, each followed by a NUL, the offset of each one into the table
+struct string_table {
+    string bytes;
+
+    string_table() : bytes(1, '\0') {}
+
+    Elf64_Word add(const string &name) {
+        Elf64_Word offset = bytes.size();
+        bytes += name;
+        bytes += '\0';
+        return offset;
+    }
+};
+
+enum {
+    SECTION_NULL,
+    SECTION_TEXT,
+    SECTION_RELA_TEXT,
+    SECTION_NOTE_GNU_STACK,
+    SECTION_SYMTAB,
+    SECTION_STRTAB,
+    SECTION_SHSTRTAB,
+    SECTION_COUNT,
+};
+
+static Elf64_Sym symbol(Elf64_Word name, unsigned char binding, unsigned char type,
+                        Elf64_Section section, Elf64_Addr value, Elf64_Xword size) {
+    Elf64_Sym sym;
+    memset(&sym, 0, sizeof(sym));
+    sym.st_name = name;
+    sym.st_info = ELF64_ST_INFO(binding, type);
+    sym.st_shndx = section;
+    sym.st_value = value;
+    sym.st_size = size;
+    return sym;
+}
+
+static Elf64_Shdr section(Elf64_Word name, Elf64_Word type, Elf64_Xword flags, Elf64_Off offset,
+                          Elf64_Xword size, Elf64_Xword align) {
+    Elf64_Shdr shdr;
+    memset(&shdr, 0, sizeof(shdr));
+    shdr.sh_name = name;
+    shdr.sh_type = type;
+    shdr.sh_flags = flags;
+    shdr.sh_offset = offset;
+    shdr.sh_size = size;
+    shdr.sh_addralign = align;
+    return shdr;
+}
+
+// the file's bytes: the header, the contents of the sections at their
+// alignment, then the section headers
+static string object_file(const machine_code &code, const string &source) {
+    string_table strtab, shstrtab;
+
+    vector<Elf64_Sym> symbols;
+    symbols.push_back(symbol(0, 0, 0, SHN_UNDEF, 0, 0));
+    symbols.push_back(symbol(strtab.add(source), STB_LOCAL, STT_FILE, SHN_ABS, 0, 0));
+    Elf64_Word first_global = symbols.size();
+
+    unordered_map<string, Elf64_Word> index;
+    for (const code_symbol &f : code.functions) {
+        index[f.name] = symbols.size();
+        symbols.push_back(symbol(strtab.add(f.name), STB_GLOBAL, STT_FUNC, SECTION_TEXT,
+                                 f.offset, f.size));
+    }
+    vector<Elf64_Rela> relocations;
+    for (const code_relocation &call : code.calls) {
+        if (!index.count(call.symbol)) {
+            index[call.symbol] = symbols.size();
+            symbols.push_back(symbol(strtab.add(call.symbol), STB_GLOBAL, STT_NOTYPE,
+                                     SHN_UNDEF, 0, 0));
+        }
+        Elf64_Rela rela;
+        rela.r_offset = call.offset;
+        rela.r_info = ELF64_R_INFO(index[call.symbol], R_X86_64_PLT32);
+        rela.r_addend = -4;
+        relocations.push_back(rela);
+    }
+
+    Elf64_Word names[SECTION_COUNT];
+    names[SECTION_NULL] = 0;
+    names[SECTION_TEXT] = shstrtab.add(".text");
+    names[SECTION_RELA_TEXT] = shstrtab.add(".rela.text");
+    names[SECTION_NOTE_GNU_STACK] = shstrtab.add(".note.GNU-stack");
+    names[SECTION_SYMTAB] = shstrtab.add(".symtab");
+    names[SECTION_STRTAB] = shstrtab.add(".strtab");
+    names[SECTION_SHSTRTAB] = shstrtab.add(".shstrtab");
+
+    string file(sizeof(Elf64_Ehdr), '\0');
+    auto place = [&](const void *data, size_t size, size_t align) {
+        while (file.size() % align != 0) {
+            file += '\0';
+        }
+        size_t offset = file.size();
+        file.append((const char*)data, size);
+        return offset;
+    };
+
+    Elf64_Shdr headers[SECTION_COUNT];
+    headers[SECTION_NULL] = section(0, SHT_NULL, 0, 0, 0, 0);
+    headers[SECTION_TEXT] = section(names[SECTION_TEXT], SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR,
+                                    place(code.text.data(), code.text.size(), 16),
+                                    code.text.size(), 16);
+    size_t rela_size = relocations.size() * sizeof(Elf64_Rela);
+    headers[SECTION_RELA_TEXT] = section(names[SECTION_RELA_TEXT], SHT_RELA, SHF_INFO_LINK,
+                                         place(relocations.data(), rela_size, 8), rela_size, 8);
+    headers[SECTION_RELA_TEXT].sh_link = SECTION_SYMTAB;
+    headers[SECTION_RELA_TEXT].sh_info = SECTION_TEXT;
+    headers[SECTION_RELA_TEXT].sh_entsize = sizeof(Elf64_Rela);
+    headers[SECTION_NOTE_GNU_STACK] = section(names[SECTION_NOTE_GNU_STACK], SHT_PROGBITS, 0,
+                                              file.size(), 0, 1);
+    size_t symtab_size = symbols.size() * sizeof(Elf64_Sym);
+    headers[SECTION_SYMTAB] = section(names[SECTION_SYMTAB], SHT_SYMTAB, 0,
+                                      place(symbols.data(), symtab_size, 8), symtab_size, 8);
+    headers[SECTION_SYMTAB].sh_link = SECTION_STRTAB;
+    headers[SECTION_SYMTAB].sh_info = first_global;
+    headers[SECTION_SYMTAB].sh_entsize = sizeof(Elf64_Sym);
+    headers[SECTION_STRTAB] = section(names[SECTION_STRTAB], SHT_STRTAB, 0,
+                                      place(strtab.bytes.data(), strtab.bytes.size(), 1),
+                                      strtab.bytes.size(), 1);
+    headers[SECTION_SHSTRTAB] = section(names[SECTION_SHSTRTAB], SHT_STRTAB, 0,
+                                        place(shstrtab.bytes.data(), shstrtab.bytes.size(), 1),
+                                        shstrtab.bytes.size(), 1);
+    size_t section_headers = place(headers, sizeof(headers), 8);
+
+    Elf64_Ehdr ehdr;
+    memset(&ehdr, 0, sizeof(ehdr));
+    memcpy(ehdr.e_ident, ELFMAG, SELFMAG);
+    ehdr.e_ident[EI_CLASS] = ELFCLASS64;
+    ehdr.e_ident[EI_DATA] = ELFDATA2LSB;
+    ehdr.e_ident[EI_VERSION] = EV_CURRENT;
+    ehdr.e_ident[EI_OSABI] = ELFOSABI_SYSV;
+    ehdr.e_type = ET_REL;
+    ehdr.e_machine = EM_X86_64;
+    ehdr.e_version = EV_CURRENT;
+    ehdr.e_shoff = section_headers;
+    ehdr.e_ehsize = sizeof(Elf64_Ehdr);
+    ehdr.e_shentsize = sizeof(Elf64_Shdr);
+    ehdr.e_shnum = SECTION_COUNT;
+    ehdr.e_shstrndx = SECTION_SHSTRTAB;
+    file.replace(0, sizeof(ehdr), (const char*)&ehdr, sizeof(ehdr));
+    return file;
+}
+
+bool write_object(LLVMModuleRef module, const char *path) {
+    machine_code code;
+    for (LLVMValueRef function = LLVMGetFirstFunction(module); function != NULL;
+         function = LLVMGetNextFunction(function)) {
+        if (LLVMIsDeclaration(function)) {
+            continue;
+        }
+        machine_function mf;
+        if (!select_instructions(function, &mf)) {
+            return false;
+        }
+        allocate_registers(&mf);
+        peephole(&mf);
+        encode_function(mf, &code);
+    }
+
+    size_t length;
+    const char *source = LLVMGetSourceFileName(module, &length);
+    string file = object_file(code, string(source, length));
+
+    FILE *out = fopen(path, "wb");
+    if (out == NULL) {
+        fprintf(stderr, "error: cannot write '%s'\n", path);
+        return false;
+    }
+    bool ok = fwrite(file.data(), 1, file.size(), out) == file.size();
+    if (fclose(out) != 0 || !ok) {
+        fprintf(stderr, "error: cannot write '%s'\n", path);
+        return false;
+    }
+    return true;
+}
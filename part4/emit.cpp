@@ -0,0 +1,255 @@
+#include "backend.h"
+#include <stdio.h>
+
+using namespace std;
+
+// ============================================================================
+// ASSEMBLY OUTPUT
+// ============================================================================
+// AT&T syntax, operands the other way round from the machine code
+// (`addl %esi, %ebx` is ebx += esi). the frame is %rbp based:
+//
+//   8(%rbp)         return address
+//   0(%rbp)         caller's %rbp
+//   -8(%rbp) ...    callee-saved registers the function uses
+//   below them      8-byte slots: allocas, then spilled registers
+//
+// a jmp to the block right after is left out, and calls go through the PLT
+// so the object links into a position independent executable
+
+static const char *register_names[16][3] = {
+    { "al", "eax", "rax" },     { "cl", "ecx", "rcx" },
+    { "dl", "edx", "rdx" },     { "bl", "ebx", "rbx" },
+    { "spl", "esp", "rsp" },    { "bpl", "ebp", "rbp" },
+    { "sil", "esi", "rsi" },    { "dil", "edi", "rdi" },
+    { "r8b", "r8d", "r8" },     { "r9b", "r9d", "r9" },
+    { "r10b", "r10d", "r10" },  { "r11b", "r11d", "r11" },
+    { "r12b", "r12d", "r12" },  { "r13b", "r13d", "r13" },
+    { "r14b", "r14d", "r14" },  { "r15b", "r15d", "r15" },
+};
+
+static const char *condition_name(int cond) {
+    switch (cond) {
+    case CC_B:  return "b";
+    case CC_AE: return "ae";
+    case CC_E:  return "e";
+    case CC_NE: return "ne";
+    case CC_BE: return "be";
+    case CC_A:  return "a";
+    case CC_L:  return "l";
+    case CC_GE: return "ge";
+    case CC_LE: return "le";
+    default:    return "g";
+    }
+}
+
+static char suffix(int width) {
+    return width == 8 ? 'b' : width == 32 ? 'l' : 'q';
+}
+
+int slot_offset(const machine_function &mf, long long slot) {
+    return -8 * (int)(mf.saved_registers.size() + slot + 1);
+}
+
+static void print_operand(const machine_function &mf, machine_operand op, int width, FILE *out) {
+    switch (op.kind) {
+    case OPND_REG:
+        fprintf(out, "%%%s", register_names[op.value][width == 8 ? 0 : width == 32 ? 1 : 2]);
+        break;
+    case OPND_IMM:
+        fprintf(out, "$%lld", op.value);
+        break;
+    case OPND_SLOT:
+        fprintf(out, "%d(%%rbp)", slot_offset(mf, op.value));
+        break;
+    default:
+        fprintf(out, "?");
+        break;
+    }
+}
+
+// `mnemonic src, dst` with both at the instruction's width
+static void print_two(const machine_function &mf, const char *mnemonic, const machine_instr &mi,
+                      int src_width, int dst_width, FILE *out) {
+    fprintf(out, "\t%s\t", mnemonic);
+    print_operand(mf, mi.src, src_width, out);
+    fprintf(out, ", ");
+    print_operand(mf, mi.dst, dst_width, out);
+    fprintf(out, "\n");
+}
+
+static void print_epilogue(const machine_function &mf, FILE *out) {
+    if (mf.saved_registers.empty()) {
+        fprintf(out, "\tleave\n");
+    } else {
+        fprintf(out, "\tleaq\t%d(%%rbp), %%rsp\n", -8 * (int)mf.saved_registers.size());
+        for (size_t i = mf.saved_registers.size(); i-- > 0;) {
+            fprintf(out, "\tpopq\t%%%s\n", register_names[mf.saved_registers[i]][2]);
+        }
+        fprintf(out, "\tpopq\t%%rbp\n");
+    }
+    fprintf(out, "\tret\n");
+}
+
+static void print_instr(const machine_function &mf, int index, const machine_instr &mi,
+                        int next_label, FILE *out) {
+    static const char *alu[] = { "add", "sub", "imul", "and", "or", "xor", "shl", "sar", "shr" };
+    char mnemonic[16];
+    switch (mi.op) {
+    case MI_MOV:
+    case MI_MOVZL:
+    case MI_ADD:
+    case MI_SUB:
+    case MI_IMUL:
+    case MI_AND:
+    case MI_OR:
+    case MI_XOR:
+    case MI_CMP:
+    case MI_TEST: {
+        const char *name = mi.op == MI_MOV || mi.op == MI_MOVZL ? "mov" : mi.op == MI_CMP ? "cmp"
+                         : mi.op == MI_TEST ? "test" : alu[mi.op - MI_ADD];
+        snprintf(mnemonic, sizeof(mnemonic), "%s%c", name, suffix(mi.width));
+        print_two(mf, mnemonic, mi, mi.width, mi.width, out);
+        break;
+    }
+    case MI_SHL:
+    case MI_SAR:
+    case MI_SHR:
+        snprintf(mnemonic, sizeof(mnemonic), "%s%c", alu[mi.op - MI_ADD], suffix(mi.width));
+        print_two(mf, mnemonic, mi, 8, mi.width, out);
+        break;
+    case MI_MOVABS:
+        print_two(mf, "movabsq", mi, 64, 64, out);
+        break;
+    case MI_MOVSX:
+        print_two(mf, "movslq", mi, 32, 64, out);
+        break;
+    case MI_MOVZB:
+        print_two(mf, "movzbl", mi, 8, 32, out);
+        break;
+    case MI_LEA:
+        fprintf(out, "\tlea%c\t", suffix(mi.width));
+        if (mi.disp != 0 || mi.src.kind == OPND_NONE) {
+            fprintf(out, "%lld", mi.disp);
+        }
+        fprintf(out, "(");
+        if (mi.src.kind != OPND_NONE) {
+            print_operand(mf, mi.src, 64, out);
+        }
+        if (mi.index.kind != OPND_NONE) {
+            fprintf(out, ",");
+            print_operand(mf, mi.index, 64, out);
+            fprintf(out, ",%d", mi.scale);
+        }
+        fprintf(out, "), ");
+        print_operand(mf, mi.dst, mi.width, out);
+        fprintf(out, "\n");
+        break;
+    case MI_NEG:
+        fprintf(out, "\tneg%c\t", suffix(mi.width));
+        print_operand(mf, mi.dst, mi.width, out);
+        fprintf(out, "\n");
+        break;
+    case MI_SETCC:
+        fprintf(out, "\tset%s\t", condition_name(mi.cond));
+        print_operand(mf, mi.dst, 8, out);
+        fprintf(out, "\n");
+        break;
+    case MI_CMOV:
+        snprintf(mnemonic, sizeof(mnemonic), "cmov%s%c", condition_name(mi.cond), suffix(mi.width));
+        print_two(mf, mnemonic, mi, mi.width, mi.width, out);
+        break;
+    case MI_CDQ:
+        fprintf(out, mi.width == 64 ? "\tcqto\n" : "\tcltd\n");
+        break;
+    case MI_IDIV:
+        fprintf(out, "\tidiv%c\t", suffix(mi.width));
+        print_operand(mf, mi.src, mi.width, out);
+        fprintf(out, "\n");
+        break;
+    case MI_JCC:
+        fprintf(out, "\tj%s\t.L%d_%d\n", condition_name(mi.cond), index, mi.target);
+        break;
+    case MI_JMP:
+        if (mi.target != next_label) {
+            fprintf(out, "\tjmp\t.L%d_%d\n", index, mi.target);
+        }
+        break;
+    case MI_CALL:
+        fprintf(out, "\tcall\t%s@PLT\n", mi.symbol.c_str());
+        break;
+    case MI_RET:
+        print_epilogue(mf, out);
+        break;
+    case MI_UD2:
+        fprintf(out, "\tud2\n");
+        break;
+    }
+}
+
+void print_function(const machine_function &mf, int index, FILE *out) {
+    const char *name = mf.name.c_str();
+    fprintf(out, "\t.globl\t%s\n", name);
+    fprintf(out, "\t.p2align\t4, 0x90\n");
+    fprintf(out, "\t.type\t%s,@function\n", name);
+    fprintf(out, "%s:\n", name);
+
+    fprintf(out, "\tpushq\t%%rbp\n");
+    fprintf(out, "\tmovq\t%%rsp, %%rbp\n");
+    for (int reg : mf.saved_registers) {
+        fprintf(out, "\tpushq\t%%%s\n", register_names[reg][2]);
+    }
+    if (mf.frame_size > 0) {
+        fprintf(out, "\tsubq\t$%d, %%rsp\n", mf.frame_size);
+    }
+
+    for (size_t b = 0; b < mf.blocks.size(); b++) {
+        const machine_block &block = mf.blocks[b];
+        if (b > 0) {
+            fprintf(out, ".L%d_%d:\n", index, block.label);
+        }
+        int next_label = b + 1 < mf.blocks.size() ? mf.blocks[b + 1].label : -1;
+        for (const machine_instr &mi : block.instrs) {
+            print_instr(mf, index, mi, next_label, out);
+        }
+    }
+    fprintf(out, ".Lend%d:\n", index);
+    fprintf(out, "\t.size\t%s, .Lend%d-%s\n\n", name, index, name);
+}
+
+bool write_assembly(LLVMModuleRef module, const char *path) {
+    FILE *out = fopen(path, "w");
+    if (out == NULL) {
+        fprintf(stderr, "error: cannot write '%s'\n", path);
+        return false;
+    }
+
+    size_t length;
+    const char *source = LLVMGetSourceFileName(module, &length);
+    fprintf(out, "\t.text\n");
+    fprintf(out, "\t.file\t\"%.*s\"\n", (int)length, source);
+
+    bool ok = true;
+    int index = 0;
+    for (LLVMValueRef function = LLVMGetFirstFunction(module); function != NULL;
+         function = LLVMGetNextFunction(function)) {
+        if (LLVMIsDeclaration(function)) {
+            continue;
+        }
+        machine_function mf;
+        if (!select_instructions(function, &mf)) {
+            ok = false;
+            break;
+        }
+        allocate_registers(&mf);
+        peephole(&mf);
+        print_function(mf, index++, out);
+    }
+    fprintf(out, "\t.section\t.note.GNU-stack,\"\",@progbits\n");
+
+    if (fclose(out) != 0) {
+        fprintf(stderr, "error: cannot write '%s'\n", path);
+        ok = false;
+    }
+    return ok;
+}
@@ -0,0 +1,479 @@
+#include "backend.h"
+
+using namespace std;
+
+// ============================================================================
+// MACHINE CODE
+// ============================================================================
+// x86-64 encoding of the allocated machine code, laid out like emit.cpp
+// prints it and encoded the way `as` encodes that assembly: the same choice
+// between forms (8-bit immediates when they fit, the short forms for %eax
+// and for shifts by 1), so `objdump -d` of both objects reads the same.
+//
+//   [REX] opcode [ModRM [SIB] [disp]] [immediate]
+//
+// jumps are relaxed like `as` does it: every one starts out short (rel8),
+// and the ones whose target turns out to be too far get a rel32, again
+// until no more change. a call leaves a zero rel32 with a relocation for
+// the linker, like `call print@PLT`
+
+typedef vector<unsigned char> bytes_t;
+
+// the r/m side of an instruction: a register, or memory at
+// base + index * scale + disp (base or index -1 for none)
+struct rm_operand {
+    bool is_register;
+    int reg;
+    int base, index, scale;
+    long long disp;
+};
+
+static rm_operand register_rm(int reg) {
+    rm_operand rm = { true, reg, -1, -1, 1, 0 };
+    return rm;
+}
+
+static rm_operand memory_rm(int base, int index, int scale, long long disp) {
+    rm_operand rm = { false, 0, base, index, scale, disp };
+    return rm;
+}
+
+static rm_operand rm_of(const machine_function &mf, machine_operand op) {
+    if (op.kind == OPND_SLOT) {
+        return memory_rm(REG_RBP, -1, 1, slot_offset(mf, op.value));
+    }
+    return register_rm((int)op.value);
+}
+
+static bool fits8(long long value) {
+    return value == (long long)(signed char)value;
+}
+
+static void put32(bytes_t &out, long long value) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back((unsigned char)(value >> (8 * i)));
+    }
+}
+
+static void put64(bytes_t &out, long long value) {
+    for (int i = 0; i < 8; i++) {
+        out.push_back((unsigned char)(value >> (8 * i)));
+    }
+}
+
+// %spl, %bpl, %sil and %dil need a REX prefix, or they would be %ah..%bh
+static bool needs_rex_for_byte(int reg) {
+    return reg >= 4 && reg <= 7;
+}
+
+// an instruction with a ModRM byte: reg is the register in its reg field,
+// or the opcode extension (/0../7). byte_reg and byte_rm say which side
+// is an 8-bit register
+static void encode_modrm(bytes_t &out, bool wide, const unsigned char *opcode, int opcode_length,
+                         int reg, const rm_operand &rm, bool byte_reg = false, bool byte_rm = false) {
+    int rex = (wide ? 8 : 0) | (reg >= 8 ? 4 : 0);
+    if (rm.is_register) {
+        rex |= rm.reg >= 8 ? 1 : 0;
+    } else {
+        rex |= (rm.index >= 8 ? 2 : 0) | (rm.base >= 8 ? 1 : 0);
+    }
+    bool byte_rex = (byte_reg && needs_rex_for_byte(reg)) ||
+                    (byte_rm && rm.is_register && needs_rex_for_byte(rm.reg));
+    if (rex != 0 || byte_rex) {
+        out.push_back(0x40 | rex);
+    }
+    out.insert(out.end(), opcode, opcode + opcode_length);
+
+    if (rm.is_register) {
+        out.push_back(0xc0 | (reg & 7) << 3 | (rm.reg & 7));
+        return;
+    }
+    if (rm.base < 0) {
+        // no base: SIB with base 101 and a 32-bit displacement
+        int index = rm.index < 0 ? 4 : rm.index & 7;
+        out.push_back(0x04 | (reg & 7) << 3);
+        out.push_back((__builtin_ctz(rm.scale) << 6) | index << 3 | 5);
+        put32(out, rm.disp);
+        return;
+    }
+    // %rbp and %r13 as a base always take a displacement
+    int mod = rm.disp == 0 && (rm.base & 7) != 5 ? 0 : fits8(rm.disp) ? 1 : 2;
+    if (rm.index >= 0 || (rm.base & 7) == 4) {
+        int index = rm.index < 0 ? 4 : rm.index & 7;
+        out.push_back(mod << 6 | (reg & 7) << 3 | 4);
+        out.push_back((__builtin_ctz(rm.scale) << 6) | index << 3 | (rm.base & 7));
+    } else {
+        out.push_back(mod << 6 | (reg & 7) << 3 | (rm.base & 7));
+    }
+    if (mod == 1) {
+        out.push_back((unsigned char)rm.disp);
+    } else if (mod == 2) {
+        put32(out, rm.disp);
+    }
+}
+
+static void encode_modrm(bytes_t &out, bool wide, unsigned char opcode, int reg,
+                         const rm_operand &rm, bool byte_reg = false, bool byte_rm = false) {
+    encode_modrm(out, wide, &opcode, 1, reg, rm, byte_reg, byte_rm);
+}
+
+static void encode_two_byte(bytes_t &out, bool wide, unsigned char opcode, int reg,
+                            const rm_operand &rm, bool byte_reg = false, bool byte_rm = false) {
+    unsigned char two[] = { 0x0f, opcode };
+    encode_modrm(out, wide, two, 2, reg, rm, byte_reg, byte_rm);
+}
+
+// an opcode with the register in its low 3 bits (push, pop, mov $imm)
+static void encode_short(bytes_t &out, bool wide, unsigned char opcode, int reg) {
+    int rex = (wide ? 8 : 0) | (reg >= 8 ? 1 : 0);
+    if (rex != 0) {
+        out.push_back(0x40 | rex);
+    }
+    out.push_back(opcode + (reg & 7));
+}
+
+// ============================================================================
+// INSTRUCTIONS
+// ============================================================================
+
+static void encode_epilogue(const machine_function &mf, bytes_t &out) {
+    if (mf.saved_registers.empty()) {
+        out.push_back(0xc9);                                         // leave
+    } else {
+        long long below = -8 * (long long)mf.saved_registers.size();
+        encode_modrm(out, true, 0x8d, REG_RSP, memory_rm(REG_RBP, -1, 1, below));
+        for (size_t i = mf.saved_registers.size(); i-- > 0;) {
+            encode_short(out, false, 0x58, mf.saved_registers[i]);  // pop
+        }
+        out.push_back(0x5d);                                         // pop %rbp
+    }
+    out.push_back(0xc3);
+}
+
+// add, or, and, sub, xor and cmp: the /digit of their 0x80-0x83 forms,
+// and 8 times it is the base of the others
+static int alu_extension(machine_opcode op) {
+    switch (op) {
+    case MI_ADD: return 0;
+    case MI_OR:  return 1;
+    case MI_AND: return 4;
+    case MI_SUB: return 5;
+    case MI_XOR: return 6;
+    default:     return 7;   // MI_CMP
+    }
+}
+
+static int shift_extension(machine_opcode op) {
+    return op == MI_SHL ? 4 : op == MI_SHR ? 5 : 7;
+}
+
+// everything but jumps and calls
+static void encode_instr(const machine_function &mf, const machine_instr &mi, bytes_t &out) {
+    bool wide = mi.width == 64;
+    rm_operand dst = rm_of(mf, mi.dst);
+    rm_operand src = rm_of(mf, mi.src);
+
+    switch (mi.op) {
+    case MI_MOV:
+    case MI_MOVZL:
+        if (mi.src.kind == OPND_IMM) {
+            if (mi.dst.kind == OPND_REG && !wide) {
+                encode_short(out, false, 0xb8, (int)mi.dst.value);
+            } else {
+                encode_modrm(out, wide, 0xc7, 0, dst);
+            }
+            put32(out, mi.src.value);
+        } else if (mi.src.kind == OPND_REG) {
+            encode_modrm(out, wide, 0x89, (int)mi.src.value, dst);
+        } else {
+            encode_modrm(out, wide, 0x8b, (int)mi.dst.value, src);
+        }
+        break;
+
+    case MI_MOVABS:
+        encode_short(out, true, 0xb8, (int)mi.dst.value);
+        put64(out, mi.src.value);
+        break;
+
+    case MI_MOVSX:
+        encode_modrm(out, true, 0x63, (int)mi.dst.value, src);
+        break;
+
+    case MI_MOVZB:
+        encode_two_byte(out, false, 0xb6, (int)mi.dst.value, src, false, true);
+        break;
+
+    case MI_LEA: {
+        int base = mi.src.kind == OPND_NONE ? -1 : (int)mi.src.value;
+        int index = mi.index.kind == OPND_NONE ? -1 : (int)mi.index.value;
+        encode_modrm(out, wide, 0x8d, (int)mi.dst.value, memory_rm(base, index, mi.scale, mi.disp));
+        break;
+    }
+
+    case MI_ADD:
+    case MI_OR:
+    case MI_AND:
+    case MI_SUB:
+    case MI_XOR:
+    case MI_CMP: {
+        int ext = alu_extension(mi.op);
+        if (mi.src.kind == OPND_IMM) {
+            if (fits8(mi.src.value)) {
+                encode_modrm(out, wide, 0x83, ext, dst);
+                out.push_back((unsigned char)mi.src.value);
+                break;
+            }
+            if (mi.dst.kind == OPND_REG && mi.dst.value == REG_RAX) {
+                if (wide) {
+                    out.push_back(0x48);
+                }
+                out.push_back(ext * 8 + 5);
+            } else {
+                encode_modrm(out, wide, 0x81, ext, dst);
+            }
+            put32(out, mi.src.value);
+        } else if (mi.src.kind == OPND_REG) {
+            encode_modrm(out, wide, ext * 8 + 1, (int)mi.src.value, dst);
+        } else {
+            encode_modrm(out, wide, ext * 8 + 3, (int)mi.dst.value, src);
+        }
+        break;
+    }
+
+    case MI_TEST:
+        if (mi.src.kind == OPND_IMM) {
+            if (mi.dst.kind == OPND_REG && mi.dst.value == REG_RAX) {
+                if (wide) {
+                    out.push_back(0x48);
+                }
+                out.push_back(0xa9);
+            } else {
+                encode_modrm(out, wide, 0xf7, 0, dst);
+            }
+            put32(out, mi.src.value);
+        } else if (mi.src.kind == OPND_REG) {
+            encode_modrm(out, wide, 0x85, (int)mi.src.value, dst);
+        } else {
+            encode_modrm(out, wide, 0x85, (int)mi.dst.value, src);
+        }
+        break;
+
+    case MI_IMUL:
+        if (mi.src.kind == OPND_IMM) {
+            bool short_imm = fits8(mi.src.value);
+            encode_modrm(out, wide, short_imm ? 0x6b : 0x69, (int)mi.dst.value, dst);
+            if (short_imm) {
+                out.push_back((unsigned char)mi.src.value);
+            } else {
+                put32(out, mi.src.value);
+            }
+        } else {
+            encode_two_byte(out, wide, 0xaf, (int)mi.dst.value, src);
+        }
+        break;
+
+    case MI_SHL:
+    case MI_SAR:
+    case MI_SHR: {
+        int ext = shift_extension(mi.op);
+        if (mi.src.kind != OPND_IMM) {
+            encode_modrm(out, wide, 0xd3, ext, dst);                 // by %cl
+        } else if (mi.src.value == 1) {
+            encode_modrm(out, wide, 0xd1, ext, dst);
+        } else {
+            encode_modrm(out, wide, 0xc1, ext, dst);
+            out.push_back((unsigned char)mi.src.value);
+        }
+        break;
+    }
+
+    case MI_NEG:
+        encode_modrm(out, wide, 0xf7, 3, dst);
+        break;
+
+    case MI_SETCC:
+        encode_two_byte(out, false, 0x90 + mi.cond, 0, dst, false, true);
+        break;
+
+    case MI_CMOV:
+        encode_two_byte(out, wide, 0x40 + mi.cond, (int)mi.dst.value, src);
+        break;
+
+    case MI_CDQ:
+        if (wide) {
+            out.push_back(0x48);
+        }
+        out.push_back(0x99);
+        break;
+
+    case MI_IDIV:
+        encode_modrm(out, wide, 0xf7, 7, src);
+        break;
+
+    case MI_RET:
+        encode_epilogue(mf, out);
+        break;
+
+    case MI_UD2:
+        out.push_back(0x0f);
+        out.push_back(0x0b);
+        break;
+
+    case MI_JCC:
+    case MI_JMP:
+    case MI_CALL:
+        break;
+    }
+}
+
+// ============================================================================
+// LAYOUT
+// ============================================================================
+
+// a run of the function's bytes: the code of one instruction, a jump whose
+// size is still open, or the start of a block
+struct fragment {
+    bytes_t code;
+    int label;           // a block starts here, -1 otherwise
+    bool jump;
+    int cond;            // of a jcc, -1 for jmp
+    int target;
+    bool is_long;
+    size_t offset;       // from the start of the function
+    std::string call;    // a call: code is its opcode and a zero rel32
+};
+
+static fragment new_fragment() {
+    fragment f;
+    f.label = -1;
+    f.jump = false;
+    f.cond = -1;
+    f.target = -1;
+    f.is_long = false;
+    f.offset = 0;
+    return f;
+}
+
+static size_t fragment_size(const fragment &f) {
+    if (f.jump) {
+        return !f.is_long ? 2 : f.cond < 0 ? 5 : 6;
+    }
+    return f.code.size();
+}
+
+void encode_function(const machine_function &mf, machine_code *code) {
+    // .p2align 4, 0x90
+    while (code->text.size() % 16 != 0) {
+        code->text.push_back(0x90);
+    }
+
+    vector<fragment> fragments;
+    fragment prologue = new_fragment();
+    bytes_t &p = prologue.code;
+    p.push_back(0x55);                                                // push %rbp
+    encode_modrm(p, true, 0x89, REG_RSP, register_rm(REG_RBP));      // mov %rsp, %rbp
+    for (int reg : mf.saved_registers) {
+        encode_short(p, false, 0x50, reg);
+    }
+    if (mf.frame_size > 0) {
+        bool short_imm = fits8(mf.frame_size);
+        encode_modrm(p, true, short_imm ? 0x83 : 0x81, 5, register_rm(REG_RSP));
+        if (short_imm) {
+            p.push_back((unsigned char)mf.frame_size);
+        } else {
+            put32(p, mf.frame_size);
+        }
+    }
+    fragments.push_back(prologue);
+
+    for (size_t b = 0; b < mf.blocks.size(); b++) {
+        const machine_block &block = mf.blocks[b];
+        fragment start = new_fragment();
+        start.label = block.label;
+        fragments.push_back(start);
+        int next_label = b + 1 < mf.blocks.size() ? mf.blocks[b + 1].label : -1;
+
+        for (const machine_instr &mi : block.instrs) {
+            fragment f = new_fragment();
+            if (mi.op == MI_JCC || mi.op == MI_JMP) {
+                if (mi.op == MI_JMP && mi.target == next_label) {
+                    continue;
+                }
+                f.jump = true;
+                f.cond = mi.op == MI_JCC ? mi.cond : -1;
+                f.target = mi.target;
+            } else if (mi.op == MI_CALL) {
+                f.code.push_back(0xe8);
+                put32(f.code, 0);
+                f.call = mi.symbol;
+            } else {
+                encode_instr(mf, mi, f.code);
+            }
+            // runs of plain instructions share a fragment
+            if (!f.jump && f.call.empty() && !fragments.back().jump &&
+                fragments.back().call.empty() && fragments.back().label < 0) {
+                bytes_t &last = fragments.back().code;
+                last.insert(last.end(), f.code.begin(), f.code.end());
+            } else {
+                fragments.push_back(f);
+            }
+        }
+    }
+
+    // relaxation: lay out, lengthen the jumps that don't reach, repeat
+    vector<size_t> label_offset(1, 0);
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        size_t offset = 0;
+        for (fragment &f : fragments) {
+            f.offset = offset;
+            if (f.label >= 0) {
+                if ((size_t)f.label >= label_offset.size()) {
+                    label_offset.resize(f.label + 1);
+                }
+                label_offset[f.label] = offset;
+            }
+            offset += fragment_size(f);
+        }
+        for (fragment &f : fragments) {
+            if (f.jump && !f.is_long) {
+                long long disp = (long long)label_offset[f.target] - (long long)(f.offset + 2);
+                if (!fits8(disp)) {
+                    f.is_long = true;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    size_t start = code->text.size();
+    bytes_t &text = code->text;
+    for (const fragment &f : fragments) {
+        if (!f.jump) {
+            if (!f.call.empty()) {
+                code_relocation call = { text.size() + 1, f.call };
+                code->calls.push_back(call);
+            }
+            text.insert(text.end(), f.code.begin(), f.code.end());
+            continue;
+        }
+        long long end = (long long)(f.offset + fragment_size(f));
+        long long disp = (long long)label_offset[f.target] - end;
+        if (!f.is_long) {
+            text.push_back(f.cond < 0 ? 0xeb : 0x70 + f.cond);
+            text.push_back((unsigned char)disp);
+        } else {
+            if (f.cond < 0) {
+                text.push_back(0xe9);
+            } else {
+                text.push_back(0x0f);
+                text.push_back(0x80 + f.cond);
+            }
+            put32(text, disp);
+        }
+    }
+
+    code_symbol symbol = { mf.name, start, text.size() - start };
+    code->functions.push_back(symbol);
+}
@@ -0,0 +1,569 @@
+#include "isel.h"
+#include <stdio.h>
+
+using namespace std;
+
+// ============================================================================
+// INSTRUCTION SELECTION
+// ============================================================================
+// tree-pattern matching, block by block. an instruction used once, later in
+// its own block with no store or call in between, is folded into the tree
+// of its user; the rest are roots, each covered with the cheapest patterns
+// of the grammar in isel.burs by the generated burs_label/burs_reduce:
+//
+//   %t = shl i32 %i, 2
+//   %s = add i32 %p, %t          leal (p,i,4) -> s
+//   %c = icmp slt i32 %s, %n
+//   br i1 %c, %then, %else       cmpl n, s;  jl then;  jmp else
+//
+// i1 values are 0 or 1 in a 32-bit register, i64 values (from
+// --div-by-const) use the 64-bit forms. allocas get a frame slot and their
+// loads and stores become moves from and to it (or memory operands, when a
+// load is folded); miniC never takes an address, so there is nothing else a
+// pointer can be. calls and phis are lowered here by hand.
+//
+// a phi gets its own virtual register, written by copies at the end of each
+// predecessor. a conditional branch can't hold copies for just one of its
+// edges, so an edge from one into a block with phis goes through a new
+// block (placed right after) with the copies and a jmp
+//
+// %eax, %ecx and %edx are never allocated: division, shifts by a register,
+// return values and the allocator's spill code use them without asking
+
+static const machine_register argument_registers[] = {
+    REG_RDI, REG_RSI, REG_RDX, REG_RCX, REG_R8, REG_R9,
+};
+static const unsigned MAX_REGISTER_ARGUMENTS = 6;
+
+machine_operand vreg_operand(int vreg) {
+    machine_operand op = { OPND_VREG, vreg };
+    return op;
+}
+
+machine_operand reg_operand(machine_register reg) {
+    machine_operand op = { OPND_REG, reg };
+    return op;
+}
+
+machine_operand imm_operand(long long value) {
+    machine_operand op = { OPND_IMM, value };
+    return op;
+}
+
+machine_operand slot_operand(int slot) {
+    machine_operand op = { OPND_SLOT, slot };
+    return op;
+}
+
+machine_operand no_operand() {
+    machine_operand op = { OPND_NONE, 0 };
+    return op;
+}
+
+int new_vreg(isel_state &st, int width) {
+    st.mf->vreg_width.push_back(width);
+    st.mf->keep_across_calls.push_back(false);
+    return st.mf->vreg_count++;
+}
+
+void emit(isel_state &st, machine_opcode op, int width, machine_operand dst,
+          machine_operand src, int cond, int target) {
+    machine_instr mi;
+    mi.op = op;
+    mi.width = width;
+    mi.dst = dst;
+    mi.src = src;
+    mi.index = no_operand();
+    mi.scale = 1;
+    mi.disp = 0;
+    mi.cond = cond;
+    mi.target = target;
+    st.out->push_back(mi);
+}
+
+void emit_lea(isel_state &st, int width, machine_operand dst, machine_operand base,
+              machine_operand index, int scale, long long disp) {
+    emit(st, MI_LEA, width, dst, base);
+    st.out->back().index = index;
+    st.out->back().scale = scale;
+    st.out->back().disp = disp;
+}
+
+static void unsupported(isel_state &st, LLVMValueRef value, const char *what) {
+    char *text = LLVMPrintValueToString(value);
+    fprintf(stderr, "error: backend can't lower%s:%s\n", what, text);
+    LLVMDisposeMessage(text);
+    st.ok = false;
+}
+
+// registers are 32 bits for i1 and i32, 64 for i64
+static int value_width(LLVMValueRef value) {
+    LLVMTypeRef type = LLVMTypeOf(value);
+    if (LLVMGetTypeKind(type) == LLVMIntegerTypeKind && LLVMGetIntTypeWidth(type) > 32) {
+        return 64;
+    }
+    return 32;
+}
+
+// a value as an operand: an immediate when it fits in 32 bits (i1 true is
+// 1, not -1), a register otherwise
+static machine_operand operand_of(isel_state &st, LLVMValueRef value) {
+    if (LLVMIsAConstantInt(value)) {
+        LLVMTypeRef type = LLVMTypeOf(value);
+        long long c = LLVMGetIntTypeWidth(type) == 1 ? (long long)LLVMConstIntGetZExtValue(value)
+                                                    : LLVMConstIntGetSExtValue(value);
+        if (c == (long long)(int)c) {
+            return imm_operand(c);
+        }
+        int vreg = new_vreg(st, 64);
+        emit(st, MI_MOVABS, 64, vreg_operand(vreg), imm_operand(c));
+        return vreg_operand(vreg);
+    }
+    if (LLVMIsUndef(value)) {
+        return imm_operand(0);
+    }
+    auto it = st.vregs.find(value);
+    if (it == st.vregs.end()) {
+        unsupported(st, value, " operand");
+        return imm_operand(0);
+    }
+    return vreg_operand(it->second);
+}
+
+// ============================================================================
+// PHI COPIES
+// ============================================================================
+
+// the copies for succ's phis along the edge from pred. the phis take their
+// values all at once, so when one of them reads another phi of succ (a loop
+// that swaps two variables), every value goes through a temporary first
+static void edge_copies(isel_state &st, LLVMBasicBlockRef pred, LLVMBasicBlockRef succ) {
+    vector<pair<LLVMValueRef, LLVMValueRef>> copies;   // phi, incoming value
+    unordered_set<LLVMValueRef> phis;
+    for (LLVMValueRef phi = LLVMGetFirstInstruction(succ);
+         phi != NULL && LLVMGetInstructionOpcode(phi) == LLVMPHI;
+         phi = LLVMGetNextInstruction(phi)) {
+        phis.insert(phi);
+        for (unsigned i = 0; i < LLVMCountIncoming(phi); i++) {
+            if (LLVMGetIncomingBlock(phi, i) == pred) {
+                copies.push_back(make_pair(phi, LLVMGetIncomingValue(phi, i)));
+                break;
+            }
+        }
+    }
+
+    bool overlap = false;
+    for (auto &copy : copies) {
+        if (phis.count(copy.second)) {
+            overlap = true;
+        }
+    }
+
+    vector<machine_operand> sources;
+    for (auto &copy : copies) {
+        machine_operand src = operand_of(st, copy.second);
+        if (overlap) {
+            int temp = new_vreg(st, value_width(copy.first));
+            emit(st, MI_MOV, value_width(copy.first), vreg_operand(temp), src);
+            src = vreg_operand(temp);
+        }
+        sources.push_back(src);
+    }
+    for (size_t i = 0; i < copies.size(); i++) {
+        emit(st, MI_MOV, value_width(copies[i].first),
+             vreg_operand(st.vregs[copies[i].first]), sources[i]);
+    }
+}
+
+static bool has_phis(LLVMBasicBlockRef bb) {
+    LLVMValueRef first = LLVMGetFirstInstruction(bb);
+    return first != NULL && LLVMGetInstructionOpcode(first) == LLVMPHI;
+}
+
+// the label a conditional branch from pred uses for its edge to succ:
+// succ's own, or that of a new block with the phi copies
+static int edge_target(isel_state &st, LLVMBasicBlockRef pred, LLVMBasicBlockRef succ,
+                       vector<machine_block> &splits) {
+    if (!has_phis(succ)) {
+        return st.labels[succ];
+    }
+    machine_block split;
+    split.label = st.next_label++;
+    vector<machine_instr> *saved = st.out;
+    st.out = &split.instrs;
+    edge_copies(st, pred, succ);
+    emit(st, MI_JMP, 0, no_operand(), no_operand(), 0, st.labels[succ]);
+    st.out = saved;
+    splits.push_back(split);
+    return split.label;
+}
+
+// ============================================================================
+// TREES
+// ============================================================================
+
+// a condition known at compile time (an undef one is false): true and its
+// value in *taken
+static bool constant_condition(LLVMValueRef cond, bool *taken) {
+    if (LLVMIsAConstantInt(cond)) {
+        *taken = LLVMConstIntGetZExtValue(cond) != 0;
+        return true;
+    }
+    if (LLVMIsUndef(cond)) {
+        *taken = false;
+        return true;
+    }
+    return false;
+}
+
+static int condition_of(LLVMIntPredicate predicate) {
+    switch (predicate) {
+    case LLVMIntEQ:  return CC_E;
+    case LLVMIntNE:  return CC_NE;
+    case LLVMIntSLT: return CC_L;
+    case LLVMIntSLE: return CC_LE;
+    case LLVMIntSGT: return CC_G;
+    case LLVMIntSGE: return CC_GE;
+    case LLVMIntULT: return CC_B;
+    case LLVMIntULE: return CC_BE;
+    case LLVMIntUGT: return CC_A;
+    default:         return CC_AE;
+    }
+}
+
+// the tree operator of an instruction with a value, false for the ones
+// lowered by hand
+static bool tree_op(LLVMOpcode opcode, burs_op *op) {
+    switch (opcode) {
+    case LLVMAdd:    *op = OP_ADD;    return true;
+    case LLVMSub:    *op = OP_SUB;    return true;
+    case LLVMMul:    *op = OP_MUL;    return true;
+    case LLVMAnd:    *op = OP_AND;    return true;
+    case LLVMOr:     *op = OP_OR;     return true;
+    case LLVMXor:    *op = OP_XOR;    return true;
+    case LLVMShl:    *op = OP_SHL;    return true;
+    case LLVMAShr:   *op = OP_SAR;    return true;
+    case LLVMLShr:   *op = OP_SHR;    return true;
+    case LLVMSDiv:   *op = OP_SDIV;   return true;
+    case LLVMSRem:   *op = OP_SREM;   return true;
+    case LLVMICmp:   *op = OP_ICMP;   return true;
+    case LLVMSelect: *op = OP_SELECT; return true;
+    case LLVMZExt:   *op = OP_ZEXT;   return true;
+    case LLVMSExt:   *op = OP_SEXT;   return true;
+    case LLVMTrunc:  *op = OP_TRUNC;  return true;
+    case LLVMLoad:   *op = OP_LOAD;   return true;
+    default:         return false;
+    }
+}
+
+// instructions whose operands can be trees: the tree operators, stores,
+// returns and conditional branches
+static bool tree_user(LLVMValueRef inst) {
+    burs_op op;
+    switch (LLVMGetInstructionOpcode(inst)) {
+    case LLVMStore:
+    case LLVMRet:
+    case LLVMBr:
+        return true;
+    default:
+        return tree_op(LLVMGetInstructionOpcode(inst), &op);
+    }
+}
+
+// the instructions of bb that go into their user's tree: used once, by a
+// later tree user in bb, with no store or call in between that could
+// change what a load reads or be overtaken by a division that traps
+static void fold_block(isel_state &st, LLVMBasicBlockRef bb) {
+    st.folded.clear();
+    unordered_map<LLVMValueRef, int> position;
+    int barrier = -1;                        // the last store or call so far
+    int index = 0;
+    for (LLVMValueRef inst = LLVMGetFirstInstruction(bb); inst != NULL;
+         inst = LLVMGetNextInstruction(inst), index++) {
+        position[inst] = index;
+        if (tree_user(inst)) {
+            for (int i = 0; i < LLVMGetNumOperands(inst); i++) {
+                LLVMValueRef operand = LLVMGetOperand(inst, i);
+                auto defined = position.find(operand);
+                burs_op op;
+                if (defined == position.end() || defined->second <= barrier ||
+                    !tree_op(LLVMGetInstructionOpcode(operand), &op)) {
+                    continue;
+                }
+                LLVMUseRef use = LLVMGetFirstUse(operand);
+                if (use != NULL && LLVMGetNextUse(use) == NULL) {
+                    st.folded.insert(operand);
+                }
+            }
+        }
+        LLVMOpcode opcode = LLVMGetInstructionOpcode(inst);
+        if (opcode == LLVMStore || opcode == LLVMCall) {
+            barrier = index;
+        }
+    }
+}
+
+static burs_node *new_node(isel_state &st, burs_op op, LLVMValueRef value) {
+    st.nodes.push_back(burs_node());
+    burs_node *node = &st.nodes.back();
+    node->op = op;
+    node->value = value;
+    node->vreg = -1;
+    node->width = 32;
+    node->bits = 32;
+    if (value != NULL && LLVMGetTypeKind(LLVMTypeOf(value)) == LLVMIntegerTypeKind) {
+        node->width = value_width(value);
+        node->bits = LLVMGetIntTypeWidth(LLVMTypeOf(value));
+    }
+    return node;
+}
+
+static burs_node *instruction_tree(isel_state &st, LLVMValueRef inst);
+
+// an operand: a constant (i1 true is 1, not -1), a folded instruction's
+// tree, or the register of a value computed elsewhere
+static burs_node *operand_tree(isel_state &st, LLVMValueRef value) {
+    if (LLVMIsAConstantInt(value)) {
+        burs_node *node = new_node(st, OP_CONST, value);
+        node->constant = node->bits == 1 ? (long long)LLVMConstIntGetZExtValue(value)
+                                         : LLVMConstIntGetSExtValue(value);
+        return node;
+    }
+    if (LLVMIsUndef(value)) {
+        return new_node(st, OP_CONST, value);
+    }
+    if (st.folded.count(value)) {
+        return instruction_tree(st, value);
+    }
+    burs_node *node = new_node(st, OP_REG, value);
+    auto it = st.vregs.find(value);
+    if (it == st.vregs.end()) {
+        unsupported(st, value, " operand");
+        node->op = OP_CONST;
+        return node;
+    }
+    node->vreg = it->second;
+    return node;
+}
+
+static burs_node *instruction_tree(isel_state &st, LLVMValueRef inst) {
+    burs_op op;
+    tree_op(LLVMGetInstructionOpcode(inst), &op);
+    burs_node *node = new_node(st, op, inst);
+    if (op == OP_LOAD) {
+        auto slot = st.slots.find(LLVMGetOperand(inst, 0));
+        if (slot == st.slots.end()) {
+            unsupported(st, inst, " a load not from an alloca");
+        } else {
+            node->slot = slot->second;
+        }
+        return node;
+    }
+    if (op == OP_ICMP) {
+        node->cond = condition_of(LLVMGetICmpPredicate(inst));
+    }
+    for (int i = 0; i < LLVMGetNumOperands(inst) && i < BURS_MAX_KIDS; i++) {
+        node->kids[i] = operand_tree(st, LLVMGetOperand(inst, i));
+    }
+    return node;
+}
+
+machine_operand destination(isel_state &st, burs_node *node) {
+    return vreg_operand(node->root ? node->vreg : new_vreg(st, node->width));
+}
+
+void burs_no_cover(isel_state &st, burs_node *node, int nonterminal) {
+    if (node->value != NULL) {
+        unsupported(st, node->value, " (no pattern covers it)");
+    } else {
+        fprintf(stderr, "error: backend can't lower a tree (nonterminal %d)\n", nonterminal);
+        st.ok = false;
+    }
+}
+
+// the cheapest cover of a root's tree, emitted; a root with a value leaves
+// it in its own register
+static void select_tree(isel_state &st, burs_node *root, int nonterminal) {
+    burs_label(root);
+    if (root->cost[nonterminal] >= BURS_INFINITY) {
+        burs_no_cover(st, root, nonterminal);
+        return;
+    }
+    burs_value result = burs_reduce(st, root, nonterminal);
+    machine_operand own = vreg_operand(root->vreg);
+    if (nonterminal == NT_reg && (result.op.kind != own.kind || result.op.value != own.value)) {
+        emit(st, MI_MOV, root->width, own, result.op);
+    }
+}
+
+// ============================================================================
+// INSTRUCTIONS
+// ============================================================================
+
+static void select_instruction(isel_state &st, LLVMValueRef inst, vector<machine_block> &splits) {
+    LLVMOpcode opcode = LLVMGetInstructionOpcode(inst);
+    LLVMBasicBlockRef bb = LLVMGetInstructionParent(inst);
+    burs_op op;
+
+    if (tree_op(opcode, &op)) {
+        if (!st.folded.count(inst)) {
+            burs_node *root = instruction_tree(st, inst);
+            root->root = true;
+            root->vreg = st.vregs[inst];
+            select_tree(st, root, NT_reg);
+        }
+        return;
+    }
+
+    switch (opcode) {
+    case LLVMPHI:
+    case LLVMAlloca:
+        break;
+
+    case LLVMStore: {
+        LLVMValueRef value = LLVMGetOperand(inst, 0);
+        auto slot = st.slots.find(LLVMGetOperand(inst, 1));
+        if (slot == st.slots.end()) {
+            unsupported(st, inst, " a store not to an alloca");
+            break;
+        }
+        burs_node *root = new_node(st, OP_STORE, value);
+        root->slot = slot->second;
+        root->kids[0] = operand_tree(st, value);
+        select_tree(st, root, NT_stmt);
+        break;
+    }
+
+    case LLVMCall: {
+        unsigned count = LLVMGetNumArgOperands(inst);
+        if (count > MAX_REGISTER_ARGUMENTS) {
+            unsupported(st, inst, " a call with arguments on the stack");
+            break;
+        }
+        // with several arguments, one may sit in the register another is
+        // moved into, unless they all live in callee-saved registers
+        for (unsigned i = 0; i < count; i++) {
+            LLVMValueRef arg = LLVMGetOperand(inst, i);
+            machine_operand src = operand_of(st, arg);
+            if (count > 1 && src.kind == OPND_VREG) {
+                st.mf->keep_across_calls[src.value] = true;
+            }
+            emit(st, MI_MOV, value_width(arg), reg_operand(argument_registers[i]), src);
+        }
+        size_t length;
+        const char *name = LLVMGetValueName2(LLVMGetCalledValue(inst), &length);
+        emit(st, MI_CALL, 0, no_operand());
+        st.out->back().symbol = string(name, length);
+        if (st.vregs.count(inst)) {
+            emit(st, MI_MOV, value_width(inst), vreg_operand(st.vregs[inst]), reg_operand(REG_RAX));
+        }
+        break;
+    }
+
+    case LLVMRet:
+        if (LLVMGetNumOperands(inst) == 1) {
+            LLVMValueRef value = LLVMGetOperand(inst, 0);
+            burs_node *root = new_node(st, OP_RET, value);
+            root->kids[0] = operand_tree(st, value);
+            select_tree(st, root, NT_stmt);
+        } else {
+            emit(st, MI_RET, 0, no_operand());
+        }
+        break;
+
+    case LLVMBr: {
+        bool taken = true;
+        if (!LLVMIsConditional(inst) || constant_condition(LLVMGetCondition(inst), &taken)) {
+            LLVMBasicBlockRef succ = LLVMGetSuccessor(inst, taken ? 0 : 1);
+            edge_copies(st, bb, succ);
+            emit(st, MI_JMP, 0, no_operand(), no_operand(), 0, st.labels[succ]);
+            break;
+        }
+        burs_node *root = new_node(st, OP_BR, NULL);
+        root->targets[0] = edge_target(st, bb, LLVMGetSuccessor(inst, 0), splits);
+        root->targets[1] = edge_target(st, bb, LLVMGetSuccessor(inst, 1), splits);
+        root->kids[0] = operand_tree(st, LLVMGetCondition(inst));
+        select_tree(st, root, NT_stmt);
+        break;
+    }
+
+    case LLVMUnreachable:
+        emit(st, MI_UD2, 0, no_operand());
+        break;
+
+    default:
+        unsupported(st, inst, "");
+        break;
+    }
+}
+
+bool select_instructions(LLVMValueRef function, machine_function *mf) {
+    size_t length;
+    const char *name = LLVMGetValueName2(function, &length);
+    mf->name = string(name, length);
+    mf->blocks.clear();
+    mf->vreg_count = 0;
+    mf->vreg_width.clear();
+    mf->keep_across_calls.clear();
+    mf->slot_count = 0;
+
+    isel_state st;
+    st.mf = mf;
+    st.next_label = 0;
+    st.ok = true;
+
+    unsigned param_count = LLVMCountParams(function);
+    if (param_count > MAX_REGISTER_ARGUMENTS) {
+        fprintf(stderr, "error: backend can't lower %s: parameters on the stack\n", mf->name.c_str());
+        return false;
+    }
+
+    // every value gets its register up front: phis and uses in blocks laid
+    // out before the definition refer to it before it is lowered
+    for (unsigned i = 0; i < param_count; i++) {
+        int vreg = new_vreg(st, value_width(LLVMGetParam(function, i)));
+        st.vregs[LLVMGetParam(function, i)] = vreg;
+        // several incoming registers are only read one after another
+        mf->keep_across_calls[vreg] = param_count > 1;
+    }
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function); bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+        st.labels[bb] = st.next_label++;
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(bb); inst != NULL;
+             inst = LLVMGetNextInstruction(inst)) {
+            if (LLVMGetInstructionOpcode(inst) == LLVMAlloca) {
+                st.slots[inst] = mf->slot_count++;
+            } else if (LLVMGetTypeKind(LLVMTypeOf(inst)) != LLVMVoidTypeKind) {
+                st.vregs[inst] = new_vreg(st, value_width(inst));
+            }
+        }
+    }
+
+    for (LLVMBasicBlockRef bb = LLVMGetFirstBasicBlock(function); bb != NULL;
+         bb = LLVMGetNextBasicBlock(bb)) {
+        machine_block block;
+        block.label = st.labels[bb];
+        vector<machine_block> splits;
+        st.out = &block.instrs;
+
+        if (bb == LLVMGetEntryBasicBlock(function)) {
+            for (unsigned i = 0; i < param_count; i++) {
+                LLVMValueRef param = LLVMGetParam(function, i);
+                emit(st, MI_MOV, value_width(param), vreg_operand(st.vregs[param]),
+                     reg_operand(argument_registers[i]));
+            }
+        }
+        fold_block(st, bb);
+        st.nodes.clear();
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(bb); inst != NULL;
+             inst = LLVMGetNextInstruction(inst)) {
+            select_instruction(st, inst, splits);
+        }
+
+        mf->blocks.push_back(block);
+        for (auto &split : splits) {
+            mf->blocks.push_back(split);
+        }
+    }
+    return st.ok;
+}
@@ -0,0 +1,76 @@
+#ifndef ISEL_H
+#define ISEL_H
+
+#include "backend.h"
+#include "isel_burs.h"     // generated by burg from isel.burs
+
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+
+// ============================================================================
+// EXPRESSION TREES
+// ============================================================================
+// what isel.cpp and the rules of isel.burs share. within a block, an
+// instruction whose only use is a later instruction of the same block, with
+// no store or call in between, becomes a node of its user's tree instead of
+// getting a register of its own. every other instruction is the root of a
+// tree, and burs_label/burs_reduce (generated from isel.burs) cover each
+// tree with the cheapest set of rule patterns
+
+struct burs_node {
+    burs_op op;
+    LLVMValueRef value;       // the IR instruction or constant, NULL for none
+    burs_node *kids[BURS_MAX_KIDS];
+    int width;                // of the value: 32 (i1, i32) or 64
+    int bits;                 // of the value's IR type: 1, 32 or 64
+    bool root;                // writes the value's own register
+    int vreg;                 // OP_REG, and roots: that register
+    long long constant;       // OP_CONST
+    int slot;                 // OP_LOAD, OP_STORE
+    int cond;                 // OP_ICMP: machine_condition of kids[0] op kids[1]
+    int targets[2];           // OP_BR: labels of the true and false edges
+
+    // filled in by burs_label: per nonterminal, the cheapest cover and
+    // the rule at its top
+    int cost[BURS_NT_COUNT];
+    int rule[BURS_NT_COUNT];
+};
+
+struct isel_state {
+    machine_function *mf;
+    std::unordered_map<LLVMValueRef, int> vregs;     // IR value -> virtual register
+    std::unordered_map<LLVMValueRef, int> slots;     // alloca -> frame slot
+    std::unordered_map<LLVMBasicBlockRef, int> labels;
+    int next_label;
+    std::vector<machine_instr> *out;                 // the block being filled
+    std::unordered_set<LLVMValueRef> folded;         // instructions inside a tree
+    std::deque<burs_node> nodes;                     // the trees of the current block
+    bool ok;
+};
+
+// what a node reduced to: an operand, or for a compare (NT_cc) the cmp
+// still to be emitted, right before the instruction reading the flags
+struct burs_value {
+    machine_operand op;
+    machine_operand lhs, rhs;
+    int width;
+    int cond;
+};
+
+// isel.cpp
+machine_operand no_operand();
+int new_vreg(isel_state &st, int width);
+void emit(isel_state &st, machine_opcode op, int width, machine_operand dst,
+          machine_operand src = no_operand(), int cond = 0, int target = -1);
+void emit_lea(isel_state &st, int width, machine_operand dst, machine_operand base,
+              machine_operand index, int scale, long long disp);
+// where a node's value goes: a root's own register, a new one otherwise
+machine_operand destination(isel_state &st, burs_node *node);
+void burs_no_cover(isel_state &st, burs_node *node, int nonterminal);
+
+// isel_burs.cpp
+void burs_label(burs_node *node);
+burs_value burs_reduce(isel_state &st, burs_node *node, int nonterminal);
+
+#endif
@@ -0,0 +1,263 @@
+#include "backend.h"
+#include <stdio.h>
+
+using namespace std;
+
+// ============================================================================
+// PEEPHOLE
+// ============================================================================
+// after register allocation, the code still shows how it was put together:
+// a tree's result moved into the register it was already given, spill code
+// reloading what was just stored, `setcc; movzbl; test; jne` for a compare
+// whose value is used elsewhere too, and the `jcc; jmp` every branch ends in.
+// each block is rewritten in one pass, every instruction appended to the
+// block's new list and then matched against the tail of that list:
+//
+//   redundant move    mov %r, %r                  -> (nothing)
+//                     mov %a, %b; mov %b, %a      -> mov %a, %b
+//   reload            mov %r, s; ...; mov s, %q   -> mov %r, s; ...; mov %r, %q
+//                     (the slot and %r unchanged in between, and the same
+//                     width; a store of what the slot holds goes too)
+//   lea chain         lea X, %r; lea d(%r), %r    -> lea X+d, %r
+//   fused branch      setcc %r; movzbl %r, %r;    -> setcc %r; movzbl %r, %r;
+//                     test %r, %r; jne L             jcc L
+//   branch over jump  jcc next; jmp L             -> j!cc L
+//   test zero         cmp $0, %r                  -> test %r, %r
+//   short immediate   movq $k, %r (0 <= k < 2^31) -> movl $k, %r
+//                     movabsq $k, %r (k < 2^32)   -> movl $k, %r
+//
+// and a second pass, backwards, turns `mov $0, %r` into `xorl %r, %r` where
+// nothing reads the flags before they are set again. both are linear: a
+// match only looks at the last three instructions, and deletes what it
+// matches or changes the one being appended
+
+long long peephole_hits[PEEPHOLE_PATTERNS];
+
+static const char *pattern_names[PEEPHOLE_PATTERNS] = {
+    "redundant move", "reload", "lea chain", "fused branch",
+    "branch over jump", "test zero", "short immediate", "zero idiom",
+};
+
+static bool same(machine_operand a, machine_operand b) {
+    return a.kind == b.kind && a.value == b.value;
+}
+
+static bool is_reg(machine_operand op) {
+    return op.kind == OPND_REG;
+}
+
+static bool is_imm(machine_operand op, long long value) {
+    return op.kind == OPND_IMM && op.value == value;
+}
+
+static bool writes_dst(machine_opcode op) {
+    switch (op) {
+    case MI_CMP:
+    case MI_TEST:
+    case MI_JCC:
+    case MI_JMP:
+    case MI_CALL:
+    case MI_RET:
+    case MI_UD2:
+        return false;
+    default:
+        return true;
+    }
+}
+
+static bool reads_flags(machine_opcode op) {
+    return op == MI_SETCC || op == MI_CMOV || op == MI_JCC;
+}
+
+// the flags of a variable shift are left alone by a count of 0, and the
+// rest of the instructions keep them (or are the end of the block)
+static bool sets_flags(const machine_instr &mi) {
+    switch (mi.op) {
+    case MI_ADD:
+    case MI_SUB:
+    case MI_IMUL:
+    case MI_AND:
+    case MI_OR:
+    case MI_XOR:
+    case MI_NEG:
+    case MI_CMP:
+    case MI_TEST:
+        return true;
+    case MI_SHL:
+    case MI_SAR:
+    case MI_SHR:
+        return mi.src.kind == OPND_IMM && mi.src.value != 0;
+    default:
+        return false;
+    }
+}
+
+// a register and a frame slot known to hold the same value, at a width
+struct slot_copy {
+    bool valid;
+    machine_operand reg, slot;
+    int width;
+};
+
+// what mi changes of copy: its register or its slot, or everything at a call
+static void clobber(slot_copy &copy, const machine_instr &mi) {
+    if (!copy.valid) {
+        return;
+    }
+    bool hit = mi.op == MI_CALL;
+    if (writes_dst(mi.op) && (same(mi.dst, copy.reg) || same(mi.dst, copy.slot))) {
+        hit = true;
+    }
+    if (mi.op == MI_CDQ || mi.op == MI_IDIV) {
+        hit = hit || copy.reg.value == REG_RDX || (mi.op == MI_IDIV && copy.reg.value == REG_RAX);
+    }
+    if (hit) {
+        copy.valid = false;
+    }
+}
+
+// mi on its own: smaller forms of the same instruction
+static void shorten(machine_instr &mi) {
+    if (mi.op == MI_CMP && is_reg(mi.dst) && is_imm(mi.src, 0)) {
+        mi.op = MI_TEST;
+        mi.src = mi.dst;
+        peephole_hits[PEEP_TEST_ZERO]++;
+    } else if (mi.op == MI_MOV && mi.width == 64 && is_reg(mi.dst) && mi.src.kind == OPND_IMM &&
+               mi.src.value >= 0) {
+        mi.width = 32;
+        peephole_hits[PEEP_SHORT_IMMEDIATE]++;
+    } else if (mi.op == MI_MOVABS && mi.src.value >= 0 && mi.src.value <= 0xffffffffLL) {
+        mi.op = MI_MOV;
+        mi.width = 32;
+        mi.src.value = (int)mi.src.value;
+        peephole_hits[PEEP_SHORT_IMMEDIATE]++;
+    }
+}
+
+// append mi to out, unless the tail of out makes it unnecessary. false
+// when it was dropped
+static bool append(vector<machine_instr> &out, machine_instr mi, slot_copy &copy, int next_label) {
+    shorten(mi);
+
+    if (mi.op == MI_MOV && copy.valid && mi.width == copy.width) {
+        if (is_reg(mi.dst) && same(mi.src, copy.slot)) {
+            mi.src = copy.reg;
+            peephole_hits[PEEP_RELOAD]++;
+            if (same(mi.dst, copy.reg)) {
+                return false;
+            }
+        } else if (same(mi.dst, copy.slot) && same(mi.src, copy.reg)) {
+            peephole_hits[PEEP_RELOAD]++;
+            return false;
+        }
+    }
+
+    size_t n = out.size();
+    machine_instr *last = n > 0 ? &out[n - 1] : NULL;
+
+    if (mi.op == MI_MOV && is_reg(mi.dst) && same(mi.dst, mi.src)) {
+        peephole_hits[PEEP_REDUNDANT_MOVE]++;
+        return false;
+    }
+    if (mi.op == MI_MOV && last != NULL && last->op == MI_MOV && last->width == mi.width &&
+        is_reg(mi.dst) && is_reg(mi.src) && same(last->dst, mi.src) && same(last->src, mi.dst)) {
+        peephole_hits[PEEP_REDUNDANT_MOVE]++;
+        return false;
+    }
+
+    if (mi.op == MI_LEA && last != NULL && last->op == MI_LEA && last->width == mi.width &&
+        is_reg(mi.dst) && same(last->dst, mi.dst) && same(mi.src, mi.dst) &&
+        mi.index.kind == OPND_NONE) {
+        long long disp = last->disp + mi.disp;
+        if (disp == (int)disp) {
+            last->disp = disp;
+            peephole_hits[PEEP_LEA_CHAIN]++;
+            return false;
+        }
+    }
+
+    if (mi.op == MI_JCC && (mi.cond == CC_NE || mi.cond == CC_E) && n >= 3) {
+        machine_instr &test = out[n - 1], &zero_extend = out[n - 2], &setcc = out[n - 3];
+        if (test.op == MI_TEST && is_reg(test.dst) && same(test.dst, test.src) &&
+            zero_extend.op == MI_MOVZB && same(zero_extend.dst, test.dst) &&
+            same(zero_extend.src, test.dst) &&
+            setcc.op == MI_SETCC && same(setcc.dst, test.dst)) {
+            mi.cond = mi.cond == CC_NE ? setcc.cond : setcc.cond ^ 1;
+            out.pop_back();
+            peephole_hits[PEEP_FUSED_BRANCH]++;
+        }
+    }
+
+    // the condition codes come in pairs, the inverse in the low bit
+    if (mi.op == MI_JMP && last != NULL && last->op == MI_JCC) {
+        if (last->target == next_label) {
+            last->cond ^= 1;
+            last->target = mi.target;
+            peephole_hits[PEEP_BRANCH_OVER_JUMP]++;
+            return false;
+        }
+        if (last->target == mi.target) {
+            out.pop_back();
+            peephole_hits[PEEP_BRANCH_OVER_JUMP]++;
+        }
+    }
+
+    out.push_back(mi);
+    return true;
+}
+
+static void rewrite_block(machine_block &block, int next_label) {
+    vector<machine_instr> out;
+    out.reserve(block.instrs.size());
+    slot_copy copy = { false, { OPND_NONE, 0 }, { OPND_NONE, 0 }, 0 };
+    for (const machine_instr &mi : block.instrs) {
+        if (!append(out, mi, copy, next_label)) {
+            continue;
+        }
+        const machine_instr &added = out.back();
+        clobber(copy, added);
+        if (added.op == MI_MOV && is_reg(added.dst) && added.src.kind == OPND_SLOT) {
+            copy = { true, added.dst, added.src, added.width };
+        } else if (added.op == MI_MOV && added.dst.kind == OPND_SLOT && is_reg(added.src)) {
+            copy = { true, added.src, added.dst, added.width };
+        }
+    }
+    block.instrs.swap(out);
+}
+
+// backwards, so the flags are known to be dead after each instruction:
+// nothing reads them before the next instruction that sets them, and no
+// block expects them from the one before
+static void zero_idioms(machine_block &block) {
+    bool flags_live = false;
+    for (size_t i = block.instrs.size(); i-- > 0;) {
+        machine_instr &mi = block.instrs[i];
+        if (mi.op == MI_MOV && is_reg(mi.dst) && is_imm(mi.src, 0) && !flags_live) {
+            mi.op = MI_XOR;
+            mi.width = 32;          // clears the upper half too
+            mi.src = mi.dst;
+            peephole_hits[PEEP_ZERO_IDIOM]++;
+        }
+        if (sets_flags(mi)) {
+            flags_live = false;
+        }
+        if (reads_flags(mi.op)) {
+            flags_live = true;
+        }
+    }
+}
+
+void peephole(machine_function *mf) {
+    for (size_t b = 0; b < mf->blocks.size(); b++) {
+        int next_label = b + 1 < mf->blocks.size() ? mf->blocks[b + 1].label : -1;
+        rewrite_block(mf->blocks[b], next_label);
+        zero_idioms(mf->blocks[b]);
+    }
+}
+
+void print_peephole_stats(FILE *out) {
+    fprintf(out, "peephole hits:\n");
+    for (int p = 0; p < PEEPHOLE_PATTERNS; p++) {
+        fprintf(out, "  %-18s %lld\n", pattern_names[p], peephole_hits[p]);
+    }
+}
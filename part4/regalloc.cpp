@@ -0,0 +1,534 @@
+#include "backend.h"
+
+#include <limits.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+using namespace std;
+
+// ============================================================================
+// REGISTER ALLOCATION
+// ============================================================================
+// linear scan (Poletto and Sarkar, "Linear Scan Register Allocation"):
+//
+//   1. liveness of the virtual registers per block, iterated to a fixed
+//      point over the machine CFG (bitsets, one bit per register)
+//   2. the instructions numbered in layout order, and every virtual
+//      register gets one interval [first position, last position] that
+//      covers all its definitions and uses and every block it is live
+//      through (no holes, so a loop variable holds its register for the
+//      whole loop)
+//   3. the intervals in order of their start: the ones that ended free
+//      their register, the new one takes a free register. with none free,
+//      whichever of it and the active intervals ends last goes to a frame
+//      slot and the other gets the register
+//
+//   4. the frame slots (allocas and spilled registers) get liveness of
+//      their own, and slots that are never live at the same time share
+//      one: an alloca of a variable declared inside a loop body, next to
+//      the ones of other blocks
+//
+// intervals that are live across a call only get callee-saved registers,
+// the others try the caller-saved ones first so short functions don't need
+// to save anything. spilled registers become frame slot operands, and the
+// few instructions that can't take two memory operands (or a memory
+// destination) load or store through %rax (and %rdx for an lea index)
+
+static const machine_register caller_saved[] = {
+    REG_RSI, REG_RDI, REG_R8, REG_R9, REG_R10, REG_R11,
+};
+static const machine_register callee_saved[] = {
+    REG_RBX, REG_R12, REG_R13, REG_R14, REG_R15,
+};
+
+static bool writes_dst(machine_opcode op) {
+    return op != MI_CMP && op != MI_TEST;
+}
+
+static bool reads_dst(machine_opcode op) {
+    switch (op) {
+    case MI_MOV:
+    case MI_MOVABS:
+    case MI_MOVSX:
+    case MI_MOVZB:
+    case MI_MOVZL:
+    case MI_LEA:
+    case MI_SETCC:
+        return false;
+    default:
+        return true;
+    }
+}
+
+// instructions whose destination has to be a register
+static bool needs_register_dst(machine_opcode op) {
+    switch (op) {
+    case MI_MOVABS:
+    case MI_MOVSX:
+    case MI_MOVZB:
+    case MI_LEA:
+    case MI_IMUL:
+    case MI_CMOV:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// ============================================================================
+// LIVENESS
+// ============================================================================
+
+typedef vector<unsigned long long> bitset_t;
+
+static bool test_bit(const bitset_t &set, int bit) {
+    return (set[bit >> 6] >> (bit & 63)) & 1;
+}
+
+static void set_bit(bitset_t &set, int bit) {
+    set[bit >> 6] |= 1ULL << (bit & 63);
+}
+
+static void clear_bit(bitset_t &set, int bit) {
+    set[bit >> 6] &= ~(1ULL << (bit & 63));
+}
+
+// f(bit) for every bit that is set, a word at a time
+template <typename F>
+static void for_each_bit(const bitset_t &set, F f) {
+    for (size_t w = 0; w < set.size(); w++) {
+        for (unsigned long long bits = set[w]; bits != 0; bits &= bits - 1) {
+            f((int)(w * 64 + __builtin_ctzll(bits)));
+        }
+    }
+}
+
+// the layout positions of the blocks each block can jump to
+static vector<vector<int>> successors(const machine_function &mf) {
+    unordered_map<int, int> position;
+    for (size_t b = 0; b < mf.blocks.size(); b++) {
+        position[mf.blocks[b].label] = b;
+    }
+    vector<vector<int>> succs(mf.blocks.size());
+    for (size_t b = 0; b < mf.blocks.size(); b++) {
+        const vector<machine_instr> &instrs = mf.blocks[b].instrs;
+        for (const machine_instr &mi : instrs) {
+            if (mi.op == MI_JCC || mi.op == MI_JMP) {
+                succs[b].push_back(position[mi.target]);
+            }
+        }
+        bool falls_through = instrs.empty() || (instrs.back().op != MI_JMP &&
+                                                 instrs.back().op != MI_RET &&
+                                                 instrs.back().op != MI_UD2);
+        if (falls_through && b + 1 < mf.blocks.size()) {
+            succs[b].push_back(b + 1);
+        }
+    }
+    return succs;
+}
+
+// live_in = use | (live_out - def), live_out the union of the successors'
+// live_in, to a fixed point
+static void solve_liveness(const machine_function &mf, size_t words, const vector<bitset_t> &use,
+                           const vector<bitset_t> &def, vector<bitset_t> *live_in,
+                           vector<bitset_t> *live_out) {
+    size_t count = mf.blocks.size();
+    vector<vector<int>> succs = successors(mf);
+    live_in->assign(count, bitset_t(words));
+    live_out->assign(count, bitset_t(words));
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t b = count; b-- > 0;) {
+            bitset_t &out = (*live_out)[b];
+            for (int s : succs[b]) {
+                for (size_t w = 0; w < words; w++) {
+                    out[w] |= (*live_in)[s][w];
+                }
+            }
+            for (size_t w = 0; w < words; w++) {
+                unsigned long long in = use[b][w] | (out[w] & ~def[b][w]);
+                if (in != (*live_in)[b][w]) {
+                    (*live_in)[b][w] = in;
+                    changed = true;
+                }
+            }
+        }
+    }
+}
+
+static void live_out_sets(const machine_function &mf, vector<bitset_t> *live_in,
+                          vector<bitset_t> *live_out) {
+    size_t words = (mf.vreg_count + 63) / 64;
+    size_t count = mf.blocks.size();
+    vector<bitset_t> use(count, bitset_t(words)), def(count, bitset_t(words));
+    for (size_t b = 0; b < count; b++) {
+        for (const machine_instr &mi : mf.blocks[b].instrs) {
+            if (mi.src.kind == OPND_VREG && !test_bit(def[b], mi.src.value)) {
+                set_bit(use[b], mi.src.value);
+            }
+            if (mi.index.kind == OPND_VREG && !test_bit(def[b], mi.index.value)) {
+                set_bit(use[b], mi.index.value);
+            }
+            if (mi.dst.kind == OPND_VREG) {
+                if (reads_dst(mi.op) && !test_bit(def[b], mi.dst.value)) {
+                    set_bit(use[b], mi.dst.value);
+                }
+                if (writes_dst(mi.op)) {
+                    set_bit(def[b], mi.dst.value);
+                }
+            }
+        }
+    }
+
+    solve_liveness(mf, words, use, def, live_in, live_out);
+}
+
+// ============================================================================
+// LINEAR SCAN
+// ============================================================================
+
+struct live_interval {
+    int vreg;
+    int start, end;
+    bool across_calls;
+    int reg;          // -1 while it has none
+};
+
+static void extend(live_interval &interval, int position) {
+    interval.start = min(interval.start, position);
+    interval.end = max(interval.end, position);
+}
+
+static vector<live_interval> build_intervals(const machine_function &mf) {
+    vector<bitset_t> live_in, live_out;
+    live_out_sets(mf, &live_in, &live_out);
+
+    vector<live_interval> intervals(mf.vreg_count);
+    for (int v = 0; v < mf.vreg_count; v++) {
+        intervals[v].vreg = v;
+        intervals[v].start = INT_MAX;
+        intervals[v].end = -1;
+        intervals[v].across_calls = mf.keep_across_calls[v];
+        intervals[v].reg = -1;
+    }
+
+    vector<int> calls;
+    int position = 0;
+    for (size_t b = 0; b < mf.blocks.size(); b++) {
+        int block_start = position;
+        for (const machine_instr &mi : mf.blocks[b].instrs) {
+            if (mi.src.kind == OPND_VREG) {
+                extend(intervals[mi.src.value], position);
+            }
+            if (mi.index.kind == OPND_VREG) {
+                extend(intervals[mi.index.value], position);
+            }
+            if (mi.dst.kind == OPND_VREG) {
+                extend(intervals[mi.dst.value], position);
+            }
+            if (mi.op == MI_CALL) {
+                calls.push_back(position);
+            }
+            position += 2;
+        }
+        int block_end = position - 1;
+        for_each_bit(live_in[b], [&](int v) { extend(intervals[v], block_start); });
+        for_each_bit(live_out[b], [&](int v) { extend(intervals[v], block_end); });
+    }
+
+    // live across a call: the call lies strictly inside the interval
+    for (live_interval &interval : intervals) {
+        auto call = upper_bound(calls.begin(), calls.end(), interval.start);
+        if (call != calls.end() && *call < interval.end) {
+            interval.across_calls = true;
+        }
+    }
+    return intervals;
+}
+
+static bool allowed(const live_interval &interval, int reg) {
+    if (!interval.across_calls) {
+        return true;
+    }
+    for (machine_register r : callee_saved) {
+        if (r == reg) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void linear_scan(machine_function *mf, vector<live_interval> &intervals,
+                        vector<machine_operand> *location) {
+    vector<live_interval*> order;
+    for (live_interval &interval : intervals) {
+        if (interval.end >= 0) {
+            order.push_back(&interval);
+        }
+    }
+    sort(order.begin(), order.end(), [](live_interval *a, live_interval *b) {
+        return a->start < b->start;
+    });
+
+    vector<machine_register> preference;
+    for (machine_register r : caller_saved) {
+        preference.push_back(r);
+    }
+    for (machine_register r : callee_saved) {
+        preference.push_back(r);
+    }
+
+    location->assign(mf->vreg_count, slot_operand(0));
+    vector<live_interval*> active;                   // by increasing end
+    bool in_use[16] = { false };
+
+    for (live_interval *current : order) {
+        // an interval whose last use is where this one is defined can hand
+        // over its register: every instruction reads before it writes
+        size_t expired = 0;
+        while (expired < active.size() && active[expired]->end <= current->start) {
+            in_use[active[expired]->reg] = false;
+            expired++;
+        }
+        active.erase(active.begin(), active.begin() + expired);
+
+        for (machine_register r : preference) {
+            if (!in_use[r] && allowed(*current, r)) {
+                current->reg = r;
+                break;
+            }
+        }
+
+        if (current->reg < 0) {
+            live_interval *victim = NULL;
+            for (live_interval *other : active) {
+                if (allowed(*current, other->reg) && (victim == NULL || other->end > victim->end)) {
+                    victim = other;
+                }
+            }
+            if (victim == NULL || victim->end <= current->end) {
+                (*location)[current->vreg] = slot_operand(mf->slot_count++);
+                continue;
+            }
+            current->reg = victim->reg;
+            victim->reg = -1;
+            (*location)[victim->vreg] = slot_operand(mf->slot_count++);
+            active.erase(find(active.begin(), active.end(), victim));
+        }
+
+        in_use[current->reg] = true;
+        (*location)[current->vreg] = reg_operand((machine_register)current->reg);
+        auto at = active.begin();
+        while (at != active.end() && (*at)->end <= current->end) {
+            at++;
+        }
+        active.insert(at, current);
+    }
+}
+
+// ============================================================================
+// REWRITING
+// ============================================================================
+
+static machine_instr move(int width, machine_operand dst, machine_operand src) {
+    machine_instr mi;
+    mi.op = MI_MOV;
+    mi.width = width;
+    mi.dst = dst;
+    mi.src = src;
+    mi.index = { OPND_NONE, 0 };
+    mi.scale = 1;
+    mi.disp = 0;
+    mi.cond = 0;
+    mi.target = -1;
+    return mi;
+}
+
+// the virtual registers replaced by their locations, through %rax where
+// x86 needs a register
+static void rewrite(machine_function *mf, const vector<machine_operand> &location) {
+    machine_operand scratch = reg_operand(REG_RAX);
+    for (machine_block &block : mf->blocks) {
+        vector<machine_instr> instrs;
+        instrs.reserve(block.instrs.size());
+        for (machine_instr mi : block.instrs) {
+            // a 32-bit write of a 64-bit register (zext to i64) has to clear
+            // the upper half of its slot too
+            bool narrow = mi.dst.kind == OPND_VREG && mi.width == 32 &&
+                          mf->vreg_width[mi.dst.value] == 64;
+            if (narrow && mi.op == MI_MOV) {
+                mi.op = MI_MOVZL;
+            }
+            if (mi.dst.kind == OPND_VREG) {
+                mi.dst = location[mi.dst.value];
+            }
+            if (mi.src.kind == OPND_VREG) {
+                mi.src = location[mi.src.value];
+            }
+            if (mi.index.kind == OPND_VREG) {
+                mi.index = location[mi.index.value];
+            }
+
+            // lea only adds registers: a spilled base goes through %rax,
+            // a spilled index through %rdx (loaded at the width it was
+            // stored with, or the load waits for the store to retire)
+            if (mi.op == MI_LEA && mi.src.kind == OPND_SLOT) {
+                instrs.push_back(move(mi.width, scratch, mi.src));
+                mi.src = scratch;
+            }
+            if (mi.op == MI_LEA && mi.index.kind == OPND_SLOT) {
+                instrs.push_back(move(mi.width, reg_operand(REG_RDX), mi.index));
+                mi.index = reg_operand(REG_RDX);
+            }
+
+            if (mi.dst.kind == OPND_SLOT && (needs_register_dst(mi.op) || narrow)) {
+                machine_operand slot = mi.dst;
+                if (reads_dst(mi.op)) {
+                    instrs.push_back(move(mi.width, scratch, slot));
+                }
+                mi.dst = scratch;
+                instrs.push_back(mi);
+                int width = narrow || mi.op == MI_MOVSX || mi.op == MI_MOVABS ? 64 : mi.width;
+                instrs.push_back(move(width, slot, scratch));
+                continue;
+            }
+            if (mi.dst.kind == OPND_SLOT && mi.src.kind == OPND_SLOT) {
+                instrs.push_back(move(mi.width, scratch, mi.src));
+                mi.src = scratch;
+            }
+            instrs.push_back(mi);
+        }
+        block.instrs.swap(instrs);
+    }
+}
+
+// ============================================================================
+// STACK SLOTS
+// ============================================================================
+// once every operand is a register or a slot, the slots get liveness like
+// the virtual registers had: a slot is live where a later instruction may
+// read it before anything writes it. a slot written where another one is
+// live interferes with it, and in slot order each one takes the lowest
+// color none of its neighbours has. the colors are the new slots; a slot
+// nothing reads or writes (the alloca of a variable that is never used)
+// gets none
+
+// the slot mi writes and the ones it reads, -1 for none
+static int slot_written(const machine_instr &mi) {
+    return mi.dst.kind == OPND_SLOT && writes_dst(mi.op) ? mi.dst.value : -1;
+}
+
+static void slots_read(const machine_instr &mi, int read[2]) {
+    read[0] = mi.src.kind == OPND_SLOT ? mi.src.value : -1;
+    read[1] = mi.dst.kind == OPND_SLOT && reads_dst(mi.op) ? mi.dst.value : -1;
+}
+
+static void share_slots(machine_function *mf) {
+    int count = mf->slot_count;
+    size_t words = (count + 63) / 64;
+    size_t blocks = mf->blocks.size();
+    vector<bitset_t> use(blocks, bitset_t(words)), def(blocks, bitset_t(words));
+    bitset_t accessed(words);
+    for (size_t b = 0; b < blocks; b++) {
+        for (const machine_instr &mi : mf->blocks[b].instrs) {
+            int read[2];
+            slots_read(mi, read);
+            for (int slot : read) {
+                if (slot >= 0 && !test_bit(def[b], slot)) {
+                    set_bit(use[b], slot);
+                }
+            }
+            int written = slot_written(mi);
+            if (written >= 0) {
+                set_bit(def[b], written);
+            }
+        }
+        for (size_t w = 0; w < words; w++) {
+            accessed[w] |= use[b][w] | def[b][w];
+        }
+    }
+    vector<bitset_t> live_in, live_out;
+    solve_liveness(*mf, words, use, def, &live_in, &live_out);
+
+    // backwards through each block, the live slots at every write
+    vector<bitset_t> interferes(count, bitset_t(words));
+    for (size_t b = 0; b < blocks; b++) {
+        bitset_t live = live_out[b];
+        const vector<machine_instr> &instrs = mf->blocks[b].instrs;
+        for (size_t i = instrs.size(); i-- > 0;) {
+            int written = slot_written(instrs[i]);
+            if (written >= 0) {
+                for_each_bit(live, [&](int other) {
+                    if (other != written) {
+                        set_bit(interferes[written], other);
+                        set_bit(interferes[other], written);
+                    }
+                });
+                clear_bit(live, written);
+            }
+            int read[2];
+            slots_read(instrs[i], read);
+            for (int slot : read) {
+                if (slot >= 0) {
+                    set_bit(live, slot);
+                }
+            }
+        }
+    }
+
+    vector<int> color(count, -1);
+    int colors = 0;
+    for (int slot = 0; slot < count; slot++) {
+        if (!test_bit(accessed, slot)) {
+            continue;
+        }
+        vector<bool> taken(colors + 1, false);
+        for_each_bit(interferes[slot], [&](int other) {
+            if (color[other] >= 0) {
+                taken[color[other]] = true;
+            }
+        });
+        color[slot] = find(taken.begin(), taken.end(), false) - taken.begin();
+        colors = max(colors, color[slot] + 1);
+    }
+
+    for (machine_block &block : mf->blocks) {
+        for (machine_instr &mi : block.instrs) {
+            if (mi.dst.kind == OPND_SLOT) {
+                mi.dst.value = color[mi.dst.value];
+            }
+            if (mi.src.kind == OPND_SLOT) {
+                mi.src.value = color[mi.src.value];
+            }
+        }
+    }
+    mf->slot_count = colors;
+}
+
+void allocate_registers(machine_function *mf) {
+    vector<live_interval> intervals = build_intervals(*mf);
+    vector<machine_operand> location;
+    linear_scan(mf, intervals, &location);
+    rewrite(mf, location);
+    share_slots(mf);
+
+    bool used[16] = { false };
+    for (const live_interval &interval : intervals) {
+        if (interval.reg >= 0) {
+            used[interval.reg] = true;
+        }
+    }
+    mf->saved_registers.clear();
+    for (machine_register r : callee_saved) {
+        if (used[r]) {
+            mf->saved_registers.push_back(r);
+        }
+    }
+
+    // %rsp is 16-byte aligned at every call: the return address and %rbp
+    // make 16, the saved registers and slots have to as well
+    int bytes = 8 * (mf->saved_registers.size() + mf->slot_count);
+    mf->frame_size = 8 * mf->slot_count + (bytes % 16);
+}